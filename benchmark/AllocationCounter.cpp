@@ -0,0 +1,84 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local uint64_t numberOfAllocations = 0;
+
+void* allocate(std::size_t size) {
+  numberOfAllocations++;
+  if (size == 0) {
+    size = 1;
+  }
+  return std::malloc(size);
+}
+}  // namespace
+
+namespace elmo {
+namespace benchmark {
+
+uint64_t getNumberOfAllocations() {
+  return numberOfAllocations;
+}
+
+}  // namespace benchmark
+}  // namespace elmo
+
+// replacements of the global allocation functions, counting every allocation
+
+void* operator new(std::size_t size) {
+  void* pointer = allocate(size);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void* operator new[](std::size_t size) {
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
@@ -0,0 +1,89 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <soem_interface/EthercatBusBase.hpp>
+
+namespace elmo {
+namespace benchmark {
+
+/*!
+ * @brief	In-memory stand-in for the EtherCAT bus
+ * Provides process images for a number of slaves (addresses 1 to
+ * numberOfSlaves) such that readTxPdo / writeRxPdo of the bus base work
+ * without hardware. No frames are sent, the slaves do not react to commands
+ * unless their TxPdos are set with setTxPdo.
+ */
+class MockEthercatBus : public soem_interface::EthercatBusBase {
+ public:
+  MockEthercatBus(uint16_t numberOfSlaves, uint16_t rxPdoSize, uint16_t txPdoSize)
+      : soem_interface::EthercatBusBase("mock_bus"),
+        rxPdoSize_(rxPdoSize),
+        txPdoSize_(txPdoSize),
+        outputs_(static_cast<std::size_t>(numberOfSlaves) * rxPdoSize, 0),
+        inputs_(static_cast<std::size_t>(numberOfSlaves) * txPdoSize, 0) {
+    ecatSlavecount_ = numberOfSlaves;
+    for (uint16_t slave = 1; slave <= numberOfSlaves; slave++) {
+      ecatSlavelist_[slave].outputs = getOutputs(slave);
+      ecatSlavelist_[slave].Obytes = rxPdoSize_;
+      ecatSlavelist_[slave].inputs = getInputs(slave);
+      ecatSlavelist_[slave].Ibytes = txPdoSize_;
+    }
+  }
+
+  /*!
+   * Set the data the slave sends to the master.
+   */
+  template <typename TxPdo>
+  void setTxPdo(uint16_t slave, const TxPdo& txPdo) {
+    static_assert(std::is_trivially_copyable<TxPdo>::value, "TxPdo must be trivially copyable");
+    std::memcpy(getInputs(slave), &txPdo, sizeof(TxPdo));
+  }
+
+  /*!
+   * Get the data the master sent to the slave.
+   */
+  template <typename RxPdo>
+  void getRxPdo(uint16_t slave, RxPdo& rxPdo) {
+    static_assert(std::is_trivially_copyable<RxPdo>::value, "RxPdo must be trivially copyable");
+    std::memcpy(&rxPdo, getOutputs(slave), sizeof(RxPdo));
+  }
+
+  /*!
+   * The process image of a slave (see Elmo::setProcessImage).
+   */
+  uint8_t* getOutputs(uint16_t slave) { return &outputs_[static_cast<std::size_t>(slave - 1) * rxPdoSize_]; }
+  uint8_t* getInputs(uint16_t slave) { return &inputs_[static_cast<std::size_t>(slave - 1) * txPdoSize_]; }
+
+ protected:
+  uint16_t rxPdoSize_;
+  uint16_t txPdoSize_;
+  std::vector<uint8_t> outputs_;
+  std::vector<uint8_t> inputs_;
+};
+
+}  // namespace benchmark
+}  // namespace elmo
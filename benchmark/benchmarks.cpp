@@ -0,0 +1,250 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Offline benchmarks of the cyclic PDO path of the Elmo class.
+ * The drives are connected to an in-memory bus, no hardware is needed.
+ *
+ * usage: elmo_ethercat_sdk_benchmarks [--check-allocations] [--process-image] [number of cycles]
+ *
+ * With --check-allocations the program fails (non-zero exit code) if any of
+ * the operations allocates heap memory after the warm up.
+ * With --process-image the drives access the process image of the bus
+ * directly (Elmo::setProcessImage).
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "elmo_ethercat_sdk/CycleTiming.hpp"
+#include "elmo_ethercat_sdk/Elmo.hpp"
+#include "elmo_ethercat_sdk/ElmoGroup.hpp"
+#include "elmo_ethercat_sdk/TxPdo.hpp"
+
+#include "AllocationCounter.hpp"
+#include "MockEthercatBus.hpp"
+
+namespace elmo {
+namespace benchmark {
+
+/*!
+ * Accumulated results of one benchmarked operation.
+ */
+struct Operation {
+  explicit Operation(const std::string& name) : name(name) {}
+
+  void reset() {
+    histogram.reset();
+    totalDuration = std::chrono::nanoseconds(0);
+    allocations = 0;
+  }
+
+  std::string name;
+  // duration of the operation for all drives, per cycle
+  CycleHistogram histogram;
+  std::chrono::nanoseconds totalDuration{0};
+  uint64_t allocations{0};
+};
+
+/*!
+ * Measure the duration and the allocations of a function called once per cycle.
+ */
+template <typename Function>
+void measure(Operation& operation, Function&& function) {
+  const uint64_t allocations = getNumberOfAllocations();
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  const auto duration = std::chrono::steady_clock::now() - start;
+  operation.allocations += getNumberOfAllocations() - allocations;
+  operation.totalDuration += duration;
+  operation.histogram.record(duration);
+}
+
+Configuration createConfiguration() {
+  Configuration configuration;
+  configuration.modeOfOperationEnum = ModeOfOperationEnum::CyclicSynchronousTorqueMode;
+  configuration.rxPdoTypeEnum = RxPdoTypeEnum::RxPdoStandard;
+  configuration.txPdoTypeEnum = TxPdoTypeEnum::TxPdoStandard;
+  configuration.positionEncoderResolution = 1 << 17;
+  configuration.gearRatio = 50.0;
+  configuration.motorConstant = 0.1;
+  configuration.motorRatedCurrentA = 5.0;
+  configuration.maxCurrentA = 10.0;
+  configuration.direction = 1;
+  configuration.encoderPosition = Configuration::EncoderPosition::motor;
+  configuration.printDebugMessages = false;
+  return configuration;
+}
+
+void printHeader(std::size_t numberOfDrives, unsigned int numberOfCycles) {
+  std::cout << "\n" << numberOfDrives << " drive(s), " << numberOfCycles << " cycles\n"
+            << std::left << std::setw(20) << "operation" << std::right << std::setw(12) << "ns/op" << std::setw(14)
+            << "allocs/cycle" << std::setw(12) << "p50 [us]" << std::setw(12) << "p99 [us]" << std::setw(12)
+            << "p99.9 [us]" << std::setw(12) << "max [us]"
+            << "\n";
+}
+
+void printOperation(const Operation& operation, std::size_t numberOfDrives, unsigned int numberOfCycles) {
+  const CycleStatistics statistics = operation.histogram.getStatistics();
+  const double nanosecondsPerOperation =
+      static_cast<double>(operation.totalDuration.count()) / (static_cast<double>(numberOfCycles) * numberOfDrives);
+  std::cout << std::left << std::setw(20) << operation.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << nanosecondsPerOperation << std::setw(14) << std::setprecision(2)
+            << static_cast<double>(operation.allocations) / numberOfCycles << std::setprecision(3) << std::setw(12)
+            << statistics.p50.count() / 1000.0 << std::setw(12) << statistics.p99.count() / 1000.0 << std::setw(12)
+            << statistics.p999.count() / 1000.0 << std::setw(12) << statistics.max.count() / 1000.0 << "\n";
+}
+
+/*!
+ * @return	true if no operation allocated heap memory after the warm up
+ */
+bool runBenchmark(uint16_t numberOfDrives, unsigned int numberOfCycles, bool useProcessImage) {
+  MockEthercatBus bus(numberOfDrives, sizeof(RxPdoStandard), sizeof(TxPdoStandard));
+
+  ElmoGroup group;
+  for (uint16_t address = 1; address <= numberOfDrives; address++) {
+    auto elmo = std::make_shared<Elmo>("elmo_" + std::to_string(address), address);
+    elmo->setEthercatBusBasePointer(&bus);
+    elmo->loadConfiguration(createConfiguration());
+    group.addDrive(elmo);
+
+    // drive in OperationEnabled
+    TxPdoStandard txPdo{};
+    txPdo.statusword_ = 0x0027;
+    txPdo.actualPosition_ = 1000 * address;
+    txPdo.actualVelocity_ = -20 * address;
+    txPdo.actualCurrent_ = 100;
+    bus.setTxPdo(address, txPdo);
+
+    if (useProcessImage && !elmo->setProcessImage(bus.getInputs(address), sizeof(TxPdoStandard),
+                                                  bus.getOutputs(address), sizeof(RxPdoStandard))) {
+      std::cerr << "setting the process image of " << elmo->getName() << " failed" << std::endl;
+    }
+  }
+
+  Operation stageCommand("stageCommand");
+  Operation updateWrite("updateWrite");
+  Operation updateRead("updateRead");
+  Operation getReading("getReading");
+  Operation getReadingSnapshot("getReadingSnapshot");
+  Operation groupStageCommands("group stage");
+  Operation groupPublishReadings("group publish");
+  Operation groupGetReadings("group readings");
+
+  Command command;
+  command.setModeOfOperation(ModeOfOperationEnum::CyclicSynchronousTorqueMode);
+  Reading reading;
+  ReadingSnapshot snapshot;
+  GroupCommand groupCommand;
+  groupCommand.resize(numberOfDrives);
+  GroupReading groupReading;
+  groupReading.resize(numberOfDrives);
+
+  // the first cycles are not measured (warm up, lazy initialization)
+  const unsigned int numberOfWarmupCycles = numberOfCycles / 10 + 1;
+  for (unsigned int cycle = 0; cycle < numberOfWarmupCycles + numberOfCycles; cycle++) {
+    if (cycle == numberOfWarmupCycles) {
+      for (Operation* operation : {&stageCommand, &updateWrite, &updateRead, &getReading, &getReadingSnapshot,
+                                   &groupStageCommands, &groupPublishReadings, &groupGetReadings}) {
+        operation->reset();
+      }
+    }
+
+    command.setTargetTorque(0.001 * (cycle % 100));
+    measure(stageCommand, [&]() {
+      for (const auto& elmo : group.getDrives()) {
+        elmo->stageCommand(command);
+      }
+    });
+    measure(updateWrite, [&]() {
+      for (const auto& elmo : group.getDrives()) {
+        elmo->updateWrite();
+      }
+    });
+    measure(updateRead, [&]() {
+      for (const auto& elmo : group.getDrives()) {
+        elmo->updateRead();
+      }
+    });
+    measure(getReading, [&]() {
+      for (const auto& elmo : group.getDrives()) {
+        elmo->getReading(reading);
+      }
+    });
+    measure(getReadingSnapshot, [&]() {
+      for (const auto& elmo : group.getDrives()) {
+        elmo->getReadingSnapshot(snapshot);
+      }
+    });
+    measure(groupStageCommands, [&]() { group.stageCommands(groupCommand); });
+    measure(groupPublishReadings, [&]() { group.publishReadings(); });
+    measure(groupGetReadings, [&]() { group.getReadings(groupReading); });
+  }
+
+  bool allocationFree = true;
+  printHeader(numberOfDrives, numberOfCycles);
+  for (const Operation* operation : {&stageCommand, &updateWrite, &updateRead, &getReading, &getReadingSnapshot,
+                                     &groupStageCommands, &groupPublishReadings, &groupGetReadings}) {
+    printOperation(*operation, numberOfDrives, numberOfCycles);
+    allocationFree &= operation->allocations == 0;
+  }
+  return allocationFree;
+}
+
+}  // namespace benchmark
+}  // namespace elmo
+
+int main(int argc, char** argv) {
+  unsigned int numberOfCycles = 100000;
+  bool checkAllocations = false;
+  bool useProcessImage = false;
+  for (int i = 1; i < argc; i++) {
+    if (std::string(argv[i]) == "--check-allocations") {
+      checkAllocations = true;
+    } else if (std::string(argv[i]) == "--process-image") {
+      useProcessImage = true;
+    } else {
+      numberOfCycles = static_cast<unsigned int>(std::strtoul(argv[i], nullptr, 10));
+    }
+  }
+  if (numberOfCycles == 0) {
+    std::cerr << "usage: " << argv[0] << " [--check-allocations] [--process-image] [number of cycles]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool allocationFree = true;
+  for (uint16_t numberOfDrives : {1, 8, 32}) {
+    allocationFree &= elmo::benchmark::runBenchmark(numberOfDrives, numberOfCycles, useProcessImage);
+  }
+
+  if (checkAllocations) {
+    if (!allocationFree) {
+      std::cerr << "\nFAILED: the cyclic path allocated heap memory after the warm up." << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "\nPASSED: no heap allocations in the cyclic path after the warm up." << std::endl;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,337 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Load test of the Elmo class with simulated drives, no hardware is needed.
+ * The drives are started up over the simulated mailbox (state machine, PDO
+ * mapping, motor parameters), enabled over the PDOs and commanded in cyclic
+ * synchronous torque mode by a controller thread, while a bus thread
+ * exchanges the process data at the bus rate.
+ *
+ * usage: elmo_ethercat_sdk_simulation_benchmark [--process-image] [--telemetry file]
+ *                                               [number of drives] [rate [Hz]] [duration [s]]
+ *
+ * With --telemetry, the readings of all drives are streamed to the file (see
+ * TelemetryStream) and the program fails if samples are dropped.
+ *
+ * The program fails (non-zero exit code) if a drive cannot be started up or
+ * enabled, or if the drives do not follow the torque commands.
+ */
+
+#define _USE_MATH_DEFINES  // for M_PI
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elmo_ethercat_sdk/CycleTiming.hpp"
+#include "elmo_ethercat_sdk/Elmo.hpp"
+#include "elmo_ethercat_sdk/ElmoGroup.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedBus.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedElmo.hpp"
+#include "elmo_ethercat_sdk/Telemetry.hpp"
+
+namespace elmo {
+namespace benchmark {
+
+struct SimulationOptions {
+  uint16_t numberOfDrives{64};
+  // [Hz]
+  double rate{10000.0};
+  // [s] of commanding after the drives are enabled
+  double duration{5.0};
+  bool useProcessImage{false};
+  // stream the telemetry to this file if not empty
+  std::string telemetryFileName;
+};
+
+Configuration createConfiguration() {
+  Configuration configuration;
+  configuration.modeOfOperationEnum = ModeOfOperationEnum::CyclicSynchronousTorqueMode;
+  configuration.rxPdoTypeEnum = RxPdoTypeEnum::RxPdoStandard;
+  configuration.txPdoTypeEnum = TxPdoTypeEnum::TxPdoStandard;
+  configuration.positionEncoderResolution = 1 << 14;
+  configuration.gearRatio = 1.0;
+  configuration.motorConstant = 0.1;
+  configuration.motorRatedCurrentA = 5.0;
+  configuration.maxCurrentA = 10.0;
+  configuration.direction = 1;
+  configuration.encoderPosition = Configuration::EncoderPosition::motor;
+  configuration.printDebugMessages = false;
+  return configuration;
+}
+
+void printStatistics(const std::string& name, const CycleStatistics& statistics) {
+  std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << statistics.p50.count() / 1000.0 << std::setw(12) << statistics.p99.count() / 1000.0
+            << std::setw(12) << statistics.p999.count() / 1000.0 << std::setw(12) << statistics.max.count() / 1000.0
+            << std::setw(12) << statistics.overruns << "\n";
+}
+
+/*!
+ * The bus thread: updateWrite of all drives, simulation of the drives,
+ * updateRead of all drives (ElmoGroup::updateRead), once per period.
+ */
+class BusThread {
+ public:
+  BusThread(SimulatedBus& bus, ElmoGroup& group, std::chrono::nanoseconds period)
+      : bus_(bus), group_(group), period_(period) {
+    // a cycle which does not fit into the period delays the next one
+    cycleHistogram_.setOverrunThreshold(period_);
+    simulationHistogram_.setOverrunThreshold(period_);
+  }
+
+  void start() { thread_ = std::thread(&BusThread::run, this); }
+  void stop() {
+    running_ = false;
+    thread_.join();
+  }
+
+  CycleStatistics getCycleStatistics() const { return cycleHistogram_.getStatistics(); }
+  CycleStatistics getSimulationStatistics() const { return simulationHistogram_.getStatistics(); }
+  uint64_t getNumberOfMissedCycles() const { return missedCycles_; }
+  void resetStatistics() {
+    cycleHistogram_.reset();
+    simulationHistogram_.reset();
+    missedCycles_ = 0;
+  }
+
+ protected:
+  void run() {
+    const double timeStep = std::chrono::duration<double>(period_).count();
+    auto nextCycle = std::chrono::steady_clock::now();
+    while (running_) {
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto& elmo : group_.getDrives()) {
+        elmo->updateWrite();
+      }
+      const auto simulationStart = std::chrono::steady_clock::now();
+      bus_.update(timeStep);
+      const auto simulationEnd = std::chrono::steady_clock::now();
+      group_.updateRead();
+      const auto end = std::chrono::steady_clock::now();
+      // the SDK part of the cycle, without the simulation of the drives
+      cycleHistogram_.record(end - start - (simulationEnd - simulationStart));
+      simulationHistogram_.record(simulationEnd - simulationStart);
+
+      nextCycle += period_;
+      if (nextCycle < end) {
+        // skip the cycles which are already due instead of catching up
+        while (nextCycle < end) {
+          nextCycle += period_;
+          missedCycles_++;
+        }
+      }
+      std::this_thread::sleep_until(nextCycle);
+    }
+  }
+
+  SimulatedBus& bus_;
+  ElmoGroup& group_;
+  std::chrono::nanoseconds period_;
+  std::thread thread_;
+  std::atomic<bool> running_{true};
+  CycleHistogram cycleHistogram_;
+  CycleHistogram simulationHistogram_;
+  std::atomic<uint64_t> missedCycles_{0};
+};
+
+bool runSimulation(const SimulationOptions& options) {
+  const auto period = std::chrono::nanoseconds(static_cast<int64_t>(1.0e9 / options.rate));
+  SimulatedBus bus(options.numberOfDrives);
+
+  ElmoGroup group;
+  for (uint16_t address = 1; address <= options.numberOfDrives; address++) {
+    auto elmo = std::make_shared<SimulatedElmo>("elmo_" + std::to_string(address), address);
+    bus.attach(*elmo);
+    elmo->setTimeStep(1.0 / options.rate);
+    elmo->loadConfiguration(createConfiguration());
+    group.addDrive(elmo);
+  }
+
+  // startup over the simulated mailbox
+  const auto startupStart = std::chrono::steady_clock::now();
+  group.enableParallelStartup();
+  bool success = true;
+  for (const auto& elmo : group.getDrives()) {
+    success &= elmo->startup();
+  }
+  const auto startupDuration = std::chrono::steady_clock::now() - startupStart;
+  if (!success) {
+    std::cerr << "the startup of the drives failed" << std::endl;
+    return false;
+  }
+  bus.setAllStates(EC_STATE_OPERATIONAL);
+  if (options.useProcessImage) {
+    for (uint16_t address = 1; address <= options.numberOfDrives; address++) {
+      const auto& elmo = group.getDrive(address - 1);
+      if (!elmo->setProcessImage(bus.getInputs(address), elmo->getCurrentPdoInfo().txPdoSize_,
+                                 bus.getOutputs(address), elmo->getCurrentPdoInfo().rxPdoSize_)) {
+        std::cerr << "setting the process image of " << elmo->getName() << " failed" << std::endl;
+      }
+    }
+  }
+
+  auto telemetryStream = std::make_shared<TelemetryStream>();
+  if (!options.telemetryFileName.empty()) {
+    if (!telemetryStream->start(options.telemetryFileName)) {
+      return false;
+    }
+    for (const auto& elmo : group.getDrives()) {
+      elmo->setTelemetryStream(telemetryStream);
+    }
+  }
+
+  BusThread busThread(bus, group, period);
+  busThread.start();
+
+  // the controller: enable all drives, then command a torque sine
+  const auto enableStart = std::chrono::steady_clock::now();
+  success = group.setDriveStatesViaPdo(DriveState::OperationEnabled, true);
+  const auto enableDuration = std::chrono::steady_clock::now() - enableStart;
+  if (!success) {
+    busThread.stop();
+    std::cerr << "enabling the drives failed" << std::endl;
+    return false;
+  }
+
+  for (const auto& elmo : group.getDrives()) {
+    elmo->resetCycleStatistics();
+  }
+  busThread.resetStatistics();
+
+  GroupCommand commands;
+  commands.resize(options.numberOfDrives);
+  GroupReading readings;
+  readings.resize(options.numberOfDrives);
+  const auto numberOfCycles = static_cast<uint64_t>(options.duration * options.rate);
+  auto nextCycle = std::chrono::steady_clock::now();
+  for (uint64_t cycle = 0; cycle < numberOfCycles; cycle++) {
+    group.getReadings(readings);
+    const double time = static_cast<double>(cycle) / options.rate;
+    for (std::size_t i = 0; i < options.numberOfDrives; i++) {
+      // [Nm], 1 Hz, a different phase per drive
+      commands.targetTorques[i] = 0.1 * std::sin(2.0 * M_PI * time + 0.1 * static_cast<double>(i));
+    }
+    group.stageCommands(commands);
+    nextCycle += period;
+    std::this_thread::sleep_until(nextCycle);
+  }
+  busThread.stop();
+
+  // the simulated motors follow the commands
+  group.getReadings(readings);
+  bool followed = true;
+  for (std::size_t i = 0; i < options.numberOfDrives; i++) {
+    const double torque = bus.getDrive(static_cast<uint16_t>(i + 1)).getTorque();
+    followed &= readings.driveStates[i] == DriveState::OperationEnabled &&
+                std::abs(torque - commands.targetTorques[i]) < 0.01 &&
+                std::abs(readings.actualTorques[i] - torque) < 0.01;
+  }
+
+  std::cout << options.numberOfDrives << " simulated drive(s) at " << options.rate << " Hz\n"
+            << "startup: " << std::chrono::duration_cast<std::chrono::milliseconds>(startupDuration).count()
+            << " ms, enable: " << std::chrono::duration_cast<std::chrono::milliseconds>(enableDuration).count()
+            << " ms\n\n"
+            << std::left << std::setw(24) << "per cycle" << std::right << std::setw(12) << "p50 [us]"
+            << std::setw(12) << "p99 [us]" << std::setw(12) << "p99.9 [us]" << std::setw(12) << "max [us]"
+            << std::setw(12) << "overruns"
+            << "\n";
+  printStatistics("sdk (all drives)", busThread.getCycleStatistics());
+  printStatistics("simulation", busThread.getSimulationStatistics());
+  std::cout << "\n" << std::left << std::setw(24) << "per drive" << "\n";
+  CycleStatistics worstUpdateWrite;
+  CycleStatistics worstUpdateRead;
+  for (const auto& elmo : group.getDrives()) {
+    const CycleStatistics updateWrite = elmo->getUpdateWriteStatistics();
+    const CycleStatistics updateRead = elmo->getUpdateReadStatistics();
+    if (updateWrite.p99 >= worstUpdateWrite.p99) {
+      worstUpdateWrite = updateWrite;
+    }
+    if (updateRead.p99 >= worstUpdateRead.p99) {
+      worstUpdateRead = updateRead;
+    }
+  }
+  printStatistics("updateWrite (worst)", worstUpdateWrite);
+  printStatistics("updateRead (worst)", worstUpdateRead);
+  std::cout << "\nmissed cycles: " << busThread.getNumberOfMissedCycles() << " of " << numberOfCycles << std::endl;
+
+  bool streamed = true;
+  if (!options.telemetryFileName.empty()) {
+    telemetryStream->stop();
+    std::ifstream file(options.telemetryFileName, std::ios::binary | std::ios::ate);
+    std::cout << "telemetry: " << telemetryStream->getNumberOfWrittenSamples() << " samples ("
+              << telemetryStream->getNumberOfDroppedSamples() << " dropped) in " << file.tellg() << " bytes"
+              << std::endl;
+    TelemetryReader reader;
+    streamed = telemetryStream->getNumberOfDroppedSamples() == 0 && reader.open(options.telemetryFileName) &&
+               reader.getChannels().size() == options.numberOfDrives;
+    for (const auto& channel : reader.getChannels()) {
+      streamed &= channel.numberOfDroppedSamples == 0 && channel.columns.size() > 0;
+    }
+    if (!streamed) {
+      std::cerr << "the telemetry was not streamed completely" << std::endl;
+    }
+  }
+
+  if (!followed) {
+    std::cerr << "the simulated drives did not follow the torque commands" << std::endl;
+  }
+  return followed && streamed;
+}
+
+}  // namespace benchmark
+}  // namespace elmo
+
+int main(int argc, char** argv) {
+  elmo::benchmark::SimulationOptions options;
+  std::vector<double> arguments;
+  for (int i = 1; i < argc; i++) {
+    if (std::string(argv[i]) == "--process-image") {
+      options.useProcessImage = true;
+    } else if (std::string(argv[i]) == "--telemetry" && i + 1 < argc) {
+      options.telemetryFileName = argv[++i];
+    } else {
+      arguments.push_back(std::strtod(argv[i], nullptr));
+    }
+  }
+  if (arguments.size() > 0) {
+    options.numberOfDrives = static_cast<uint16_t>(arguments[0]);
+  }
+  if (arguments.size() > 1) {
+    options.rate = arguments[1];
+  }
+  if (arguments.size() > 2) {
+    options.duration = arguments[2];
+  }
+  if (arguments.size() > 3 || options.numberOfDrives == 0 || options.rate <= 0.0 || options.duration <= 0.0) {
+    std::cerr << "usage: " << argv[0]
+              << " [--process-image] [--telemetry file] [number of drives] [rate [Hz]] [duration [s]]" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return elmo::benchmark::runSimulation(options) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
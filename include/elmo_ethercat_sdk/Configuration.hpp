@@ -25,6 +25,7 @@
 #include <utility>
 
 #include "elmo_ethercat_sdk/ModeOfOperationEnum.hpp"
+#include "elmo_ethercat_sdk/PdoLayout.hpp"
 #include "elmo_ethercat_sdk/PdoTypeEnum.hpp"
 
 namespace elmo {
@@ -40,11 +41,18 @@ class Configuration {
   ModeOfOperationEnum modeOfOperationEnum{ModeOfOperationEnum::NA};
   RxPdoTypeEnum rxPdoTypeEnum{RxPdoTypeEnum::NA};
   TxPdoTypeEnum txPdoTypeEnum{TxPdoTypeEnum::NA};
+  // only used by RxPdoCustom / TxPdoCustom
+  PdoLayout rxPdoLayout;
+  PdoLayout txPdoLayout;
   unsigned int configRunSdoVerifyTimeout{20000};
   bool printDebugMessages{true};
   unsigned int driveStateChangeMinTimeout{20000};
   unsigned int minNumberOfSuccessfulTargetStateReadings{10};
   unsigned int driveStateChangeMaxTimeout{300000};
+  // advance as soon as the drive state changes instead of waiting driveStateChangeMinTimeout,
+  // confirm the target state for driveStateChangeConfirmationWindow [us] instead of counting readings
+  bool adaptiveDriveStateChange{false};
+  unsigned int driveStateChangeConfirmationWindow{0};
   bool forceAppendEqualError{true};
   bool forceAppendEqualFault{false};
   unsigned int errorStorageCapacity{100};
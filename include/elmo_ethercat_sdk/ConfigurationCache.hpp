@@ -0,0 +1,78 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "elmo_ethercat_sdk/Configuration.hpp"
+
+namespace elmo {
+
+/*!
+ * @brief	Process wide cache of parsed configuration files
+ * The configurations are keyed by the FNV-1a hash of the content of the YAML
+ * file, such that a changed file is parsed again. A file loaded for many
+ * drives is parsed once per process. If a directory is set, the
+ * configurations are also stored in versioned binary files, which are
+ * memory-mapped instead of parsing the YAML file on the next launch.
+ * Only configurations which pass the sanity check are cached.
+ */
+class ConfigurationCache {
+ public:
+  static ConfigurationCache& instance();
+
+  ConfigurationCache(const ConfigurationCache&) = delete;
+  ConfigurationCache& operator=(const ConfigurationCache&) = delete;
+
+  /*!
+   * @param directory	the directory of the cache files (created if missing), empty to only cache in memory (default)
+   */
+  void setDirectory(const std::string& directory);
+
+  /*!
+   * The configuration of a YAML file: from memory, from the cache file of its
+   * content or parsed by ConfigurationParser. Thread safe.
+   * @param fileName	the path to the configuration file
+   */
+  Configuration getConfiguration(const std::string& fileName);
+
+  // forget the configurations in memory, the cache files are kept
+  void clear();
+
+  // 64 bit FNV-1a hash
+  static uint64_t hash(const std::string& data);
+
+ protected:
+  ConfigurationCache() = default;
+
+  std::string getCacheFileName(uint64_t contentHash) const;
+  bool readCacheFile(uint64_t contentHash, Configuration& configuration) const;
+  void writeCacheFile(uint64_t contentHash, const Configuration& configuration) const;
+
+  std::mutex mutex_;
+  std::string directory_;
+  std::unordered_map<uint64_t, Configuration> configurations_;
+};
+
+}  // namespace elmo
@@ -23,72 +23,110 @@
 #include <cstdint>
 #include <iostream>
 
+#include "elmo_ethercat_sdk/StateTransitionTable.hpp"
+
 namespace elmo {
 
-struct Controlword {
-  bool switchOn_{false};              // bit 0
-  bool enableVoltage_{false};         // bit 1
-  bool quickStop_{false};             // bit 2
-  bool enableOperation_{false};       // bit 3
-  bool newSetPoint_{false};           // bit 4 profiled position mode
-  bool homingOperationStart_{false};  // bit 4 homing mode
-  bool changeSetImmediately_{false};  // bit 5 profiled position mode
-  bool relative_{false};              // bit 6 profiled position mode
-  bool faultReset_{false};            // bit 7
-  bool halt_{false};                  // bit 8
+/*!
+ * @brief	Controlword (0x6040) written to the drive
+ * The bits are set on access, the raw controlword is stored.
+ * Replaces the former public bool members: e.g. controlword.switchOn_ = true
+ * becomes controlword.setSwitchOn(true), reading it getSwitchOn(). The same
+ * applies to enableVoltage_, quickStop_, enableOperation_, newSetPoint_,
+ * homingOperationStart_, changeSetImmediately_, relative_, faultReset_ and
+ * halt_. newSetPoint and homingOperationStart share bit 4.
+ */
+class Controlword {
+ public:
+  constexpr Controlword() = default;
+  constexpr explicit Controlword(uint16_t rawControlword) : rawControlword_(rawControlword) {}
 
   /*!
    * get the control word as a 16 bit unsigned integer
-   * THIS DOES NOT RESPECT THE MODE SPECIFIC OPTIONS!
-   * The usually used cyclic modes do not need mode specific options.
+   * This contains the mode specific bits 4-6, which are not used by the usual
+   * cyclic modes.
    * @return	the raw controlword
    */
-  uint16_t getRawControlword();
+  constexpr uint16_t getRawControlword() const { return rawControlword_; }
+
+  constexpr bool getSwitchOn() const { return getBit(0); }
+  constexpr bool getEnableVoltage() const { return getBit(1); }
+  constexpr bool getQuickStop() const { return getBit(2); }
+  constexpr bool getEnableOperation() const { return getBit(3); }
+  // profiled position mode
+  constexpr bool getNewSetPoint() const { return getBit(4); }
+  // homing mode
+  constexpr bool getHomingOperationStart() const { return getBit(4); }
+  // profiled position mode
+  constexpr bool getChangeSetImmediately() const { return getBit(5); }
+  // profiled position mode
+  constexpr bool getRelative() const { return getBit(6); }
+  constexpr bool getFaultReset() const { return getBit(7); }
+  constexpr bool getHalt() const { return getBit(8); }
+
+  constexpr void setSwitchOn(bool value) { setBit(0, value); }
+  constexpr void setEnableVoltage(bool value) { setBit(1, value); }
+  constexpr void setQuickStop(bool value) { setBit(2, value); }
+  constexpr void setEnableOperation(bool value) { setBit(3, value); }
+  constexpr void setNewSetPoint(bool value) { setBit(4, value); }
+  constexpr void setHomingOperationStart(bool value) { setBit(4, value); }
+  constexpr void setChangeSetImmediately(bool value) { setBit(5, value); }
+  constexpr void setRelative(bool value) { setBit(6, value); }
+  constexpr void setFaultReset(bool value) { setBit(7, value); }
+  constexpr void setHalt(bool value) { setBit(8, value); }
+
+  /*!
+   * Set the controlword of a state transition (see StateTransitionTable),
+   * all other bits are cleared.
+   */
+  constexpr void setStateTransition(StateTransition stateTransition) {
+    rawControlword_ = StateTransitionTable::getControlword(stateTransition);
+  }
 
   /*!
    * State transition 2
    * SWITCH ON DISABLED -> READY TO SWITCH ON
    * This corresponds to a "shutdown" Controlword
    */
-  void setStateTransition2();
+  constexpr void setStateTransition2() { setStateTransition(StateTransition::_2); }
 
   /*!
    * State transition 3
    * READY TO SWITCH ON -> SWITCHED ON
    * This corresponds to a "switch on" Controlword
    */
-  void setStateTransition3();
+  constexpr void setStateTransition3() { setStateTransition(StateTransition::_3); }
 
   /*!
    * State transition 4
    * SWITCHED ON -> ENABLE OPERATION
    */
-  void setStateTransition4();
+  constexpr void setStateTransition4() { setStateTransition(StateTransition::_4); }
 
   /*!
    * State transition 5
    * OPERATION ENABLED -> SWITCHED ON
    * This corresponds to a "disable operation" Controlword
    */
-  void setStateTransition5();
+  constexpr void setStateTransition5() { setStateTransition(StateTransition::_5); }
 
   /*!
    * State transition 6
    * SWITCHED ON -> READY TO SWITCH ON
    */
-  void setStateTransition6();
+  constexpr void setStateTransition6() { setStateTransition(StateTransition::_6); }
 
   /*!
    * State transition 7
    * READY TO SWITCH ON -> SWITCH ON DISABLED
    */
-  void setStateTransition7();
+  constexpr void setStateTransition7() { setStateTransition(StateTransition::_7); }
 
   /*!
    * State transition 8
    * OPERATION ENABLED -> READY TO SWITCH ON
    */
-  void setStateTransition8();
+  constexpr void setStateTransition8() { setStateTransition(StateTransition::_8); }
 
   /*!
    * State transition 9
@@ -96,45 +134,54 @@ struct Controlword {
    * This resets the elmo to the same state as on hardware startup
    * 0x0000
    */
-  void setStateTransition9();
+  constexpr void setStateTransition9() { setStateTransition(StateTransition::_9); }
 
   /*!
    * State transition 10
    * SWITCHED ON -> SWITCH ON DISABLED
    * This Statusword is 0x0000
    */
-  void setStateTransition10();
+  constexpr void setStateTransition10() { setStateTransition(StateTransition::_10); }
 
   /*!
    * State transition 11
    * OPERATION ENABLED -> QUICK STOP ACTIVE
    */
-  void setStateTransition11();
+  constexpr void setStateTransition11() { setStateTransition(StateTransition::_11); }
 
   /*!
    * State transition 12
    * QUICK STOP ACTIVE -> SWITCH ON DISABLED
    */
-  void setStateTransition12();
+  constexpr void setStateTransition12() { setStateTransition(StateTransition::_12); }
 
   /*!
    * State transition 15
    * FAULT -> SWITCH ON DISABLED
    */
-  void setStateTransition15();
+  constexpr void setStateTransition15() { setStateTransition(StateTransition::_15); }
 
   /*!
-   * Sets all bools of this struct to false
+   * Clears all bits
    */
-  void setAllFalse();
+  constexpr void setAllFalse() { rawControlword_ = 0; }
 
   /*!
    * goes to the init state
    * Alias for state transition 2
    */
-  void setInit();
+  constexpr void setInit() { setStateTransition2(); }
 
   friend std::ostream& operator<<(std::ostream& os, const Controlword& controlword);
+
+ private:
+  constexpr bool getBit(unsigned int bit) const { return (rawControlword_ >> bit) & 1; }
+  constexpr void setBit(unsigned int bit, bool value) {
+    rawControlword_ =
+        static_cast<uint16_t>((rawControlword_ & ~(1u << bit)) | (static_cast<unsigned int>(value) << bit));
+  }
+
+  uint16_t rawControlword_{0};
 };
 
 }  // namespace elmo
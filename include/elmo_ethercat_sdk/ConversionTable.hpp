@@ -0,0 +1,114 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "elmo_ethercat_sdk/Configuration.hpp"
+#include "elmo_ethercat_sdk/UnitConversion.hpp"
+
+namespace elmo {
+
+/*!
+ * Unit conversion factors of one drive.
+ * Computed once from a Configuration and shared by the reading and the command
+ * path, such that both directions of the conversion are consistent and the
+ * cyclic conversion consists of multiplications only.
+ */
+class ConversionTable {
+ public:
+  /*!
+   * Identity conversion (all factors 1).
+   */
+  ConversionTable() = default;
+
+  /*!
+   * @brief	Compute the factors from the hardware parameters
+   * @param[in] configuration	the configuration of the drive
+   */
+  explicit ConversionTable(const Configuration& configuration);
+
+  /*!
+   * raw (drive) units -> user units
+   */
+  double getPositionFactorIntegerToRad() const { return positionFactorIntegerToRad_; }
+  double getVelocityFactorIntegerPerSecToRadPerSec() const { return velocityFactorIntegerPerSecToRadPerSec_; }
+  double getCurrentFactorIntegerToAmp() const { return currentFactorIntegerToAmp_; }
+  double getTorqueFactorIntegerToNm() const { return torqueFactorIntegerToNm_; }
+
+  /*!
+   * user units -> raw (drive) units
+   */
+  double getPositionFactorRadToInteger() const { return positionFactorRadToInteger_; }
+  double getVelocityFactorRadPerSecToIntegerPerSec() const { return velocityFactorRadPerSecToIntegerPerSec_; }
+  double getCurrentFactorAToInteger() const { return currentFactorAToInteger_; }
+  double getTorqueFactorNmToInteger() const { return torqueFactorNmToInteger_; }
+
+  /*!
+   * convert user unit commands to raw units in drive direction, saturated to
+   * the range of the raw type
+   */
+  int32_t positionToRaw(double position) const {
+    return saturatingCast<int32_t>(positionFactorRadToInteger_ * direction_ * position);
+  }
+  int32_t velocityToRaw(double velocity) const {
+    return saturatingCast<int32_t>(velocityFactorRadPerSecToIntegerPerSec_ * direction_ * velocity);
+  }
+  int16_t torqueToRaw(double torque) const {
+    return saturatingCast<int16_t>(torqueFactorNmToInteger_ * direction_ * torque);
+  }
+  int16_t currentToRaw(double current) const {
+    return saturatingCast<int16_t>(currentFactorAToInteger_ * direction_ * current);
+  }
+
+  /*!
+   * limits in user and raw units
+   */
+  double getMaxCurrent() const { return maxCurrent_; }
+  double getMaxTorque() const { return maxTorque_; }
+  uint16_t getMaxCurrentRaw() const { return maxCurrentRaw_; }
+  uint16_t getMaxTorqueRaw() const { return maxTorqueRaw_; }
+
+  /*!
+   * sign applied to position, velocity, current and torque values
+   */
+  int getDirection() const { return direction_; }
+
+ private:
+  double positionFactorIntegerToRad_{1};
+  double velocityFactorIntegerPerSecToRadPerSec_{1};
+  double currentFactorIntegerToAmp_{1};
+  double torqueFactorIntegerToNm_{1};
+
+  double positionFactorRadToInteger_{1};
+  double velocityFactorRadPerSecToIntegerPerSec_{1};
+  double currentFactorAToInteger_{1};
+  double torqueFactorNmToInteger_{1};
+
+  double maxCurrent_{0};
+  double maxTorque_{0};
+  uint16_t maxCurrentRaw_{0};
+  uint16_t maxTorqueRaw_{0};
+
+  int direction_{1};
+};
+
+}  // namespace elmo
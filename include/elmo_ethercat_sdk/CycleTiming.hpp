@@ -0,0 +1,111 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace elmo {
+
+/*!
+ * Summary of a CycleHistogram.
+ * The percentiles are upper bounds with a resolution of 12.5 %.
+ */
+struct CycleStatistics {
+  uint64_t count{0};
+  // number of values above the overrun threshold
+  uint64_t overruns{0};
+  std::chrono::nanoseconds min{0};
+  std::chrono::nanoseconds max{0};
+  std::chrono::nanoseconds p50{0};
+  std::chrono::nanoseconds p99{0};
+  std::chrono::nanoseconds p999{0};
+};
+
+/*!
+ * @brief	Fixed size, logarithmic histogram of durations
+ * record() is called by a single thread (the bus thread) and does not
+ * allocate or lock. getStatistics() and reset() can be called from any thread.
+ */
+class CycleHistogram {
+ public:
+  CycleHistogram();
+
+  /*!
+   * Add a value, only called by one thread.
+   * @param value	the duration
+   */
+  void record(std::chrono::nanoseconds value);
+
+  CycleStatistics getStatistics() const;
+
+  /*!
+   * Clear the histogram. The request is applied by the next call to record().
+   */
+  void reset() { resetRequested_.store(true, std::memory_order_relaxed); }
+
+  /*!
+   * @param threshold	values above the threshold are counted as overruns, 0 disables the counting
+   */
+  void setOverrunThreshold(std::chrono::nanoseconds threshold) {
+    overrunThreshold_.store(threshold.count(), std::memory_order_relaxed);
+  }
+  std::chrono::nanoseconds getOverrunThreshold() const {
+    return std::chrono::nanoseconds(overrunThreshold_.load(std::memory_order_relaxed));
+  }
+
+ protected:
+  static std::size_t getBucketIndex(uint64_t value);
+  static uint64_t getBucketUpperBound(std::size_t index);
+  void clear();
+
+  // 8 buckets per power of two, up to 2^36 ns (~68 s)
+  static constexpr std::size_t subBucketBits_{3};
+  static constexpr std::size_t numberOfBuckets_{(36 - subBucketBits_ + 1) << subBucketBits_};
+
+  std::array<std::atomic<uint64_t>, numberOfBuckets_> buckets_;
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> overruns_{0};
+  std::atomic<uint64_t> min_{UINT64_MAX};
+  std::atomic<uint64_t> max_{0};
+  std::atomic<int64_t> overrunThreshold_{0};
+  std::atomic<bool> resetRequested_{false};
+};
+
+/*!
+ * Source of the time of the cyclic path of a drive (state machine timeouts,
+ * time points of the readings), e.g. the recorded time during a replay.
+ * The durations of the cycles are always measured with std::chrono::steady_clock.
+ */
+class CycleClock {
+ public:
+  virtual ~CycleClock() = default;
+  virtual std::chrono::steady_clock::time_point now() const = 0;
+};
+
+}  // namespace elmo
+
+// stream operator in global namespace
+std::ostream& operator<<(std::ostream& os, const elmo::CycleStatistics& statistics);
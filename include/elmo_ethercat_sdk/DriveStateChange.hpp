@@ -0,0 +1,79 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#include "elmo_ethercat_sdk/DriveState.hpp"
+
+namespace elmo {
+
+class Elmo;
+
+enum class DriveStateChangeStatus : uint8_t {
+  // the drive has not reached the target state yet
+  Pending,
+  Succeeded,
+  // not reached within drive_state_change_max_timeout. The state machine keeps
+  // running, the status changes to Succeeded if the target state is reached later.
+  TimedOut,
+  // a newer state change was taken over before this one finished, or has finished since
+  Superseded,
+  // default constructed handle
+  Invalid
+};
+
+/*!
+ * @brief	Handle of a PDO state change (see Elmo::requestDriveStateViaPdo)
+ * The state change is conducted and completed by the bus thread in
+ * updateWrite. Querying and waiting reads an atomic of the drive, it does not
+ * lock the drive. The handle must not outlive the drive.
+ */
+class DriveStateChangeHandle {
+ public:
+  DriveStateChangeHandle() = default;
+
+  DriveStateChangeStatus getStatus() const;
+  // the status is not Pending
+  bool isFinished() const;
+  /*!
+   * Wait until the state change is finished or the timeout passed.
+   * @return the status, Pending on timeout
+   */
+  DriveStateChangeStatus waitFor(const std::chrono::microseconds& timeout) const;
+  DriveState getTargetDriveState() const { return targetDriveState_; }
+
+ protected:
+  friend class Elmo;
+  DriveStateChangeHandle(const Elmo* elmo, uint64_t sequenceNumber, DriveState targetDriveState)
+      : elmo_(elmo), sequenceNumber_(sequenceNumber), targetDriveState_(targetDriveState) {}
+
+  const Elmo* elmo_{nullptr};
+  uint64_t sequenceNumber_{0};
+  DriveState targetDriveState_{DriveState::NA};
+};
+
+}  // namespace elmo
+
+// stream operator in global namespace
+std::ostream& operator<<(std::ostream& os, const elmo::DriveStateChangeStatus& status);
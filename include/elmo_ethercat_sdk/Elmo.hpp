@@ -24,6 +24,17 @@
 #include"elmo_ethercat_sdk/DriveState.hpp"
 #include "elmo_ethercat_sdk/Reading.hpp"
 #include "elmo_ethercat_sdk/Controlword.hpp"
+#include "elmo_ethercat_sdk/ConversionTable.hpp"
+#include "elmo_ethercat_sdk/CycleTiming.hpp"
+#include "elmo_ethercat_sdk/DriveStateChange.hpp"
+#include "elmo_ethercat_sdk/Mailbox.hpp"
+#include "elmo_ethercat_sdk/PdoAssignment.hpp"
+#include "elmo_ethercat_sdk/PdoRecorder.hpp"
+#include "elmo_ethercat_sdk/RtLog.hpp"
+#include "elmo_ethercat_sdk/RxPdo.hpp"
+#include "elmo_ethercat_sdk/SeqLock.hpp"
+#include "elmo_ethercat_sdk/StartupOrchestrator.hpp"
+#include "elmo_ethercat_sdk/Telemetry.hpp"
 
 #include <ethercat_sdk_master/EthercatDevice.hpp>
 
@@ -32,13 +43,19 @@
 #include <mutex>
 #include <atomic>
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <chrono>
+#include <thread>
+#include <vector>
 
 namespace elmo {
   class Elmo : public ecat_master::EthercatDevice{
     public:
       typedef std::shared_ptr<Elmo> SharedPtr;
+      // copy a custom PDO of a fixed size between the bus and a byte array
+      using ReadTxPdoBytesFunction = void (*)(soem_interface::EthercatBusBase&, uint16_t, uint8_t*);
+      using WriteRxPdoBytesFunction = void (*)(soem_interface::EthercatBusBase&, uint16_t, const uint8_t*);
 
       // create Elmo Drive from setup file
       static SharedPtr deviceFromFile(const std::string& configFile, const std::string& name, const uint32_t address);
@@ -48,44 +65,189 @@ namespace elmo {
 
     // pure virtual overwrites
     public:
+      // runs the startup sequence, or hands it to the startup orchestrator if one is set
       bool startup() override;
       void shutdown() override;
       void updateWrite() override;
       void updateRead() override;
       PdoInfo getCurrentPdoInfo() const override { return pdoInfo_; }
 
+    // Startup
     public:
+      // EtherCAT state and distributed clock of the drive on the bus, followed by configureDriveViaSdo.
+      // called by startup() or by the StartupOrchestrator, overridden by drives
+      // which are not on a real bus (see SimulatedElmo).
+      virtual bool runStartupSequence();
+      // run the startup sequence concurrently to other drives (see ElmoGroup::enableParallelStartup)
+      void setStartupOrchestrator(const StartupOrchestrator::SharedPtr& startupOrchestrator);
+
+    public:
+      // converts the command and hands it to the bus thread without locking.
+      // the mailbox to the bus thread has a single producer: all commands of the drive (stageCommand,
+      // stageRawCommand, ElmoGroup::stageCommands) must be staged from the same thread until the next
+      // loadConfiguration. checked by an assert in debug builds.
       void stageCommand(const Command& command);
+      // stage a command which is already in raw units and drive direction (see ElmoGroup).
+      // the controlword and the mode of operation of rxPdo are ignored.
+      void stageRawCommand(const RxPdoStandard& rxPdo);
       Reading getReading() const;
       void getReading(Reading& reading) const;
+      // lock-free access to the most recent process data (without error / fault history)
+      ReadingSnapshot getReadingSnapshot() const;
+      void getReadingSnapshot(ReadingSnapshot& snapshot) const;
 
+      // parsed once per file content, see ConfigurationCache
       bool loadConfigFile(const std::string& fileName);
       bool loadConfigNode(YAML::Node configNode);
       bool loadConfiguration(const Configuration& configuration);
       Configuration getConfiguration() const;
+      // the conversion factors of the configuration, published by loadConfiguration and the startup
+      // (which may run on a worker thread, see StartupOrchestrator). can be read from any thread.
+      ConversionTable getConversionTable() const { return publishedConversionTable_.load(); }
+      void getConversionTable(ConversionTable& conversionTable) const{
+        publishedConversionTable_.load(conversionTable);
+      }
+
+    // Process image
+    public:
+      /*!
+       * Decode / encode the PDOs directly in the process image of the bus instead of
+       * copying them through EthercatBusBase::readTxPdo / writeRxPdo.
+       * The images must stay valid and must only be accessed by the thread calling
+       * updateRead / updateWrite (e.g. the update thread of the bus), as the bus
+       * mutex is not locked. Must be called after the startup, the sizes are
+       * validated against the PDO sizes mapped by the drive and the configured
+       * PDO types. Loading a configuration clears the process image.
+       * @return false if the sizes do not match, the PDOs are copied in this case.
+       */
+      bool setProcessImage(const uint8_t* inputs, std::size_t inputsSize, uint8_t* outputs, std::size_t outputsSize);
+      void clearProcessImage();
+
+    // Cycle timing, can be queried from any thread
+    public:
+      // duration of updateRead / updateWrite
+      CycleStatistics getUpdateReadStatistics() const;
+      CycleStatistics getUpdateWriteStatistics() const;
+      // time between the starts of two consecutive updateRead calls
+      CycleStatistics getReadPeriodStatistics() const;
+      void resetCycleStatistics();
+      // durations / periods above the thresholds are counted as overruns.
+      // by default derived from the time step at startup.
+      void setCycleOverrunThresholds(const std::chrono::nanoseconds& updateDuration,
+                                     const std::chrono::nanoseconds& readPeriod);
+
+    // Replay
+    public:
+      /*!
+       * Take the time of the cyclic path from a clock instead of std::chrono::steady_clock
+       * (see PdoReplay), nullptr restores the steady clock. The clock must outlive the drive.
+       */
+      void setCycleClock(const CycleClock* cycleClock);
+
+    // Recording
+    public:
+      /*!
+       * Record the raw PDOs exchanged by updateWrite / updateRead into the ring
+       * file of the recorder (see PdoRecorder), nullptr stops the recording.
+       * The recorder must be open and only be used by this drive.
+       */
+      void setPdoRecorder(const PdoRecorder::SharedPtr& pdoRecorder);
+      /*!
+       * Push the raw process data of every updateRead into a queue of the
+       * telemetry stream (see TelemetryStream), which is written to disk by
+       * its writer thread. nullptr stops the streaming.
+       */
+      void setTelemetryStream(const TelemetryStream::SharedPtr& telemetryStream);
 
     //SDO
     public:
       bool getStatuswordViaSdo(Statusword& statusword);
       bool setControlwordViaSdo(Controlword& controlword);
       bool setDriveStateViaSdo(const DriveState& driveState);
+      // poll the statusword until the drive state is reached, at most drive_state_change_max_timeout
+      bool waitForDriveStateViaSdo(const DriveState& driveState);
     protected:
       bool stateTransitionViaSdo(const StateTransition& stateTransition);
+      // SDO configuration of the drive (state, PDO mapping, motor parameters)
+      bool configureDriveViaSdo();
+      // every SDO transfer of the drive goes through these, by default to the mailbox of the bus.
+      // overridden by drives which are not on a real bus (see SimulatedElmo).
+      virtual bool sdoReadBytes(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data,
+                                std::size_t size);
+      virtual bool sdoWriteBytes(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                                 std::size_t size);
+      template <typename Value>
+      bool sdoRead(uint16_t index, uint8_t subindex, bool completeAccess, Value& value);
+      template <typename Value>
+      bool sdoWrite(uint16_t index, uint8_t subindex, bool completeAccess, const Value& value);
 
     // PDO
     public:
+      /*!
+       * Request a state change which is conducted by the bus thread in updateWrite.
+       * Does not block and does not lock the drive, a pending state change is superseded.
+       */
+      DriveStateChangeHandle requestDriveStateViaPdo(const DriveState& driveState);
+      // waits with DriveStateChangeHandle::waitFor if requested
       bool setDriveStateViaPdo(const DriveState& driveState, const bool waitForState);
-      bool lastPdoStateChangeSuccessful() const { return stateChangeSuccessful_; }
+      bool lastPdoStateChangeSuccessful() const;
+      DriveStateChangeStatus getDriveStateChangeStatus(uint64_t sequenceNumber) const;
 
     // Other
       double getActual5vVoltage() { return actual5vVoltage_; }
 
     protected:
       void engagePdoStateMachine();
+      // publish the status of the active state change
+      void finishDriveStateChange(DriveStateChangeStatus status);
       bool mapPdos(RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum);
-      Controlword getNextStateTransitionControlword(const DriveState& requestedDriveState,
-                                                    const DriveState& currentDriveState);
+      // write the mapping object of a custom PDO unless the drive already holds it
+      bool updatePdoMapping(uint16_t mappingIndex, const std::vector<uint32_t>& mappingEntries);
+      // write the assignment unless the drive already holds it
+      bool updatePdoAssignment(const PdoAssignment& pdoAssignment);
+      bool readPdoAssignment(uint16_t assignmentIndex, PdoAssignment& pdoAssignment);
+      template <std::size_t NumberOfEntries>
+      bool readPdoAssignmentCompleteAccess(uint16_t assignmentIndex, PdoAssignment& pdoAssignment);
+      bool writePdoAssignment(const PdoAssignment& pdoAssignment);
+      // write and read back, retrying with an increasing backoff (up to config_run_sdo_verify_timeout) on failure
+      template <typename Value>
+      bool sdoWriteVerified(uint16_t index, uint8_t subindex, Value value);
       void autoConfigurePdoSizes();
+      // recompute the unit conversion factors from configuration_
+      void updateConversionTable();
+      // PDO codecs, selected once by selectPdoCodecs instead of switching on the PDO type every cycle.
+      // return false if the PDO type is not supported.
+      template <typename TxPdo>
+      bool readTxPdo();
+      bool readCustomTxPdo();
+      bool readUnsupportedTxPdo() { return false; }
+      template <typename RxPdo>
+      bool writeRxPdo(const RxPdoStandard& stagedCommand);
+      bool writeCustomRxPdo(const RxPdoStandard& stagedCommand);
+      bool writeUnsupportedRxPdo(const RxPdoStandard&) { return false; }
+      template <typename TxPdo>
+      bool readTxPdoInPlace();
+      bool readCustomTxPdoInPlace();
+      template <typename RxPdo>
+      bool writeRxPdoInPlace(const RxPdoStandard& stagedCommand);
+      bool writeCustomRxPdoInPlace(const RxPdoStandard& stagedCommand);
+      void selectPdoCodecs();
+      std::chrono::steady_clock::time_point getCycleTime() const{
+        return cycleClock_ == nullptr ? std::chrono::steady_clock::now() : cycleClock_->now();
+      }
+      // describe the selected PDOs in the file header of the recorder
+      void describeRecordedPdos();
+      void recordPdo(PdoRecord::Type type, const uint8_t* data, std::size_t size){
+        if(pdoRecorder_){
+          pdoRecorder_->record(type, data, size);
+        }
+      }
+      // size of the configured PDO types, 0 if not supported
+      std::size_t getConfiguredRxPdoSize() const;
+      std::size_t getConfiguredTxPdoSize() const;
+      void updateReadInternal(const std::chrono::steady_clock::time_point& timePoint);
+      void updateWriteInternal();
+      void setDefaultCycleOverrunThresholds();
 
       uint16_t getTxPdoSize();
       uint16_t getRxPdoSize();
@@ -97,30 +259,90 @@ namespace elmo {
 
 
     protected:
-      Command stagedCommand_;
+      // converted commands (without controlword) handed from stageCommand to updateWrite
+      Mailbox<RxPdoStandard> stagedCommand_;
+      // the producer of stagedCommand_, checked in debug builds
+      std::atomic<std::thread::id> stagingThread_{};
+      // error / fault history and configuration, guarded by readingMutex_
       Reading reading_;
+      // process data, only accessed by the bus thread
+      ReadingSnapshot readingSnapshot_;
+      // process data published by updateRead
+      SeqLock<ReadingSnapshot> publishedReading_;
       Configuration configuration_;
-      Controlword controlword_;
+      // conversion factors of configuration_, used by the bus thread
+      ConversionTable conversionTable_;
+      // conversionTable_ for the staging threads, written by updateConversionTable
+      SeqLock<ConversionTable> publishedConversionTable_;
+      // controlword of the PDO state machine, written into every RxPdo
+      uint16_t rawControlword_{0};
       PdoInfo pdoInfo_;
+      // PDO state changes: (sequence number << 8) | target drive state, written by requestDriveStateViaPdo
+      std::atomic<uint64_t> requestedDriveStateChange_{0};
+      // (sequence number << 8) | DriveStateChangeStatus, written by the bus thread
+      std::atomic<uint64_t> finishedDriveStateChange_{0};
+      // PDO state machine, only accessed by the bus thread
+      uint64_t activeDriveStateChange_{0};
       bool hasRead_{false};
       bool conductStateChange_{false};
+      bool driveStateChangeTimedOut_{false};
       DriveState targetDriveState_{DriveState::NA};
+      std::chrono::time_point<std::chrono::steady_clock> driveStateChangeStartTimePoint_;
       std::chrono::time_point<std::chrono::steady_clock> driveStateChangeTimePoint_;
+      // start of the confirmation window of the target state in the adaptive mode
+      std::chrono::time_point<std::chrono::steady_clock> targetDriveStateTimePoint_;
+      // drive state when the last controlword was selected
+      DriveState lastControlwordDriveState_{DriveState::NA};
       uint16_t numberOfSuccessfulTargetStateReadings_{0};
-      std::atomic<bool> stateChangeSuccessful_{false};
+
+      // selected by the configured PDO types
+      bool (Elmo::*readTxPdoFunction_)(){&Elmo::readUnsupportedTxPdo};
+      bool (Elmo::*writeRxPdoFunction_)(const RxPdoStandard&){&Elmo::writeUnsupportedRxPdo};
+      ReadTxPdoBytesFunction readTxPdoBytesFunction_{nullptr};
+      WriteRxPdoBytesFunction writeRxPdoBytesFunction_{nullptr};
+      // process image of the bus, if set (see setProcessImage)
+      const uint8_t* processImageInputs_{nullptr};
+      uint8_t* processImageOutputs_{nullptr};
+
+      // reporting from updateRead / updateWrite without formatting in the bus thread
+      RtLogCondition modeOfOperationNotSetLog_{RtLogMessage::ModeOfOperationNotSet};
+      RtLogCondition unsupportedRxPdoTypeLog_{RtLogMessage::UnsupportedRxPdoType};
+      RtLogCondition unsupportedTxPdoTypeLog_{RtLogMessage::UnsupportedTxPdoType};
+      RtLogCondition driveInFaultLog_{RtLogMessage::DriveInFault};
+      RtLogCondition unreachableDriveStateLog_{RtLogMessage::UnreachableDriveState};
+
+      // cycle timing, written by the bus thread
+      CycleHistogram updateReadHistogram_;
+      CycleHistogram updateWriteHistogram_;
+      CycleHistogram readPeriodHistogram_;
+      std::chrono::steady_clock::time_point lastUpdateReadTimePoint_;
+
+      StartupOrchestrator::SharedPtr startupOrchestrator_;
+      // replaces the steady clock in the cyclic path if set (see setCycleClock)
+      const CycleClock* cycleClock_{nullptr};
+      // flight recorder of the PDOs, written by the bus thread
+      PdoRecorder::SharedPtr pdoRecorder_;
+      // per cycle telemetry, the channel is owned by the stream
+      TelemetryStream::SharedPtr telemetryStream_;
+      TelemetryChannel* telemetryChannel_{nullptr};
 
       // actual voltage on 5v line (e.g. to configure analog sensors)
       double actual5vVoltage_{5.0};
 
+      // retries of sdoWriteVerified
+      static constexpr unsigned int sdoMaxNumberOfAttempts_{5};
+      static constexpr unsigned int sdoRetryInitialBackoff_{1000}; // [us]
+
     // Configurable parameters
     protected:
       bool allowModeChange_{false};
+      // only accessed by the staging thread, updateWrite uses the staged value
       ModeOfOperationEnum modeOfOperation_{ModeOfOperationEnum::NA};
 
     protected:
-      mutable std::recursive_mutex stagedCommandMutex_; //TODO required?
-      mutable std::recursive_mutex readingMutex_; //TODO required?
+      mutable std::recursive_mutex readingMutex_; // guards the error / fault history in reading_
       mutable std::recursive_mutex mutex_; // TODO: change name!!!!
 
   };
+
 } // namespace elmo
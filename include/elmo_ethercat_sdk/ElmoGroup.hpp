@@ -0,0 +1,199 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "elmo_ethercat_sdk/Elmo.hpp"
+#include "elmo_ethercat_sdk/SeqLock.hpp"
+
+namespace elmo {
+
+/*!
+ * Commands for all drives of an ElmoGroup in user units (rad, rad/s, Nm).
+ * Structure of arrays: entry i of each array belongs to drive i of the group.
+ */
+struct GroupCommand {
+  std::vector<double> targetPositions;
+  std::vector<double> targetVelocities;
+  std::vector<double> targetTorques;
+  std::vector<double> torqueOffsets;
+
+  /*!
+   * Resize all arrays, new entries are zero.
+   * @param numberOfDrives	the number of drives of the group
+   */
+  void resize(std::size_t numberOfDrives);
+};
+
+/*!
+ * Readings of all drives of an ElmoGroup in user units (rad, rad/s, A, Nm).
+ * Structure of arrays: entry i of each array belongs to drive i of the group.
+ */
+struct GroupReading {
+  std::vector<double> actualPositions;
+  std::vector<double> actualVelocities;
+  std::vector<double> actualCurrents;
+  std::vector<double> actualTorques;
+  std::vector<uint16_t> statuswords;
+  std::vector<DriveState> driveStates;
+
+  /*!
+   * Resize all arrays.
+   * @param numberOfDrives	the number of drives of the group
+   */
+  void resize(std::size_t numberOfDrives);
+};
+
+/*!
+ * @brief	A set of Elmo drives which are commanded and read together
+ * Instead of staging a Command and copying a Reading per drive, the whole
+ * group is handled with one call per cycle. The commands are exchanged with
+ * the bus thread through the lock-free buffers of the drives, which have a
+ * single producer: the commands of a drive are staged by one thread only. The readings of
+ * all drives are published together by the bus thread (updateRead or
+ * publishReadings) once per cycle, no lock is taken.
+ */
+class ElmoGroup {
+ public:
+  typedef std::shared_ptr<ElmoGroup> SharedPtr;
+
+  ElmoGroup() = default;
+  explicit ElmoGroup(const std::vector<Elmo::SharedPtr>& drives);
+
+  /*!
+   * Add a drive, its index in the group is the current size of the group.
+   * @param drive	the drive
+   */
+  void addDrive(const Elmo::SharedPtr& drive);
+
+  std::size_t size() const { return drives_.size(); }
+  const std::vector<Elmo::SharedPtr>& getDrives() const { return drives_; }
+  const Elmo::SharedPtr& getDrive(std::size_t index) const { return drives_[index]; }
+
+  /*!
+   * Configure the drives concurrently during startup: the first call of
+   * Elmo::startup of any drive of the group runs the startup sequences of all
+   * drives of the group. Drives added afterwards are not included.
+   * @param maxNumberOfWorkers	the maximum number of drives configured at the same time, 0 for all drives
+   * @return	the orchestrator, e.g. to query the progress and the results
+   */
+  const StartupOrchestrator::SharedPtr& enableParallelStartup(std::size_t maxNumberOfWorkers = 0);
+
+  /*!
+   * Request a drive state for all drives, the state changes are conducted
+   * concurrently by the bus thread (see Elmo::requestDriveStateViaPdo).
+   * @param[in] driveState	the requested drive state
+   * @param[out] driveStateChanges	the handles of the state changes, sized to the group
+   */
+  void requestDriveStatesViaPdo(const DriveState& driveState, std::vector<DriveStateChangeHandle>& driveStateChanges);
+
+  /*!
+   * Bring all drives to a drive state concurrently, e.g. OperationEnabled.
+   * Waits at most the longest drive_state_change_max_timeout of the drives.
+   * @param[in] driveState	the requested drive state
+   * @param[in] waitForState	wait until all drives reached the state
+   * @return	true if all drives reached the state (always true if not waiting)
+   */
+  bool setDriveStatesViaPdo(const DriveState& driveState, bool waitForState);
+
+  /*!
+   * Convert and stage the commands of all drives.
+   * The commands are always interpreted in user units, independent of the
+   * use_raw_commands configuration of the drives. The conversion is done with
+   * the array kernels of UnitConversion.hpp, the results are identical to
+   * Elmo::stageCommand.
+   * Uses the single producer mailboxes of the drives: must always be called
+   * from the same thread, which must also be the only thread calling
+   * Elmo::stageCommand of the drives of the group (see Elmo::stageCommand).
+   * @param[in] commands	the commands, sized to the group
+   */
+  void stageCommands(const GroupCommand& commands);
+
+  /*!
+   * Call Elmo::updateRead of all drives and publish their readings, called by
+   * the bus thread once per cycle instead of updateRead of the single drives.
+   */
+  void updateRead();
+
+  /*!
+   * Publish the most recent readings of all drives for getReadings, called by
+   * the bus thread after updateRead of all drives, e.g. if the bus calls
+   * updateRead of the drives itself. Does not allocate.
+   * Must not be called from more than one thread at a time.
+   */
+  void publishReadings();
+
+  /*!
+   * Get the readings of all drives of the most recent publishReadings, i.e.
+   * of the same bus cycle (zero before the first publication). The raw values
+   * are converted with the factors published with them.
+   * The arrays are resized if necessary, i.e. no allocation takes place if the
+   * same GroupReading object is reused.
+   * May be called concurrently to stageCommands and publishReadings, but not
+   * from more than one thread at a time.
+   * @param[out] readings	the readings
+   */
+  void getReadings(GroupReading& readings);
+
+ protected:
+  /*!
+   * Per drive factors and raw values, reused between cycles.
+   */
+  struct CommandScratch {
+    std::vector<ConversionTable> conversionTables;
+    std::vector<double> positionFactors;
+    std::vector<double> velocityFactors;
+    std::vector<double> torqueFactors;
+    std::vector<int32_t> rawPositions;
+    std::vector<int32_t> rawVelocities;
+    std::vector<int16_t> rawTorques;
+    std::vector<int16_t> rawTorqueOffsets;
+
+    void resize(std::size_t numberOfDrives);
+  };
+
+  struct ReadingScratch {
+    std::vector<ReadingSnapshot> snapshots;
+    std::vector<double> positionFactors;
+    std::vector<double> velocityFactors;
+    std::vector<double> currentFactors;
+    std::vector<double> torqueFactors;
+    std::vector<int32_t> rawPositions;
+    std::vector<int32_t> rawVelocities;
+    std::vector<int16_t> rawCurrents;
+
+    void resize(std::size_t numberOfDrives);
+  };
+
+  std::vector<Elmo::SharedPtr> drives_;
+  StartupOrchestrator::SharedPtr startupOrchestrator_;
+  CommandScratch commandScratch_;
+  ReadingScratch readingScratch_;
+  // the snapshots of all drives of a cycle, only accessed by the bus thread
+  std::vector<ReadingSnapshot> publishedSnapshots_;
+  SeqLockBuffer<ReadingSnapshot> publishedReadings_;
+};
+
+}  // namespace elmo
@@ -0,0 +1,90 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace elmo {
+
+/*!
+ * Single producer, single consumer mailbox holding the latest value.
+ * Implemented as a triple buffer: the producer and the consumer each own one
+ * buffer and hand over the third one with a single atomic exchange, so neither
+ * side ever waits for the other. Values which are overwritten before the
+ * consumer reads them are dropped.
+ * @tparam T	the type of the value
+ */
+template <typename T>
+class Mailbox {
+ public:
+  Mailbox() = default;
+  explicit Mailbox(const T& value) {
+    for (auto& buffer : buffers_) {
+      buffer = value;
+    }
+  }
+
+  Mailbox(const Mailbox&) = delete;
+  Mailbox& operator=(const Mailbox&) = delete;
+
+  /*!
+   * Publish a new value (producer side).
+   * Must always be called from the same thread, concurrent writes corrupt the
+   * buffer indices.
+   * @param value	the value to publish
+   */
+  void write(const T& value) {
+    buffers_[backIndex_] = value;
+    backIndex_ = middle_.exchange(backIndex_ | freshFlag_, std::memory_order_acq_rel) & indexMask_;
+  }
+
+  /*!
+   * Get the most recent value (consumer side).
+   * The reference stays valid until the next call of read().
+   * @return	the latest published value
+   */
+  const T& read() {
+    if ((middle_.load(std::memory_order_relaxed) & freshFlag_) != 0) {
+      frontIndex_ = middle_.exchange(frontIndex_, std::memory_order_acq_rel) & indexMask_;
+    }
+    return buffers_[frontIndex_];
+  }
+
+ private:
+  static constexpr uint8_t indexMask_{0x3};
+  static constexpr uint8_t freshFlag_{0x4};
+
+  T buffers_[3]{};
+  // index of the buffer in between producer and consumer, plus the fresh flag
+  std::atomic<uint8_t> middle_{1};
+  // owned by the producer
+  uint8_t backIndex_{2};
+  // owned by the consumer
+  uint8_t frontIndex_{0};
+};
+
+template <typename T>
+constexpr uint8_t Mailbox<T>::indexMask_;
+template <typename T>
+constexpr uint8_t Mailbox<T>::freshFlag_;
+
+}  // namespace elmo
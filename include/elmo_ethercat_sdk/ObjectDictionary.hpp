@@ -23,9 +23,15 @@
 
 #define OD_INDEX_RX_PDO_ASSIGNMENT uint16_t(0x1c12)
 #define OD_INDEX_TX_PDO_ASSIGNMENT uint16_t(0x1c13)
+// configurable PDO mapping objects, used by RxPdoCustom / TxPdoCustom
+#define OD_INDEX_RX_PDO_MAPPING_CUSTOM uint16_t(0x1600)
+#define OD_INDEX_TX_PDO_MAPPING_CUSTOM uint16_t(0x1a00)
+// dummy entry (UNSIGNED8) for padding in a PDO mapping
+#define OD_INDEX_DUMMY_UINT8 (0x0005)
 
 #define OD_INDEX_EXTRA_STATUS (0x2085)
 #define OD_INDEX_STO_STATUS (0x2086)
+#define OD_INDEX_ANALOG_INPUT (0x2205)
 #define OD_INDEX_5VDC_SUPPLY (0x2206)
 #define OD_INDEX_TEMPERATURE (0x22A3)
 //#define OD_INDEX_ELMO_COMMAND_TODO                (0x3000)
@@ -0,0 +1,53 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "elmo_ethercat_sdk/PdoTypeEnum.hpp"
+
+namespace elmo {
+
+/*!
+ * The PDO mapping objects assigned to the sync manager of the RxPdos (0x1C12)
+ * or the TxPdos (0x1C13), in the order of the subindices.
+ */
+struct PdoAssignment {
+  uint16_t assignmentIndex{0};
+  std::vector<uint16_t> mappingIndices;
+
+  bool operator==(const PdoAssignment& other) const {
+    return assignmentIndex == other.assignmentIndex && mappingIndices == other.mappingIndices;
+  }
+  bool operator!=(const PdoAssignment& other) const { return !(*this == other); }
+};
+
+/*!
+ * Get the assignment of a PDO type.
+ * @param[in] rxPdoTypeEnum	the PDO type
+ * @param[out] assignment	the assignment
+ * @return	false if the PDO type cannot be mapped
+ */
+bool getPdoAssignment(RxPdoTypeEnum rxPdoTypeEnum, PdoAssignment& assignment);
+bool getPdoAssignment(TxPdoTypeEnum txPdoTypeEnum, PdoAssignment& assignment);
+
+}  // namespace elmo
@@ -0,0 +1,340 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "elmo_ethercat_sdk/PdoLayout.hpp"
+#include "elmo_ethercat_sdk/PdoTypeEnum.hpp"
+#include "elmo_ethercat_sdk/ReadingSnapshot.hpp"
+#include "elmo_ethercat_sdk/RxPdo.hpp"
+#include "elmo_ethercat_sdk/TxPdo.hpp"
+
+namespace elmo {
+
+template <typename Value>
+inline Value loadPdoValue(const uint8_t* data) {
+  Value value;
+  std::memcpy(&value, data, sizeof(Value));
+  return value;
+}
+
+template <typename Value>
+inline void storePdoValue(uint8_t* data, Value value) {
+  std::memcpy(data, &value, sizeof(Value));
+}
+
+/*!
+ * Decoding of a TxPdo entry into the reading snapshot and encoding of a RxPdo
+ * entry from a staged command (see Elmo::stageCommand), where the data points
+ * to the entry. Position, velocity and current / torque readings are
+ * multiplied by the direction, the staged command is already in drive
+ * direction.
+ */
+template <PdoEntry Entry>
+struct PdoEntryCodec;
+
+template <>
+struct PdoEntryCodec<PdoEntry::TargetPosition> {
+  static constexpr std::size_t size{4};
+  static void encode(const RxPdoStandard& command, uint16_t, uint8_t* data) {
+    storePdoValue(data, command.targetPosition_);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::TargetVelocity> {
+  static constexpr std::size_t size{4};
+  static void encode(const RxPdoStandard& command, uint16_t, uint8_t* data) {
+    storePdoValue(data, command.targetVelocity_);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::TargetTorque> {
+  static constexpr std::size_t size{2};
+  static void encode(const RxPdoStandard& command, uint16_t, uint8_t* data) {
+    storePdoValue(data, command.targetTorque_);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::MaxTorque> {
+  static constexpr std::size_t size{2};
+  static void encode(const RxPdoStandard& command, uint16_t, uint8_t* data) {
+    storePdoValue(data, command.maxTorque_);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::Controlword> {
+  static constexpr std::size_t size{2};
+  static void encode(const RxPdoStandard&, uint16_t controlword, uint8_t* data) {
+    storePdoValue(data, controlword);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::ModeOfOperation> {
+  static constexpr std::size_t size{1};
+  static void encode(const RxPdoStandard& command, uint16_t, uint8_t* data) {
+    storePdoValue(data, command.modeOfOperation_);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::TorqueOffset> {
+  static constexpr std::size_t size{2};
+  static void encode(const RxPdoStandard& command, uint16_t, uint8_t* data) {
+    storePdoValue(data, command.torqueOffset_);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::ActualPosition> {
+  static constexpr std::size_t size{4};
+  static void decode(const uint8_t* data, int direction, ReadingSnapshot& snapshot) {
+    snapshot.setActualPosition(loadPdoValue<int32_t>(data) * direction);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::DigitalInputs> {
+  static constexpr std::size_t size{4};
+  static void decode(const uint8_t* data, int, ReadingSnapshot& snapshot) {
+    snapshot.setDigitalInputs(loadPdoValue<uint32_t>(data));
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::ActualVelocity> {
+  static constexpr std::size_t size{4};
+  static void decode(const uint8_t* data, int direction, ReadingSnapshot& snapshot) {
+    snapshot.setActualVelocity(loadPdoValue<int32_t>(data) * direction);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::Statusword> {
+  static constexpr std::size_t size{2};
+  static void decode(const uint8_t* data, int, ReadingSnapshot& snapshot) {
+    snapshot.setStatusword(loadPdoValue<uint16_t>(data));
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::AnalogInput> {
+  static constexpr std::size_t size{2};
+  static void decode(const uint8_t* data, int, ReadingSnapshot& snapshot) {
+    snapshot.setAnalogInput(loadPdoValue<int16_t>(data));
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::ActualCurrent> {
+  static constexpr std::size_t size{2};
+  static void decode(const uint8_t* data, int direction, ReadingSnapshot& snapshot) {
+    snapshot.setActualCurrent(loadPdoValue<int16_t>(data) * direction);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::ActualTorque> {
+  static constexpr std::size_t size{2};
+  static void decode(const uint8_t* data, int direction, ReadingSnapshot& snapshot) {
+    // torque readings are actually current readings, the conversion is handled later
+    snapshot.setActualCurrent(loadPdoValue<int16_t>(data) * direction);
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::BusVoltage> {
+  static constexpr std::size_t size{4};
+  static void decode(const uint8_t* data, int, ReadingSnapshot& snapshot) {
+    snapshot.setBusVoltage(loadPdoValue<uint32_t>(data));
+  }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::Padding> {
+  static constexpr std::size_t size{1};
+  static void decode(const uint8_t*, int, ReadingSnapshot&) {}
+  static void encode(const RxPdoStandard&, uint16_t, uint8_t* data) { *data = 0; }
+};
+
+template <>
+struct PdoEntryCodec<PdoEntry::ModeOfOperationDisplay> {
+  static constexpr std::size_t size{1};
+  static void decode(const uint8_t*, int, ReadingSnapshot&) {}
+};
+
+/*!
+ * Compile-time descriptor of a field of a PDO struct.
+ */
+template <PdoEntry Entry, std::size_t Offset>
+struct PdoField {
+  static constexpr PdoEntry entry{Entry};
+  static constexpr std::size_t offset{Offset};
+};
+
+/*!
+ * @return true if the fields cover the whole PDO without gaps or overlaps
+ */
+template <typename... Fields>
+constexpr bool pdoFieldsCoverPdo(std::size_t pdoSize) {
+  const std::size_t offsets[] = {Fields::offset...};
+  const std::size_t sizes[] = {PdoEntryCodec<Fields::entry>::size...};
+  std::size_t end = 0;
+  for (std::size_t i = 0; i < sizeof...(Fields); i++) {
+    if (offsets[i] != end) {
+      return false;
+    }
+    end += sizes[i];
+  }
+  return end == pdoSize;
+}
+
+/*!
+ * Decoding / encoding of a PDO struct, expanded into one copy per field.
+ * The data overloads work on sizeof(Pdo) bytes in the layout of the struct,
+ * e.g. directly in the process image of the bus.
+ */
+template <typename Pdo, typename... Fields>
+struct PdoFieldCodec {
+  static_assert(pdoFieldsCoverPdo<Fields...>(sizeof(Pdo)), "The PDO fields do not match the PDO struct.");
+
+  static constexpr std::size_t size{sizeof(Pdo)};
+
+  static void decode(const uint8_t* data, int direction, ReadingSnapshot& snapshot) {
+    const int expansion[] = {
+        0, (PdoEntryCodec<Fields::entry>::decode(data + Fields::offset, direction, snapshot), 0)...};
+    static_cast<void>(expansion);
+  }
+
+  static void decode(const Pdo& pdo, int direction, ReadingSnapshot& snapshot) {
+    decode(reinterpret_cast<const uint8_t*>(&pdo), direction, snapshot);
+  }
+
+  static void encode(const RxPdoStandard& command, uint16_t controlword, uint8_t* data) {
+    const int expansion[] = {
+        0, (PdoEntryCodec<Fields::entry>::encode(command, controlword, data + Fields::offset), 0)...};
+    static_cast<void>(expansion);
+  }
+
+  static void encode(const RxPdoStandard& command, uint16_t controlword, Pdo& pdo) {
+    encode(command, controlword, reinterpret_cast<uint8_t*>(&pdo));
+  }
+
+  /*!
+   * The layout of the PDO struct, e.g. to decode recorded PDOs offline.
+   * The fields cover the PDO without gaps, such that the packed offsets of the
+   * layout match the struct.
+   */
+  static PdoLayout getLayout() {
+    PdoLayout layout;
+    const int expansion[] = {0, (layout.addEntry(Fields::entry), 0)...};
+    static_cast<void>(expansion);
+    return layout;
+  }
+};
+
+/*!
+ * The codec of a PDO type. Adding a PDO type only requires its struct and a
+ * specialization listing the fields.
+ */
+template <typename Pdo>
+struct PdoCodec;
+
+template <>
+struct PdoCodec<RxPdoStandard>
+    : PdoFieldCodec<RxPdoStandard,
+                    PdoField<PdoEntry::TargetPosition, offsetof(RxPdoStandard, targetPosition_)>,
+                    PdoField<PdoEntry::TargetVelocity, offsetof(RxPdoStandard, targetVelocity_)>,
+                    PdoField<PdoEntry::TargetTorque, offsetof(RxPdoStandard, targetTorque_)>,
+                    PdoField<PdoEntry::MaxTorque, offsetof(RxPdoStandard, maxTorque_)>,
+                    PdoField<PdoEntry::Controlword, offsetof(RxPdoStandard, controlWord_)>,
+                    PdoField<PdoEntry::ModeOfOperation, offsetof(RxPdoStandard, modeOfOperation_)>,
+                    PdoField<PdoEntry::Padding, offsetof(RxPdoStandard, padding_)>,
+                    PdoField<PdoEntry::TorqueOffset, offsetof(RxPdoStandard, torqueOffset_)>> {};
+
+template <>
+struct PdoCodec<RxPdoCST>
+    : PdoFieldCodec<RxPdoCST,
+                    PdoField<PdoEntry::TargetTorque, offsetof(RxPdoCST, targetTorque_)>,
+                    PdoField<PdoEntry::Controlword, offsetof(RxPdoCST, controlWord_)>,
+                    PdoField<PdoEntry::ModeOfOperation, offsetof(RxPdoCST, modeOfOperation_)>,
+                    PdoField<PdoEntry::Padding, offsetof(RxPdoCST, padding_)>> {};
+
+template <>
+struct PdoCodec<TxPdoStandard>
+    : PdoFieldCodec<TxPdoStandard,
+                    PdoField<PdoEntry::ActualPosition, offsetof(TxPdoStandard, actualPosition_)>,
+                    PdoField<PdoEntry::DigitalInputs, offsetof(TxPdoStandard, digitalInputs_)>,
+                    PdoField<PdoEntry::ActualVelocity, offsetof(TxPdoStandard, actualVelocity_)>,
+                    PdoField<PdoEntry::Statusword, offsetof(TxPdoStandard, statusword_)>,
+                    PdoField<PdoEntry::AnalogInput, offsetof(TxPdoStandard, analogInput_)>,
+                    PdoField<PdoEntry::ActualCurrent, offsetof(TxPdoStandard, actualCurrent_)>,
+                    PdoField<PdoEntry::BusVoltage, offsetof(TxPdoStandard, busVoltage_)>> {};
+
+template <>
+struct PdoCodec<TxPdoCST>
+    : PdoFieldCodec<TxPdoCST,
+                    PdoField<PdoEntry::ActualPosition, offsetof(TxPdoCST, actualPosition_)>,
+                    PdoField<PdoEntry::ActualTorque, offsetof(TxPdoCST, actualTorque_)>,
+                    PdoField<PdoEntry::Statusword, offsetof(TxPdoCST, statusword_)>,
+                    PdoField<PdoEntry::ModeOfOperationDisplay, offsetof(TxPdoCST, modeOfOperationDisplay_)>,
+                    PdoField<PdoEntry::Padding, offsetof(TxPdoCST, padding_)>,
+                    PdoField<PdoEntry::ActualVelocity, offsetof(TxPdoCST, actualVelocity_)>> {};
+
+/*!
+ * The layout of a PDO type, described by the fields of its struct.
+ * @param customLayout	the layout of the custom type
+ * @return	an empty layout if the type is not supported
+ */
+inline PdoLayout getRxPdoLayout(RxPdoTypeEnum rxPdoType, const PdoLayout& customLayout) {
+  switch (rxPdoType) {
+    case RxPdoTypeEnum::RxPdoStandard:
+      return PdoCodec<RxPdoStandard>::getLayout();
+    case RxPdoTypeEnum::RxPdoCST:
+      return PdoCodec<RxPdoCST>::getLayout();
+    case RxPdoTypeEnum::RxPdoCustom:
+      return customLayout;
+    default:
+      return PdoLayout();
+  }
+}
+
+inline PdoLayout getTxPdoLayout(TxPdoTypeEnum txPdoType, const PdoLayout& customLayout) {
+  switch (txPdoType) {
+    case TxPdoTypeEnum::TxPdoStandard:
+      return PdoCodec<TxPdoStandard>::getLayout();
+    case TxPdoTypeEnum::TxPdoCST:
+      return PdoCodec<TxPdoCST>::getLayout();
+    case TxPdoTypeEnum::TxPdoCustom:
+      return customLayout;
+    default:
+      return PdoLayout();
+  }
+}
+
+}  // namespace elmo
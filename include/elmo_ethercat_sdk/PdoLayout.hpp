@@ -0,0 +1,149 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "elmo_ethercat_sdk/RxPdo.hpp"
+
+namespace elmo {
+
+// ReadingSnapshot depends on the Configuration, which contains the PDO layouts
+class ReadingSnapshot;
+
+/*!
+ * Object dictionary entries which can be mapped into a custom PDO
+ * (RxPdoCustom / TxPdoCustom).
+ */
+enum class PdoEntry : uint8_t {
+  // RxPdo entries
+  TargetPosition,
+  TargetVelocity,
+  TargetTorque,
+  MaxTorque,
+  Controlword,
+  ModeOfOperation,
+  TorqueOffset,
+  // TxPdo entries
+  ActualPosition,
+  DigitalInputs,
+  ActualVelocity,
+  Statusword,
+  AnalogInput,
+  ActualCurrent,
+  ActualTorque,
+  BusVoltage,
+  // one byte of dummy data, e.g. to keep the following entries aligned
+  Padding,
+  // not part of the reading
+  ModeOfOperationDisplay
+};
+
+/*!
+ * Description of a PDO entry in the object dictionary.
+ */
+struct PdoEntryDescription {
+  PdoEntry entry;
+  // name of the entry in the configuration file
+  const char* name;
+  uint16_t index;
+  uint8_t subindex;
+  // [bytes]
+  uint8_t size;
+  bool isRxPdoEntry;
+  bool isTxPdoEntry;
+};
+
+/*!
+ * @brief	Layout of a custom PDO.
+ * The entries are packed in the order in which they are added. The offset
+ * table is generated once, such that the process data can be decoded into a
+ * ReadingSnapshot (TxPdo) or encoded from a staged command (RxPdo) without
+ * a fixed PDO struct.
+ */
+class PdoLayout {
+ public:
+  struct MappedEntry {
+    PdoEntry entry;
+    // [bytes] from the start of the PDO
+    uint16_t offset;
+    // [bytes]
+    uint8_t size;
+  };
+
+  // maximum size of a custom PDO [bytes]
+  static constexpr std::size_t maxSize{32};
+  // maximum number of entries of a PDO mapping object
+  static constexpr std::size_t maxNumberOfEntries{8};
+
+  static const PdoEntryDescription& getEntryDescription(PdoEntry entry);
+  /*!
+   * Look up an entry by its name in the configuration file.
+   * @return false if there is no entry with this name
+   */
+  static bool getEntryFromName(const std::string& name, PdoEntry& entry);
+
+  void addEntry(PdoEntry entry);
+  void clear();
+
+  bool empty() const { return entries_.empty(); }
+  bool contains(PdoEntry entry) const;
+  // all entries can be mapped into a RxPdo / TxPdo
+  bool isRxPdoLayout() const;
+  bool isTxPdoLayout() const;
+  // [bytes]
+  uint16_t getSize() const { return size_; }
+  const std::vector<MappedEntry>& getEntries() const { return entries_; }
+
+  /*!
+   * The subindices of the PDO mapping object (0x1600 / 0x1A00):
+   * index << 16 | subindex << 8 | bit length
+   */
+  std::vector<uint32_t> getMappingEntries() const;
+
+  /*!
+   * Decode a TxPdo of getSize() bytes into the snapshot.
+   * Position, velocity and current / torque are multiplied by the direction.
+   * actual_torque is stored as current like in TxPdoCST.
+   */
+  void decodeTxPdo(const uint8_t* data, int direction, ReadingSnapshot& snapshot) const;
+  /*!
+   * Encode a RxPdo of getSize() bytes from a staged command.
+   * The controlword of the command is ignored.
+   */
+  void encodeRxPdo(const RxPdoStandard& command, uint16_t controlword, uint8_t* data) const;
+
+  bool operator==(const PdoLayout& other) const;
+  bool operator!=(const PdoLayout& other) const { return !(*this == other); }
+
+ private:
+  std::vector<MappedEntry> entries_;
+  uint16_t size_{0};
+};
+
+}  // namespace elmo
+
+// stream operator in global namespace
+std::ostream& operator<<(std::ostream& os, const elmo::PdoLayout& pdoLayout);
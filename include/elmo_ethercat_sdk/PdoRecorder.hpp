@@ -0,0 +1,171 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "elmo_ethercat_sdk/PdoLayout.hpp"
+#include "elmo_ethercat_sdk/PdoTypeEnum.hpp"
+
+namespace elmo {
+
+/*!
+ * One PDO in the ring file of a PdoRecorder.
+ */
+struct PdoRecord {
+  enum class Type : uint8_t { RxPdo, TxPdo };
+
+  // starts at 1, 0 while the record is written
+  uint64_t sequenceNumber;
+  // [ns] of std::chrono::steady_clock
+  int64_t timestamp;
+  Type type;
+  // [bytes] of data
+  uint8_t size;
+  uint8_t reserved[6];
+  // the raw PDO as exchanged with the bus
+  uint8_t data[PdoLayout::maxSize];
+};
+
+/*!
+ * Start of the ring file, followed by the records at PdoRecordFileHeader::size.
+ */
+struct PdoRecordFileHeader {
+  static constexpr char magic[8]{'E', 'L', 'M', 'O', 'P', 'D', 'O', 'R'};
+  static constexpr uint32_t currentVersion{1};
+  // [bytes], offset of the first record
+  static constexpr std::size_t size{256};
+  // maximum number of entries of a described PDO
+  static constexpr std::size_t maxNumberOfEntries{16};
+
+  char fileMagic[8];
+  uint32_t version;
+  // [bytes] of a PdoRecord
+  uint32_t recordSize;
+  // number of records of the ring
+  uint64_t capacity;
+  // number of records written since the file was opened
+  uint64_t numberOfRecords;
+  // [ns] of the steady and the system clock when the file was opened, to
+  // convert the timestamps of the records to wall time
+  int64_t steadyTimeAtOpen;
+  int64_t systemTimeAtOpen;
+  // name of the drive, zero terminated
+  char name[32];
+  // the PDO types and their layouts (PdoEntry), set by the drive
+  int8_t rxPdoType;
+  int8_t txPdoType;
+  uint8_t rxPdoNumberOfEntries;
+  uint8_t txPdoNumberOfEntries;
+  uint8_t rxPdoEntries[maxNumberOfEntries];
+  uint8_t txPdoEntries[maxNumberOfEntries];
+};
+
+/*!
+ * @brief	Flight recorder of the raw PDOs of a drive
+ * The PDOs exchanged by updateWrite / updateRead are appended to a ring of
+ * fixed size records in a memory-mapped file (see Elmo::setPdoRecorder).
+ * The file is preallocated and its pages are touched when it is opened, such
+ * that recording neither allocates nor calls into the kernel. The mapping is
+ * shared, the records written until a crash of the process remain in the file.
+ * A record is only written by the bus thread of its drive.
+ */
+class PdoRecorder {
+ public:
+  typedef std::shared_ptr<PdoRecorder> SharedPtr;
+
+  PdoRecorder() = default;
+  ~PdoRecorder();
+  PdoRecorder(const PdoRecorder&) = delete;
+  PdoRecorder& operator=(const PdoRecorder&) = delete;
+
+  /*!
+   * Create (or overwrite) and map the ring file.
+   * @param fileName	the file, e.g. one per drive and session
+   * @param capacity	the number of records, e.g. 2 per cycle times the cycles to keep
+   * @return	false if the file cannot be created or mapped
+   */
+  bool open(const std::string& fileName, std::size_t capacity);
+  // unmap the file, the records are kept
+  void close();
+  bool isOpen() const { return header_ != nullptr; }
+
+  /*!
+   * Describe the recorded PDOs in the file header, called by the drive.
+   */
+  void setPdos(const std::string& name, RxPdoTypeEnum rxPdoType, const PdoLayout& rxPdoLayout,
+               TxPdoTypeEnum txPdoType, const PdoLayout& txPdoLayout);
+
+  /*!
+   * Append a PDO, overwriting the oldest record if the ring is full.
+   * @param size	[bytes], PDOs larger than PdoLayout::maxSize are truncated
+   */
+  void record(PdoRecord::Type type, const uint8_t* data, std::size_t size);
+
+ protected:
+  PdoRecordFileHeader* header_{nullptr};
+  PdoRecord* records_{nullptr};
+  std::size_t capacity_{0};
+  // [bytes] of the mapping
+  std::size_t mappingSize_{0};
+  // number of records written, only accessed by the bus thread
+  uint64_t numberOfRecords_{0};
+};
+
+/*!
+ * @brief	Offline reader of the ring file of a PdoRecorder
+ * Also reads the file of a crashed process, records which were being
+ * written at the time of the crash are skipped.
+ */
+class PdoRecordReader {
+ public:
+  /*!
+   * Read the whole file.
+   * @return	false if the file cannot be read or is not a PDO record file
+   */
+  bool open(const std::string& fileName);
+
+  const PdoRecordFileHeader& getHeader() const { return header_; }
+  // the valid records, oldest first
+  const std::vector<PdoRecord>& getRecords() const { return records_; }
+  const PdoLayout& getRxPdoLayout() const { return rxPdoLayout_; }
+  const PdoLayout& getTxPdoLayout() const { return txPdoLayout_; }
+  // [s] since the epoch
+  double getWallTime(const PdoRecord& record) const;
+
+  /*!
+   * Print the entries of a record, decoded with the layout of its type.
+   */
+  void printRecord(std::ostream& os, const PdoRecord& record) const;
+
+ protected:
+  PdoRecordFileHeader header_{};
+  std::vector<PdoRecord> records_;
+  PdoLayout rxPdoLayout_;
+  PdoLayout txPdoLayout_;
+};
+
+}  // namespace elmo
@@ -0,0 +1,132 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <soem_interface/EthercatBusBase.hpp>
+
+#include "elmo_ethercat_sdk/CycleTiming.hpp"
+#include "elmo_ethercat_sdk/PdoRecorder.hpp"
+
+namespace elmo {
+
+class Elmo;
+
+/*!
+ * Outcome of PdoReplay::run.
+ */
+struct PdoReplayResult {
+  // number of replayed TxPdos / RxPdos
+  uint64_t numberOfTxPdos{0};
+  uint64_t numberOfRxPdos{0};
+  // number of RxPdos which differ from the recording
+  uint64_t numberOfMismatches{0};
+  // sequence number of the record of the first differing RxPdo, 0 if there is none
+  uint64_t firstMismatch{0};
+  // time span of the recording and duration of the replay
+  std::chrono::nanoseconds recordedDuration{0};
+  std::chrono::nanoseconds replayDuration{0};
+
+  bool succeeded() const { return numberOfRxPdos > 0 && numberOfMismatches == 0; }
+};
+
+/*!
+ * @brief	Deterministic replay of a PDO recording (see PdoRecorder)
+ * Acts as the bus of a single drive: the recorded TxPdos are fed into
+ * Elmo::updateRead and the RxPdos produced by Elmo::updateWrite are compared
+ * with the recorded ones, as fast as possible. The time of the cyclic path of
+ * the drive is the recorded time of the PDOs (see Elmo::setCycleClock), such
+ * that the state machine behaves like in the recorded session.
+ * The commands and state change requests are not recorded, they are repeated
+ * by a controller which is called before every updateWrite, e.g. the
+ * controller under test. The replay should start at the beginning of the
+ * recorded session, the ring of the recorder must not have wrapped around.
+ */
+class PdoReplay : public soem_interface::EthercatBusBase {
+ public:
+  /*!
+   * Called before every updateWrite.
+   * @param elmo	the replayed drive, with the reading of the previous TxPdo
+   * @param cycle	the number of the RxPdo, starting at 0
+   */
+  using Controller = std::function<void(Elmo& elmo, uint64_t cycle)>;
+
+  explicit PdoReplay(const std::string& name = "pdo_replay");
+
+  /*!
+   * Load a recording.
+   * @return	false if the file cannot be read
+   */
+  bool open(const std::string& fileName);
+  const PdoRecordReader& getRecording() const { return recording_; }
+
+  /*!
+   * Connect a drive which has loaded its configuration: sets the bus and the
+   * cycle clock of the drive. The replay must outlive the drive.
+   * @return	false if the PDO types / layouts differ from the recording
+   */
+  bool attach(Elmo& elmo);
+
+  /*!
+   * Replay all records.
+   * @param controller	stages the commands and requests the state changes of the session
+   * @param maxNumberOfReportedMismatches	the first differing RxPdos are printed
+   */
+  PdoReplayResult run(const Controller& controller, std::size_t maxNumberOfReportedMismatches = 10);
+
+  /*!
+   * The process image of the drive (see Elmo::setProcessImage), sized by the recording.
+   */
+  uint8_t* getOutputs() { return outputs_.data(); }
+  const uint8_t* getInputs() const { return inputs_.data(); }
+
+ protected:
+  class RecordedClock : public CycleClock {
+   public:
+    std::chrono::steady_clock::time_point now() const override { return timePoint_; }
+    void setTime(int64_t timestamp) {
+      timePoint_ = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timestamp));
+    }
+
+   private:
+    std::chrono::steady_clock::time_point timePoint_;
+  };
+
+  void reportMismatch(const PdoRecord& record) const;
+
+  PdoRecordReader recording_;
+  RecordedClock clock_;
+  Elmo* elmo_{nullptr};
+  std::vector<uint8_t> outputs_;
+  std::vector<uint8_t> inputs_;
+};
+
+}  // namespace elmo
+
+// stream operator in global namespace
+std::ostream& operator<<(std::ostream& os, const elmo::PdoReplayResult& result);
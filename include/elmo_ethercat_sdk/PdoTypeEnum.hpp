@@ -26,10 +26,11 @@
 namespace elmo {
 
 // different RxPdo Types
-enum class RxPdoTypeEnum : int8_t { NA = 0, RxPdoStandard, RxPdoCST };
+// (RxPdoCustom / TxPdoCustom: layout declared in the configuration, see PdoLayout)
+enum class RxPdoTypeEnum : int8_t { NA = 0, RxPdoStandard, RxPdoCST, RxPdoCustom };
 
 // different TxPdo Types
-enum class TxPdoTypeEnum : int8_t { NA = -128, TxPdoStandard, TxPdoCST };
+enum class TxPdoTypeEnum : int8_t { NA = -128, TxPdoStandard, TxPdoCST, TxPdoCustom };
 
 }  // namespace elmo
 
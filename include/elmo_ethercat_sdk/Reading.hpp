@@ -29,17 +29,10 @@
 
 #include "elmo_ethercat_sdk/Configuration.hpp"
 #include "elmo_ethercat_sdk/Error.hpp"
-#include "elmo_ethercat_sdk/DriveState.hpp"
-#include "elmo_ethercat_sdk/Statusword.hpp"
+#include "elmo_ethercat_sdk/ReadingSnapshot.hpp"
+#include "elmo_ethercat_sdk/RingBuffer.hpp"
 
 namespace elmo {
-/*!
- * aliases for time_points, durations and clocks
- */
-using ReadingClock = std::chrono::steady_clock;
-using ReadingDuration = std::chrono::duration<double, std::milli>;
-using ReadingTimePoint = std::chrono::time_point<ReadingClock>;
-
 /*!
  * An alias for a pair of ErrorType and time point
  */
@@ -48,80 +41,7 @@ using FaultPair = std::pair<uint16_t, ReadingTimePoint>;
 using ErrorTimePairDeque = std::deque<std::pair<ErrorType, double>>;
 using FaultTimePairDeque = std::deque<std::pair<uint16_t, double>>;
 
-class Reading{
- public:
-  /*!
-   * raw get methods
-   */
-  int32_t getActualPositionRaw() const;
-  int32_t getActualVelocityRaw() const;
-  uint16_t getRawStatusword() const;
-  int16_t getActualCurrentRaw() const;
-  uint16_t getAnalogInputRaw() const;
-  uint32_t getBusVoltageRaw() const;
-
-  /*!
-   * User units get methods
-   */
-  double getActualPosition() const;
-  double getActualVelocity() const;
-  double getActualCurrent() const;
-  double getActualTorque() const;
-  double getAnalogInput() const;
-  double getAgeOfLastReadingInMicroseconds() const;
-  double getBusVoltage() const;
-
-  /*!
-   * Other get methods
-   */
-  int32_t getDigitalInputs() const;
-  Statusword getStatusword() const;
-  std::string getDigitalInputString() const;
-  DriveState getDriveState() const;
-
-  /*!
-   * set methods (only raw)
-   */
-  void setActualPosition(int32_t actualPosition);
-
-  void setDigitalInputs(int32_t digitalInputs);
-
-  void setActualVelocity(int32_t actualVelocity);
-
-  void setStatusword(uint16_t statusword);
-
-  void setAnalogInput(int16_t analogInput);
-
-  void setActualCurrent(int16_t actualCurrent);
-
-  void setBusVoltage(uint32_t busVoltage);
-
-  void setTimePointNow();
-
-  void setPositionFactorIntegerToRad(double positionFactor);
-
-  void setVelocityFactorIntegerPerSecToRadPerSec(double velocityFactor);
-
-  void setCurrentFactorIntegerToAmp(double currentFactor);
-
-  void setTorqueFactorIntegerToNm(double torqueFactor);
-
-
- protected:
-  int32_t actualPosition_{0};
-  int32_t digitalInputs_{0};
-  int32_t actualVelocity_{0};
-  uint16_t statusword_{0};
-  int16_t analogInput_{0};
-  int16_t actualCurrent_{0};
-  uint32_t busVoltage_{0};
-
-  double positionFactorIntegerToRad_{1};
-  double velocityFactorIntegerPerSecToRadPerSec_{1};
-  double currentFactorIntegerToAmp_{1};
-  double torqueFactorIntegerToNm_{1};
-
-  ReadingTimePoint lastReadingTimePoint_;
+class Reading : public ReadingSnapshot {
  public:
   /*!
    * returns the age of the last added error in microseconds
@@ -136,16 +56,31 @@ class Reading{
 
   /*!
    * get all stored errors and their age in microseconds
+   * Allocates a new deque, use getErrorHistory() in the control loop.
    *
    * @return	deque of all stored errors
    */
   ErrorTimePairDeque getErrors() const;
   /*!
    * get all stored faults and ther age in microseconds
+   * Allocates a new deque, use getFaultHistory() in the control loop.
    * @return	deque of all stored faults
    */
   FaultTimePairDeque getFaults() const;
 
+  /*!
+   * get all stored errors (newest first) without copying them
+   * The errors are marked as read.
+   * @return	the error history with the time points of the errors
+   */
+  const RingBuffer<ErrorPair>& getErrorHistory() const;
+  /*!
+   * get all stored faults (newest first) without copying them
+   * The faults are marked as read.
+   * @return	the fault history with the time points of the faults
+   */
+  const RingBuffer<FaultPair>& getFaultHistory() const;
+
   /*!
    * Returns the last Error that occured
    * @return	The error type of tha last error
@@ -190,6 +125,15 @@ class Reading{
    */
   void configureReading(const Configuration& configuration);
 
+  /*!
+   * @brief	Load parameters from Configuration object, using already computed
+   * conversion factors
+   * @param[in] configuration	The Configuration with the requested
+   * configuration parameters
+   * @param[in] conversionTable	The conversion factors computed from configuration
+   */
+  void configureReading(const Configuration& configuration, const ConversionTable& conversionTable);
+
   /*!
    * The configuration constructor
    * This is called for readings generated inside of the elmo_ethercat_sdk.
@@ -203,8 +147,9 @@ class Reading{
   Reading(unsigned int errorStorageCapacity, unsigned int faultStorageCapacity, bool forceAppendEqualError, bool forceAppendEqualFault);
 
  private:
-  std::deque<ErrorPair> errors_;
-  std::deque<FaultPair> faults_;
+  // newest first, the capacities are the storage capacities of the configuration
+  RingBuffer<ErrorPair> errors_{25};
+  RingBuffer<FaultPair> faults_{25};
 
   ErrorPair lastError_;
   FaultPair lastFault_;
@@ -215,8 +160,6 @@ class Reading{
   /*!
    * paramaters changeable with a Configuration object
    */
-  unsigned int errorStorageCapacity_{25};
-  unsigned int faultStorageCapacity_{25};
   bool forceAppendEqualError_{false};
   bool forceAppendEqualFault_{false};
 };
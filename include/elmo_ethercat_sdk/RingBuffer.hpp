@@ -0,0 +1,138 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace elmo {
+
+/*!
+ * @brief	Fixed capacity circular buffer
+ * The storage is allocated by the constructor / setCapacity only. When the
+ * buffer is full, pushing a new element overwrites the oldest one.
+ * Index 0 is the newest element, iteration goes from the newest to the oldest
+ * element.
+ * Copy assignment does not allocate if the capacity of the target is at
+ * least the capacity of the source.
+ */
+template <typename T>
+class RingBuffer {
+ public:
+  class ConstIterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    ConstIterator(const RingBuffer* ringBuffer, std::size_t index) : ringBuffer_(ringBuffer), index_(index) {}
+
+    reference operator*() const { return (*ringBuffer_)[index_]; }
+    pointer operator->() const { return &(*ringBuffer_)[index_]; }
+    ConstIterator& operator++() {
+      index_++;
+      return *this;
+    }
+    ConstIterator operator++(int) {
+      ConstIterator iterator = *this;
+      index_++;
+      return iterator;
+    }
+    bool operator==(const ConstIterator& other) const {
+      return ringBuffer_ == other.ringBuffer_ && index_ == other.index_;
+    }
+    bool operator!=(const ConstIterator& other) const { return !(*this == other); }
+
+   private:
+    const RingBuffer* ringBuffer_;
+    std::size_t index_;
+  };
+
+  RingBuffer() = default;
+  explicit RingBuffer(std::size_t capacity) : buffer_(capacity) {}
+
+  /*!
+   * Change the capacity, the newest elements are kept.
+   * @param capacity	the new capacity
+   */
+  void setCapacity(std::size_t capacity) {
+    if (capacity == buffer_.size()) {
+      return;
+    }
+    std::vector<T> buffer(capacity);
+    const std::size_t size = size_ < capacity ? size_ : capacity;
+    for (std::size_t i = 0; i < size; i++) {
+      buffer[size - 1 - i] = (*this)[i];
+    }
+    buffer_.swap(buffer);
+    newest_ = size > 0 ? size - 1 : 0;
+    size_ = size;
+  }
+
+  std::size_t capacity() const { return buffer_.size(); }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == buffer_.size(); }
+
+  void clear() { size_ = 0; }
+
+  /*!
+   * Add a new element, overwriting the oldest one if the buffer is full.
+   * Does nothing if the capacity is zero.
+   * @param value	the element
+   */
+  void pushFront(const T& value) {
+    if (buffer_.empty()) {
+      return;
+    }
+    newest_ = (newest_ + 1) % buffer_.size();
+    buffer_[newest_] = value;
+    if (size_ < buffer_.size()) {
+      size_++;
+    }
+  }
+
+  /*!
+   * The newest element, the buffer must not be empty.
+   */
+  T& front() { return buffer_[newest_]; }
+  const T& front() const { return buffer_[newest_]; }
+
+  /*!
+   * @param index	0 for the newest element, size() - 1 for the oldest one
+   */
+  const T& operator[](std::size_t index) const {
+    return buffer_[(newest_ + buffer_.size() - index) % buffer_.size()];
+  }
+
+  ConstIterator begin() const { return ConstIterator(this, 0); }
+  ConstIterator end() const { return ConstIterator(this, size_); }
+
+ private:
+  std::vector<T> buffer_;
+  std::size_t newest_{0};
+  std::size_t size_{0};
+};
+
+}  // namespace elmo
@@ -0,0 +1,145 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+namespace elmo {
+
+/*!
+ * Messages which are reported from the bus thread.
+ */
+enum class RtLogMessage : uint8_t {
+  ModeOfOperationNotSet,
+  UnsupportedRxPdoType,
+  UnsupportedTxPdoType,
+  DriveInFault,
+  UnreachableDriveState
+};
+
+/*!
+ * Raised: the condition became active.
+ * Repeated: the condition is still active (rate limited).
+ * Cleared: the condition is not active anymore.
+ */
+enum class RtLogEvent : uint8_t { Raised, Repeated, Cleared };
+
+/*!
+ * Fixed size log record, copied into the ring without allocation.
+ */
+struct RtLogRecord {
+  RtLogMessage message{RtLogMessage::DriveInFault};
+  RtLogEvent event{RtLogEvent::Raised};
+  // Raised: 1, Repeated: occurrences since the last record, Cleared: occurrences in total
+  uint32_t count{0};
+  // message specific value, e.g. the configured pdo type
+  int32_t value{0};
+  // truncated device name
+  char deviceName[32]{};
+};
+
+/*!
+ * @brief	Process wide log ring for the real-time threads
+ * Bounded multi producer, single consumer queue of RtLogRecords (lock-free,
+ * preallocated). A background thread formats the records with message_logger.
+ * If the ring is full, records are dropped and counted.
+ */
+class RtLog {
+ public:
+  static RtLog& instance();
+
+  RtLog(const RtLog&) = delete;
+  RtLog& operator=(const RtLog&) = delete;
+  ~RtLog();
+
+  /*!
+   * Add a record, can be called from any thread.
+   * @return	false if the ring is full and the record was dropped
+   */
+  bool push(const RtLogRecord& record);
+
+  uint64_t getNumberOfDroppedRecords() const { return numberOfDroppedRecords_.load(std::memory_order_relaxed); }
+
+ protected:
+  RtLog();
+
+  bool pop(RtLogRecord& record);
+  void print(const RtLogRecord& record) const;
+  void work();
+
+  static constexpr std::size_t capacity_{256};
+
+  struct Cell {
+    std::atomic<std::size_t> sequence{0};
+    RtLogRecord record;
+  };
+
+  std::array<Cell, capacity_> cells_;
+  std::atomic<std::size_t> enqueuePosition_{0};
+  // only accessed by the worker thread
+  std::size_t dequeuePosition_{0};
+  std::atomic<uint64_t> numberOfDroppedRecords_{0};
+  uint64_t numberOfReportedDroppedRecords_{0};
+
+  std::atomic<bool> running_{true};
+  std::thread worker_;
+};
+
+/*!
+ * @brief	Edge triggered and rate limited reporting of a condition
+ * update() is called every cycle with the state of the condition. A record is
+ * pushed to the RtLog when the condition is raised, at most once per repeat
+ * interval while it stays active, and when it is cleared.
+ * Must only be used by one thread.
+ */
+class RtLogCondition {
+ public:
+  explicit RtLogCondition(RtLogMessage message,
+                          std::chrono::steady_clock::duration repeatInterval = std::chrono::seconds(1));
+
+  /*!
+   * @param active	true if the condition holds in this cycle
+   * @param deviceName	the name of the reporting device
+   * @param value	message specific value
+   * @return	true if the condition was raised in this cycle
+   */
+  bool update(bool active, const std::string& deviceName, int32_t value = 0);
+
+  bool isActive() const { return active_; }
+
+ protected:
+  void push(RtLogEvent event, uint32_t count, const std::string& deviceName, int32_t value);
+
+  RtLogMessage message_;
+  std::chrono::steady_clock::duration repeatInterval_;
+  std::chrono::steady_clock::time_point lastRecordTimePoint_;
+  bool active_{false};
+  uint32_t occurrencesSinceLastRecord_{0};
+  uint32_t occurrences_{0};
+};
+
+}  // namespace elmo
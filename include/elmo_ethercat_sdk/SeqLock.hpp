@@ -0,0 +1,181 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace elmo {
+
+/*!
+ * Single writer, multiple reader sequence lock.
+ * The writer never blocks. Readers retry until they got a copy which was not
+ * torn by a concurrent write. The payload is stored in atomic words such that
+ * the concurrent access is well defined.
+ * @tparam T	a trivially copyable type
+ */
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+ public:
+  SeqLock() { store(T{}); }
+  explicit SeqLock(const T& value) { store(value); }
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  /*!
+   * Publish a new value.
+   * Must only be called from a single thread at a time.
+   * @param value	the value to publish
+   */
+  void store(const T& value) {
+    std::array<uint64_t, numberOfWords_> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < numberOfWords_; i++) {
+      words_[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  /*!
+   * Copy the most recently published value.
+   * @param[out] value	the copy
+   */
+  void load(T& value) const {
+    std::array<uint64_t, numberOfWords_> words;
+    uint32_t sequenceBefore;
+    uint32_t sequenceAfter;
+    do {
+      sequenceBefore = sequence_.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < numberOfWords_; i++) {
+        words[i] = words_[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      sequenceAfter = sequence_.load(std::memory_order_relaxed);
+    } while ((sequenceBefore & 1u) != 0 || sequenceBefore != sequenceAfter);
+    std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+  }
+
+  T load() const {
+    T value;
+    load(value);
+    return value;
+  }
+
+ private:
+  static constexpr std::size_t numberOfWords_ = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint32_t> sequence_{0};
+  std::array<std::atomic<uint64_t>, numberOfWords_> words_;
+};
+
+template <typename T>
+constexpr std::size_t SeqLock<T>::numberOfWords_;
+
+/*!
+ * Single writer, multiple reader sequence lock of an array, such that the
+ * readers get all elements of the same write (see SeqLock).
+ * @tparam T	a trivially copyable type
+ */
+template <typename T>
+class SeqLockBuffer {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLockBuffer requires a trivially copyable type");
+
+ public:
+  explicit SeqLockBuffer(std::size_t size = 0) { resize(size); }
+
+  SeqLockBuffer(const SeqLockBuffer&) = delete;
+  SeqLockBuffer& operator=(const SeqLockBuffer&) = delete;
+
+  /*!
+   * Change the number of elements, the elements are zeroed.
+   * Must not be called concurrently to store / load.
+   * @param size	the number of elements
+   */
+  void resize(std::size_t size) {
+    size_ = size;
+    words_.reset(new std::atomic<uint64_t>[size * numberOfWordsPerElement_]());
+  }
+
+  std::size_t size() const { return size_; }
+
+  /*!
+   * Publish new values.
+   * Must only be called from a single thread at a time.
+   * @param values	size() values
+   */
+  void store(const T* values) {
+    const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::array<uint64_t, numberOfWordsPerElement_> words{};
+    for (std::size_t element = 0; element < size_; element++) {
+      std::memcpy(words.data(), &values[element], sizeof(T));
+      for (std::size_t i = 0; i < numberOfWordsPerElement_; i++) {
+        words_[element * numberOfWordsPerElement_ + i].store(words[i], std::memory_order_relaxed);
+      }
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  /*!
+   * Copy the most recently published values.
+   * @param[out] values	size() values
+   */
+  void load(T* values) const {
+    std::array<uint64_t, numberOfWordsPerElement_> words;
+    uint32_t sequenceBefore;
+    uint32_t sequenceAfter;
+    do {
+      sequenceBefore = sequence_.load(std::memory_order_acquire);
+      for (std::size_t element = 0; element < size_; element++) {
+        for (std::size_t i = 0; i < numberOfWordsPerElement_; i++) {
+          words[i] = words_[element * numberOfWordsPerElement_ + i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(static_cast<void*>(&values[element]), words.data(), sizeof(T));
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      sequenceAfter = sequence_.load(std::memory_order_relaxed);
+    } while ((sequenceBefore & 1u) != 0 || sequenceBefore != sequenceAfter);
+  }
+
+ private:
+  static constexpr std::size_t numberOfWordsPerElement_ = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+  std::atomic<uint32_t> sequence_{0};
+  std::size_t size_{0};
+  std::unique_ptr<std::atomic<uint64_t>[]> words_;
+};
+
+template <typename T>
+constexpr std::size_t SeqLockBuffer<T>::numberOfWordsPerElement_;
+
+}  // namespace elmo
@@ -0,0 +1,114 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace elmo {
+
+/*!
+ * @brief	Bounded single producer, single consumer queue
+ * Lock-free and preallocated: push (producer) and pop (consumer) neither
+ * allocate nor block. The positions of the producer and the consumer are
+ * kept in separate cache lines. If the queue is full, push fails.
+ * @tparam T	a trivially copyable type
+ */
+template <typename T>
+class SpscQueue {
+  static_assert(std::is_trivially_copyable<T>::value, "SpscQueue requires a trivially copyable type");
+
+ public:
+  /*!
+   * @param capacity	rounded up to a power of two
+   */
+  explicit SpscQueue(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    buffer_.resize(size);
+    mask_ = size - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  std::size_t capacity() const { return buffer_.size(); }
+
+  /*!
+   * Add an element, only called by the producer.
+   * @return	false if the queue is full
+   */
+  bool push(const T& value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ == buffer_.size()) {
+      cachedHead_ = head_.load(std::memory_order_acquire);
+      if (tail - cachedHead_ == buffer_.size()) {
+        return false;
+      }
+    }
+    buffer_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /*!
+   * Remove the oldest element, only called by the consumer.
+   * @return	false if the queue is empty
+   */
+  bool pop(T& value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cachedTail_) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      if (head == cachedTail_) {
+        return false;
+      }
+    }
+    value = buffer_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  // separates the positions of the producer and the consumer. Padding instead of
+  // alignas, such that the queue can be allocated with new before C++17.
+  static constexpr std::size_t cacheLineSize_{64};
+
+  std::vector<T> buffer_;
+  std::size_t mask_{0};
+  char padding0_[cacheLineSize_];
+  // written by the producer, the cached head avoids reading the head of the consumer every push
+  std::atomic<std::size_t> tail_{0};
+  std::size_t cachedHead_{0};
+  char padding1_[cacheLineSize_];
+  // written by the consumer
+  std::atomic<std::size_t> head_{0};
+  std::size_t cachedTail_{0};
+  char padding2_[cacheLineSize_];
+};
+
+template <typename T>
+constexpr std::size_t SpscQueue<T>::cacheLineSize_;
+
+}  // namespace elmo
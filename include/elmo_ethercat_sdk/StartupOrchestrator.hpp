@@ -0,0 +1,130 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elmo_ethercat_sdk/Error.hpp"
+
+namespace elmo {
+
+class Elmo;
+
+/*!
+ * Progress and result of the startup of one drive.
+ */
+struct DriveStartupResult {
+  enum class State { Pending, Running, Succeeded, Failed };
+
+  std::string name;
+  State state{State::Pending};
+  // duration of the startup sequence of this drive
+  std::chrono::milliseconds duration{0};
+  // errors added to the reading of the drive during its startup sequence, oldest first
+  std::vector<ErrorType> errors;
+};
+
+/*!
+ * @brief	Runs the startup (SDO configuration) sequences of several drives concurrently
+ * The EtherCAT master calls Elmo::startup for one device after the other.
+ * Drives which are registered here run the startup sequences of all
+ * registered drives in a pool of worker threads on the first of these calls.
+ * All further calls return the stored result of the respective drive.
+ * The total startup time thereby approaches the one of the slowest drive
+ * instead of the sum. SDO transfers are still serialized by the bus, the
+ * waiting times of the drives overlap.
+ */
+class StartupOrchestrator {
+ public:
+  typedef std::shared_ptr<StartupOrchestrator> SharedPtr;
+
+  /*!
+   * @param maxNumberOfWorkers	the maximum number of drives configured at the same time, 0 for all drives
+   */
+  explicit StartupOrchestrator(std::size_t maxNumberOfWorkers = 0);
+  // stops the worker threads
+  ~StartupOrchestrator();
+  StartupOrchestrator(const StartupOrchestrator&) = delete;
+  StartupOrchestrator& operator=(const StartupOrchestrator&) = delete;
+
+  /*!
+   * Register a drive. Must be called before the startup.
+   * @param drive	the drive, must outlive the orchestrator
+   */
+  void addDrive(Elmo* drive);
+
+  /*!
+   * Called by Elmo::startup. Runs the startup of all drives on the first call.
+   * @param drive	the drive whose result is returned
+   * @return	true if the startup of drive was successful
+   */
+  bool startup(const Elmo* drive);
+
+  /*!
+   * Run the startup of all drives which have not been started yet and wait
+   * for them. The worker threads are started on the first call and are kept
+   * for drives registered later.
+   * @return	true if the startup of all drives was successful
+   */
+  bool startupAll();
+
+  /*!
+   * Get the progress / results, can be called from any thread.
+   */
+  std::vector<DriveStartupResult> getResults() const;
+  std::size_t getNumberOfFinishedDrives() const;
+
+  /*!
+   * Print the results of all drives.
+   */
+  void printResults() const;
+
+ protected:
+  void work();
+  void runDrive(std::size_t index);
+
+  std::size_t maxNumberOfWorkers_;
+  std::vector<Elmo*> drives_;
+  std::vector<DriveStartupResult> results_;
+  std::size_t nextDrive_{0};
+  // the drives up to this index are started by the workers
+  std::size_t numberOfRequestedDrives_{0};
+  std::size_t numberOfRunningDrives_{0};
+  bool stopping_{false};
+  // guards drives_, results_, the counters and stopping_
+  mutable std::mutex mutex_;
+  // signals pending drives (or stopping_) to the workers
+  std::condition_variable workAvailable_;
+  // signals startupAll that all drives are finished
+  std::condition_variable workFinished_;
+  std::vector<std::thread> workers_;
+  // serializes startupAll
+  std::mutex startupMutex_;
+};
+
+}  // namespace elmo
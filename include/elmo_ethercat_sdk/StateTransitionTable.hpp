@@ -0,0 +1,189 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "elmo_ethercat_sdk/DriveState.hpp"
+
+namespace elmo {
+
+/*!
+ * Next step from the current towards the target drive state.
+ */
+struct StateTransitionStep {
+  enum class Type : uint8_t {
+    // the current state is the target state
+    Reached,
+    Transition,
+    // the target state cannot be requested (e.g. Fault), or the drive has to
+    // leave the current state by itself (NotReadyToSwitchOn, FaultReactionActive)
+    Unreachable
+  };
+
+  Type type;
+  // only valid for Type::Transition
+  StateTransition transition;
+  // controlword triggering the transition, 0x0000 otherwise
+  uint16_t controlword;
+};
+
+/*!
+ * Transitions from the current to the target drive state, see
+ * StateTransitionTable::getSequence.
+ */
+struct StateTransitionSequence {
+  static constexpr std::size_t maxSize{5};
+
+  // false if the target state cannot be reached from the current state
+  bool valid{false};
+  std::size_t size{0};
+  StateTransition transitions[maxSize]{};
+};
+
+/*!
+ * @brief	CiA 402 state machine as constexpr tables
+ * Both the SDO and the PDO state changes follow this graph: the table yields
+ * the next transition (and its raw controlword) for every pair of current and
+ * target drive state. Faults are reset (transition 15) and a quick stop is left
+ * through SwitchOnDisabled (transition 12).
+ */
+class StateTransitionTable {
+ public:
+  static constexpr uint16_t getControlword(StateTransition transition) {
+    return controlwords_[static_cast<std::size_t>(transition)];
+  }
+
+  // state of the drive after the transition
+  static constexpr DriveState getResultingDriveState(StateTransition transition) {
+    return resultingDriveStates_[static_cast<std::size_t>(transition)];
+  }
+
+  static constexpr StateTransitionStep getNextStep(DriveState currentDriveState, DriveState targetDriveState) {
+    return steps_[static_cast<std::size_t>(targetDriveState)][static_cast<std::size_t>(currentDriveState)];
+  }
+
+  /*!
+   * Follow the table from the current to the target drive state, e.g. for the
+   * SDO state change which writes all transitions in one go.
+   */
+  static constexpr StateTransitionSequence getSequence(DriveState currentDriveState, DriveState targetDriveState) {
+    StateTransitionSequence sequence{};
+    DriveState driveState = currentDriveState;
+    for (std::size_t i = 0; i <= StateTransitionSequence::maxSize; i++) {
+      const StateTransitionStep step = getNextStep(driveState, targetDriveState);
+      if (step.type != StateTransitionStep::Type::Transition) {
+        sequence.valid = step.type == StateTransitionStep::Type::Reached;
+        return sequence;
+      }
+      if (sequence.size < StateTransitionSequence::maxSize) {
+        sequence.transitions[sequence.size++] = step.transition;
+      }
+      driveState = getResultingDriveState(step.transition);
+    }
+    // the target is not reached within maxSize transitions
+    return sequence;
+  }
+
+ protected:
+  static constexpr std::size_t numberOfDriveStates_{static_cast<std::size_t>(DriveState::NA) + 1};
+  static constexpr std::size_t numberOfStateTransitions_{static_cast<std::size_t>(StateTransition::_15) + 1};
+
+  // ordered like StateTransition
+  static constexpr uint16_t controlwords_[numberOfStateTransitions_]{
+      0x0006,  // 2: shutdown
+      0x0007,  // 3: switch on
+      0x000f,  // 4: enable operation
+      0x0007,  // 5: disable operation
+      0x0006,  // 6: shutdown
+      0x0000,  // 7: disable voltage
+      0x0006,  // 8: shutdown
+      0x0000,  // 9: disable voltage
+      0x0000,  // 10: disable voltage
+      0x0002,  // 11: quick stop
+      0x0000,  // 12: disable voltage
+      0x0080   // 15: fault reset
+  };
+
+  static constexpr DriveState resultingDriveStates_[numberOfStateTransitions_]{
+      DriveState::ReadyToSwitchOn,   DriveState::SwitchedOn,       DriveState::OperationEnabled,
+      DriveState::SwitchedOn,        DriveState::ReadyToSwitchOn,  DriveState::SwitchOnDisabled,
+      DriveState::ReadyToSwitchOn,   DriveState::SwitchOnDisabled, DriveState::SwitchOnDisabled,
+      DriveState::QuickStopActive,   DriveState::SwitchOnDisabled, DriveState::SwitchOnDisabled};
+
+  static constexpr StateTransitionStep reached_{StateTransitionStep::Type::Reached, StateTransition::_2, 0x0000};
+  static constexpr StateTransitionStep unreachable_{StateTransitionStep::Type::Unreachable, StateTransition::_2,
+                                                    0x0000};
+  static constexpr StateTransitionStep t2_{StateTransitionStep::Type::Transition, StateTransition::_2,
+                                           controlwords_[0]};
+  static constexpr StateTransitionStep t3_{StateTransitionStep::Type::Transition, StateTransition::_3,
+                                           controlwords_[1]};
+  static constexpr StateTransitionStep t4_{StateTransitionStep::Type::Transition, StateTransition::_4,
+                                           controlwords_[2]};
+  static constexpr StateTransitionStep t5_{StateTransitionStep::Type::Transition, StateTransition::_5,
+                                           controlwords_[3]};
+  static constexpr StateTransitionStep t6_{StateTransitionStep::Type::Transition, StateTransition::_6,
+                                           controlwords_[4]};
+  static constexpr StateTransitionStep t7_{StateTransitionStep::Type::Transition, StateTransition::_7,
+                                           controlwords_[5]};
+  static constexpr StateTransitionStep t8_{StateTransitionStep::Type::Transition, StateTransition::_8,
+                                           controlwords_[6]};
+  static constexpr StateTransitionStep t9_{StateTransitionStep::Type::Transition, StateTransition::_9,
+                                           controlwords_[7]};
+  static constexpr StateTransitionStep t10_{StateTransitionStep::Type::Transition, StateTransition::_10,
+                                            controlwords_[8]};
+  static constexpr StateTransitionStep t11_{StateTransitionStep::Type::Transition, StateTransition::_11,
+                                            controlwords_[9]};
+  static constexpr StateTransitionStep t12_{StateTransitionStep::Type::Transition, StateTransition::_12,
+                                            controlwords_[10]};
+  static constexpr StateTransitionStep t15_{StateTransitionStep::Type::Transition, StateTransition::_15,
+                                            controlwords_[11]};
+
+  // [target][current], both ordered like DriveState:
+  // NotReadyToSwitchOn, SwitchOnDisabled, ReadyToSwitchOn, SwitchedOn, OperationEnabled,
+  // QuickStopActive, FaultReactionActive, Fault, NA
+  static constexpr StateTransitionStep steps_[numberOfDriveStates_][numberOfDriveStates_]{
+      // NotReadyToSwitchOn
+      {reached_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_,
+       unreachable_},
+      // SwitchOnDisabled
+      {unreachable_, reached_, t7_, t10_, t9_, t12_, unreachable_, t15_, unreachable_},
+      // ReadyToSwitchOn
+      {unreachable_, t2_, reached_, t6_, t8_, t12_, unreachable_, t15_, unreachable_},
+      // SwitchedOn
+      {unreachable_, t2_, t3_, reached_, t5_, t12_, unreachable_, t15_, unreachable_},
+      // OperationEnabled
+      {unreachable_, t2_, t3_, t4_, reached_, t12_, unreachable_, t15_, unreachable_},
+      // QuickStopActive
+      {unreachable_, t2_, t3_, t4_, t11_, reached_, unreachable_, t15_, unreachable_},
+      // FaultReactionActive
+      {unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, reached_, unreachable_,
+       unreachable_},
+      // Fault
+      {unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, reached_,
+       unreachable_},
+      // NA
+      {unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_, unreachable_,
+       unreachable_, unreachable_}};
+};
+
+}  // namespace elmo
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
@@ -29,28 +30,88 @@
 
 namespace elmo {
 
+/*!
+ * Drive state of a statusword (MAN-G-DS402 manual page 47), only depends on
+ * the bits 0-6.
+ */
+constexpr DriveState decodeDriveState(uint16_t rawStatusword) {
+  if ((rawStatusword & 0b0000000001001111) == 0b0000000000000000) {
+    return DriveState::NotReadyToSwitchOn;
+  } else if ((rawStatusword & 0b0000000001001111) == 0b0000000001000000) {
+    return DriveState::SwitchOnDisabled;
+  } else if ((rawStatusword & 0b0000000001101111) == 0b0000000000100001) {
+    return DriveState::ReadyToSwitchOn;
+  } else if ((rawStatusword & 0b0000000001101111) == 0b0000000000100011) {
+    return DriveState::SwitchedOn;
+  } else if ((rawStatusword & 0b0000000001101111) == 0b0000000000100111) {
+    return DriveState::OperationEnabled;
+  } else if ((rawStatusword & 0b0000000001101111) == 0b0000000000000111) {
+    return DriveState::QuickStopActive;
+  } else if ((rawStatusword & 0b0000000001001111) == 0b0000000000001111) {
+    return DriveState::FaultReactionActive;
+  } else if ((rawStatusword & 0b0000000001001111) == 0b0000000000001000) {
+    return DriveState::Fault;
+  }
+  return DriveState::NA;
+}
+
+/*!
+ * decodeDriveState for all values of the bits 0-6.
+ */
+struct DriveStateTable {
+  static constexpr std::size_t size{128};
+  static constexpr uint16_t mask{size - 1};
+
+  DriveState driveStates[size];
+};
+
+constexpr DriveStateTable makeDriveStateTable() {
+  DriveStateTable driveStateTable{};
+  for (uint16_t bits = 0; bits < DriveStateTable::size; bits++) {
+    driveStateTable.driveStates[bits] = decodeDriveState(bits);
+  }
+  return driveStateTable;
+}
+
+/*!
+ * @brief	Statusword (0x6041) as read from the drive
+ * The bits are decoded on access, the drive state with a table lookup.
+ */
 class Statusword {
+ public:
+  constexpr Statusword() = default;
+  constexpr explicit Statusword(uint16_t rawStatusword) : rawStatusword_(rawStatusword) {}
+
+  void setFromRawStatusword(uint16_t status) { rawStatusword_ = status; }
+  constexpr uint16_t getRawStatusword() const { return rawStatusword_; }
+
+  constexpr bool getReadyToSwitchOn() const { return getBit(0); }
+  constexpr bool getSwitchedOn() const { return getBit(1); }
+  constexpr bool getOperationEnabled() const { return getBit(2); }
+  constexpr bool getFault() const { return getBit(3); }
+  constexpr bool getVoltageEnabled() const { return getBit(4); }
+  constexpr bool getQuickStop() const { return getBit(5); }
+  constexpr bool getSwitchOnDisabled() const { return getBit(6); }
+  constexpr bool getWarning() const { return getBit(7); }
+  constexpr bool getTargetReached() const { return getBit(10); }
+  constexpr bool getInternalLimitActive() const { return getBit(11); }
+  // CSV mode
+  constexpr bool getFollowingError() const { return getBit(13); }
+
+  constexpr DriveState getDriveState() const {
+    return driveStateTable_.driveStates[rawStatusword_ & DriveStateTable::mask];
+  }
+  std::string getDriveStateString() const;
+
+  friend std::ostream& operator<<(std::ostream& os, const Statusword& statusword);
+
  private:
-  bool readyToSwitchOn_{false};      // bit 0
-  bool switchedOn_{false};           // bit 1
-  bool operationEnabled_{false};     // bit 2
-  bool fault_{false};                // bit 3
-  bool voltageEnabled_{false};       // bit 4
-  bool quickStop_{false};            // bit 5
-  bool switchOnDisabled_{false};     // bit 6
-  bool warning_{false};              // bit 7
-  bool targetReached_{false};        // bit 10
-  bool internalLimitActive_{false};  // bit 11
-  bool followingError_{false};       // bit 13, CSV mode
+  constexpr bool getBit(unsigned int bit) const { return (rawStatusword_ >> bit) & 1; }
+
+  static constexpr DriveStateTable driveStateTable_{makeDriveStateTable()};
 
   // the raw statusword
   uint16_t rawStatusword_{0};
-
- public:
-  friend std::ostream& operator<<(std::ostream& os, const Statusword& statusword);
-  void setFromRawStatusword(uint16_t status);
-  DriveState getDriveState() const;
-  std::string getDriveStateString() const;
 };
 
 }  // namespace elmo
@@ -0,0 +1,212 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elmo_ethercat_sdk/SpscQueue.hpp"
+
+namespace elmo {
+
+/*!
+ * Raw process data of one cycle of a drive (see ReadingSnapshot).
+ */
+struct TelemetrySample {
+  // [ns] time point of the reading (std::chrono::steady_clock)
+  int64_t timestamp;
+  int32_t actualPosition;
+  int32_t actualVelocity;
+  int16_t actualCurrent;
+  uint16_t statusword;
+  uint32_t busVoltage;
+};
+
+/*!
+ * The samples of a drive in columns.
+ */
+struct TelemetryColumns {
+  std::vector<int64_t> timestamp;
+  std::vector<int32_t> actualPosition;
+  std::vector<int32_t> actualVelocity;
+  std::vector<int16_t> actualCurrent;
+  std::vector<uint16_t> statusword;
+  std::vector<uint32_t> busVoltage;
+
+  std::size_t size() const { return timestamp.size(); }
+  void reserve(std::size_t size);
+  void clear();
+  void push_back(const TelemetrySample& sample);
+};
+
+/*!
+ * @brief	Queue of the samples of a drive, filled by its bus thread
+ * Created by TelemetryStream::addChannel.
+ */
+class TelemetryChannel {
+ public:
+  TelemetryChannel(uint16_t id, const std::string& name, std::size_t queueCapacity)
+      : id_(id), name_(name), queue_(queueCapacity) {}
+
+  /*!
+   * Add a sample, only called by one thread (the bus thread of the drive).
+   * Neither allocates nor blocks, the sample is dropped if the queue is full.
+   */
+  void push(const TelemetrySample& sample) {
+    if (!queue_.push(sample)) {
+      numberOfDroppedSamples_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  uint16_t getId() const { return id_; }
+  const std::string& getName() const { return name_; }
+  uint64_t getNumberOfDroppedSamples() const { return numberOfDroppedSamples_.load(std::memory_order_relaxed); }
+
+ protected:
+  friend class TelemetryStream;
+
+  uint16_t id_;
+  std::string name_;
+  SpscQueue<TelemetrySample> queue_;
+  std::atomic<uint64_t> numberOfDroppedSamples_{0};
+
+  // only accessed by the writer thread
+  TelemetryColumns columns_;
+  uint64_t numberOfWrittenDroppedSamples_{0};
+  bool isDescribed_{false};
+};
+
+/*!
+ * Layout of the telemetry file: the header, followed by chunks.
+ * Channel chunk: type, channel id (uint16), name length (uint8), name.
+ * Block chunk: type, channel id (uint16), number of samples (uint32), samples
+ * dropped since the previous block (uint64), size of the columns (uint32), the
+ * columns. Each column (in the order of TelemetrySample) holds the
+ * differences of consecutive values (the first value to 0), zigzag and
+ * varint encoded. All integers are little endian.
+ */
+struct TelemetryFile {
+  static constexpr char magic[8]{'E', 'L', 'M', 'O', 'T', 'L', 'M', 'Y'};
+  static constexpr uint32_t currentVersion{1};
+  static constexpr uint8_t channelChunk{0};
+  static constexpr uint8_t blockChunk{1};
+};
+
+/*!
+ * @brief	Background writer of per cycle telemetry of drives
+ * Every drive with this stream (see Elmo::setTelemetryStream) pushes one
+ * TelemetrySample per updateRead into its own lock-free queue. A writer
+ * thread drains the queues every 10 ms and stores blocks of delta encoded
+ * columns to a file, such that the bus threads are not delayed by the disk.
+ * The file can be read with TelemetryReader.
+ */
+class TelemetryStream {
+ public:
+  typedef std::shared_ptr<TelemetryStream> SharedPtr;
+
+  /*!
+   * @param queueCapacity	samples per drive, must hold the samples of 10 ms and the time of a write of the disk
+   * @param blockSize	samples per drive and block
+   */
+  explicit TelemetryStream(std::size_t queueCapacity = 4096, std::size_t blockSize = 2048);
+  ~TelemetryStream();
+  TelemetryStream(const TelemetryStream&) = delete;
+  TelemetryStream& operator=(const TelemetryStream&) = delete;
+
+  /*!
+   * Create the file and start the writer thread.
+   * @return	false if the file cannot be created or the stream is already started
+   */
+  bool start(const std::string& fileName);
+  /*!
+   * Write the remaining samples and close the file.
+   */
+  void stop();
+
+  /*!
+   * Add the queue of a drive, can be called while the stream is running.
+   * The channel is owned by the stream. Samples are dropped once the queue is
+   * full while the stream is not started.
+   */
+  TelemetryChannel* addChannel(const std::string& name);
+
+  uint64_t getNumberOfWrittenSamples() const { return numberOfWrittenSamples_.load(std::memory_order_relaxed); }
+  // samples dropped by all channels as the queues were full
+  uint64_t getNumberOfDroppedSamples() const;
+
+ protected:
+  void work();
+  // move the samples from the queues into the columns, write full blocks (all blocks if flush)
+  void drain(bool flush);
+  void writeChannel(TelemetryChannel& channel);
+  void writeBlock(TelemetryChannel& channel);
+
+  std::size_t queueCapacity_;
+  std::size_t blockSize_;
+
+  // guards channels_, the channels are only added
+  mutable std::mutex channelsMutex_;
+  std::vector<std::unique_ptr<TelemetryChannel>> channels_;
+
+  // only accessed by the writer thread while it runs
+  std::vector<TelemetryChannel*> drainedChannels_;
+  std::ofstream file_;
+  std::vector<uint8_t> buffer_;
+  bool writeFailed_{false};
+  std::atomic<uint64_t> numberOfWrittenSamples_{0};
+
+  std::atomic<bool> running_{false};
+  std::thread worker_;
+};
+
+/*!
+ * @brief	Reader of the file of a TelemetryStream
+ */
+class TelemetryReader {
+ public:
+  struct Channel {
+    std::string name;
+    TelemetryColumns columns;
+    uint64_t numberOfDroppedSamples{0};
+  };
+
+  /*!
+   * Read and decode the whole file. A block truncated by a crash ends the file.
+   * @return	false if the file cannot be read or is not a telemetry file
+   */
+  bool open(const std::string& fileName);
+
+  // by channel id
+  const std::vector<Channel>& getChannels() const { return channels_; }
+
+ protected:
+  std::vector<Channel> channels_;
+};
+
+}  // namespace elmo
@@ -0,0 +1,85 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace elmo {
+
+/*!
+ * Convert a value to an integer type, truncating towards zero and saturating
+ * at the limits of the type. NaN is converted to 0.
+ * @param value	the value to convert
+ * @return	the converted value
+ */
+template <typename T>
+inline T saturatingCast(double value) {
+  if (value != value) {
+    return 0;
+  }
+  if (value <= static_cast<double>(std::numeric_limits<T>::min())) {
+    return std::numeric_limits<T>::min();
+  }
+  if (value >= static_cast<double>(std::numeric_limits<T>::max())) {
+    return std::numeric_limits<T>::max();
+  }
+  return static_cast<T>(value);
+}
+
+/*!
+ * Implementations of the array conversion functions below.
+ * All kernels produce bit-identical results.
+ */
+enum class ConversionKernel : uint8_t { Scalar, Avx2 };
+
+/*!
+ * @return	true if the kernel can be used on this CPU
+ */
+bool isConversionKernelSupported(ConversionKernel kernel);
+
+/*!
+ * Select the kernel used by the array conversion functions.
+ * By default the fastest supported kernel is used.
+ * @param kernel	the requested kernel
+ * @return	false if the kernel is not supported (the selection is unchanged)
+ */
+bool setConversionKernel(ConversionKernel kernel);
+
+ConversionKernel getConversionKernel();
+
+/*!
+ * Raw units -> user units, element wise:
+ * values[i] = static_cast<double>(raw[i]) * factors[i]
+ */
+void convertFromRaw(const int32_t* raw, const double* factors, double* values, std::size_t size);
+void convertFromRaw(const int16_t* raw, const double* factors, double* values, std::size_t size);
+
+/*!
+ * User units -> raw units, element wise:
+ * raw[i] = saturatingCast<T>(factors[i] * values[i])
+ */
+void convertToRaw(const double* values, const double* factors, int32_t* raw, std::size_t size);
+void convertToRaw(const double* values, const double* factors, int16_t* raw, std::size_t size);
+void convertToRaw(const double* values, const double* factors, uint16_t* raw, std::size_t size);
+
+}  // namespace elmo
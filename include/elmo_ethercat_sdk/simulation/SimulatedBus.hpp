@@ -0,0 +1,118 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <soem_interface/EthercatBusBase.hpp>
+
+#include "elmo_ethercat_sdk/simulation/SimulatedDrive.hpp"
+
+namespace elmo {
+
+class SimulatedElmo;
+
+/*!
+ * @brief	In-process EtherCAT bus of simulated drives
+ * Holds one SimulatedDrive per address (1 to numberOfDrives) and a process
+ * image such that readTxPdo / writeRxPdo of the bus base and
+ * Elmo::setProcessImage work without hardware. The bus is not started, the
+ * process data is exchanged by update instead of updateWrite / updateRead.
+ * Typical cycle of the bus thread: Elmo::updateWrite of all drives, update,
+ * Elmo::updateRead of all drives.
+ */
+class SimulatedBus : public soem_interface::EthercatBusBase {
+ public:
+  /*!
+   * @param numberOfDrives	the number of drives, at most EC_MAXSLAVE - 1
+   * @param parameters	the parameters of all drives
+   */
+  explicit SimulatedBus(uint16_t numberOfDrives,
+                        const SimulatedDriveParameters& parameters = SimulatedDriveParameters(),
+                        const std::string& name = "simulated_bus");
+
+  /*!
+   * Connect a drive to the simulated drive at its address: sets the bus, the
+   * startup and shutdown of the drive then go to the simulated drive.
+   * @return	false if there is no simulated drive at the address of the drive
+   */
+  bool attach(SimulatedElmo& elmo);
+
+  uint16_t getNumberOfDrives() const { return static_cast<uint16_t>(slaves_.size()); }
+  SimulatedDrive& getDrive(uint16_t address) { return slaves_[address - 1]->getDrive(); }
+
+  /*!
+   * Set the EtherCAT state of all drives, e.g. EC_STATE_OPERATIONAL after the
+   * startup. The drives are in PRE_OP after the construction.
+   */
+  void setAllStates(uint16_t state);
+
+  /*!
+   * Simulate one cycle of all drives: the drives read their RxPdos from the
+   * outputs and write their TxPdos to the inputs.
+   * @param timeStep	[s]
+   */
+  void update(double timeStep);
+
+  /*!
+   * The process image of a drive (see Elmo::setProcessImage), sized by the PDO assignment.
+   */
+  uint8_t* getOutputs(uint16_t address) { return &outputs_[(address - 1) * SimulatedDrive::maxPdoSize]; }
+  const uint8_t* getInputs(uint16_t address) const { return &inputs_[(address - 1) * SimulatedDrive::maxPdoSize]; }
+
+ protected:
+  /*!
+   * A simulated drive which updates the PDO sizes of the bus after the
+   * assignment changed.
+   */
+  class Slave : public SimulatedDevice {
+   public:
+    Slave(SimulatedBus& bus, uint16_t address, const SimulatedDriveParameters& parameters)
+        : bus_(bus), address_(address), drive_(parameters) {}
+
+    bool sdoRead(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data, std::size_t size) override {
+      return drive_.sdoRead(index, subindex, completeAccess, data, size);
+    }
+    bool sdoWrite(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                  std::size_t size) override;
+    void setEthercatState(uint16_t state) override { drive_.setEthercatState(state); }
+    uint16_t getEthercatState() const override { return drive_.getEthercatState(); }
+
+    SimulatedDrive& getDrive() { return drive_; }
+
+   private:
+    SimulatedBus& bus_;
+    uint16_t address_;
+    SimulatedDrive drive_;
+  };
+
+  void updatePdoSizes(uint16_t address);
+
+  std::vector<std::unique_ptr<Slave>> slaves_;
+  std::vector<uint8_t> outputs_;
+  std::vector<uint8_t> inputs_;
+};
+
+}  // namespace elmo
@@ -0,0 +1,58 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace elmo {
+
+/*!
+ * @brief	Mailbox and EtherCAT state of a drive which is not on a real bus
+ * The startup and the shutdown of a SimulatedElmo use this interface
+ * instead of the mailbox of the bus (see SimulatedBus::attach). The process data is still exchanged through the
+ * process image of the bus (see SimulatedBus).
+ */
+class SimulatedDevice {
+ public:
+  virtual ~SimulatedDevice() = default;
+
+  /*!
+   * Upload an object. With complete access all subindices starting at
+   * subindex are uploaded.
+   * @param data	the value, size bytes
+   * @return	false if the object does not exist or its size differs
+   */
+  virtual bool sdoRead(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data, std::size_t size) = 0;
+  /*!
+   * Download an object.
+   * @param data	the value, size bytes
+   * @return	false if the object does not exist, is read only or its size differs
+   */
+  virtual bool sdoWrite(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                        std::size_t size) = 0;
+
+  // EC_STATE_INIT, EC_STATE_PRE_OP, ...
+  virtual void setEthercatState(uint16_t state) = 0;
+  virtual uint16_t getEthercatState() const = 0;
+};
+
+}  // namespace elmo
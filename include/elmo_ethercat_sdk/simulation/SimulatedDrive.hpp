@@ -0,0 +1,178 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "elmo_ethercat_sdk/DriveState.hpp"
+#include "elmo_ethercat_sdk/PdoLayout.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedDevice.hpp"
+
+namespace elmo {
+
+/*!
+ * Parameters of the motor model and the electronics of a SimulatedDrive.
+ */
+struct SimulatedDriveParameters {
+  // [ticks per revolution]
+  int32_t positionEncoderResolution{16384};
+  // [kg m^2] of the rotor and the load
+  double inertia{1.0e-4};
+  // [Nm s / rad] viscous friction
+  double damping{1.0e-4};
+  // [Nm / A]
+  double motorConstant{0.1};
+  // [s] time constant of the velocity (CSV) and position (CSP) tracking
+  double trackingTimeConstant{0.005};
+  // [cycles] until a state transition requested by the controlword PDO shows in the statusword
+  unsigned int stateTransitionDelay{2};
+  // [mA] until the master writes the motor rated current
+  uint32_t motorRatedCurrent{10000};
+  // [mV]
+  uint32_t busVoltage{48000};
+  // [mV]
+  uint16_t supplyVoltage5v{5000};
+};
+
+/*!
+ * @brief	In-process model of an Elmo drive
+ * Implements the parts of the drive which the Elmo class uses: the CiA 402
+ * state machine driven by the controlword, the PDO assignment (0x1C12 /
+ * 0x1C13) and the custom PDO mapping (0x1600 / 0x1A00), the objects read
+ * and written during the startup, and a rigid body motor model in the
+ * cyclic synchronous torque, velocity and position modes.
+ * SDO transfers (any thread) and update (bus thread) are serialized by a
+ * mutex of the drive.
+ */
+class SimulatedDrive : public SimulatedDevice {
+ public:
+  // [bytes] of the RxPdo / TxPdo, larger assignments are rejected
+  static constexpr std::size_t maxPdoSize{64};
+
+  SimulatedDrive() : SimulatedDrive(SimulatedDriveParameters()) {}
+  explicit SimulatedDrive(const SimulatedDriveParameters& parameters);
+
+  bool sdoRead(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data, std::size_t size) override;
+  bool sdoWrite(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                std::size_t size) override;
+  void setEthercatState(uint16_t state) override;
+  uint16_t getEthercatState() const override;
+
+  /*!
+   * Simulate one cycle. In OPERATIONAL the RxPdo is applied, in SAFE_OP and
+   * OPERATIONAL the TxPdo is written.
+   * @param rxPdo	getRxPdoSize() bytes received from the master
+   * @param txPdo	getTxPdoSize() bytes sent to the master
+   * @param timeStep	[s]
+   */
+  void update(const uint8_t* rxPdo, uint8_t* txPdo, double timeStep);
+
+  // [bytes] of the assigned PDOs
+  uint16_t getRxPdoSize() const;
+  uint16_t getTxPdoSize() const;
+
+  /*!
+   * Fault injection: the drive passes FaultReactionActive and stays in Fault
+   * until the master resets the fault.
+   */
+  void triggerFault();
+
+  DriveState getDriveState() const;
+  // [rad], [rad / s] and [Nm] of the motor
+  double getPosition() const;
+  double getVelocity() const;
+  double getTorque() const;
+
+ protected:
+  // objects of the assignment (0x1C12 / 0x1C13) or of the custom mapping (0x1600 / 0x1A00)
+  struct PdoObject {
+    uint8_t numberOfEntries{0};
+    std::vector<uint32_t> entries;
+  };
+
+  template <typename Value>
+  bool readValue(const Value& value, uint8_t* data, std::size_t size) const;
+  template <typename Value>
+  bool writeValue(Value& value, const uint8_t* data, std::size_t size) const;
+  // the entries of an assignment are 16 bit, the ones of a mapping 32 bit
+  bool readPdoObject(const PdoObject& pdoObject, bool isAssignment, uint8_t subindex, bool completeAccess,
+                     uint8_t* data, std::size_t size) const;
+  bool writePdoObject(PdoObject& pdoObject, uint16_t index, uint8_t subindex, bool completeAccess,
+                      const uint8_t* data, std::size_t size);
+  // the entries of the fixed mapping objects (e.g. 0x1605), false if there is no such object
+  bool getFixedMapping(uint16_t mappingIndex, std::vector<PdoEntry>& entries) const;
+  bool getMapping(uint16_t mappingIndex, bool isRxPdo, std::vector<PdoEntry>& entries) const;
+  // rebuild the PDO layouts from the assignment, false if it cannot be mapped
+  bool updatePdoLayout(bool isRxPdo, const PdoObject& assignment);
+
+  // CiA 402 state machine
+  void applyControlword(uint16_t controlword, bool immediately);
+  void setDriveState(DriveState driveState, bool immediately);
+  uint16_t getStatusword() const;
+
+  void decodeRxPdo(const uint8_t* rxPdo);
+  void encodeTxPdo(uint8_t* txPdo) const;
+  void stepMotorModel(double timeStep);
+  // [per mille of the motor rated current] <-> [Nm]
+  double currentToTorque(double current) const;
+  double torqueToCurrent(double torque) const;
+
+  SimulatedDriveParameters parameters_;
+  // EC_STATE_INIT until the bus brings the drive to PRE_OP
+  uint16_t ethercatState_{0x01};
+
+  // CiA 402 state machine
+  DriveState driveState_{DriveState::SwitchOnDisabled};
+  // state after the transition delay, NA if no transition is pending
+  DriveState pendingDriveState_{DriveState::NA};
+  unsigned int pendingCycles_{0};
+  uint16_t controlword_{0};
+  bool faultTriggered_{false};
+
+  // object dictionary
+  int8_t modeOfOperation_{0};
+  int32_t targetPosition_{0};
+  int32_t targetVelocity_{0};
+  int16_t targetTorque_{0};
+  int16_t torqueOffset_{0};
+  uint16_t maxTorque_{0};
+  uint16_t maxCurrent_{0xffff};
+  uint32_t motorRatedCurrent_{0};
+  uint32_t motorRatedTorque_{0};
+  PdoObject rxPdoAssignment_;
+  PdoObject txPdoAssignment_;
+  PdoObject rxPdoMapping_;
+  PdoObject txPdoMapping_;
+  PdoLayout rxPdoLayout_;
+  PdoLayout txPdoLayout_;
+
+  // motor model: [rad], [rad / s], [Nm]
+  double position_{0.0};
+  double velocity_{0.0};
+  double torque_{0.0};
+
+  mutable std::mutex mutex_;
+};
+
+}  // namespace elmo
@@ -0,0 +1,64 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "elmo_ethercat_sdk/Elmo.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedDevice.hpp"
+
+namespace elmo {
+
+/*!
+ * @brief	Elmo drive on a SimulatedBus
+ * The SDO transfers of soem_interface go to the mailbox of a real bus and
+ * cannot be redirected, therefore this drive sends them to its
+ * SimulatedDevice (see SimulatedBus::attach). The configuration of the
+ * startup is the one of Elmo, the process data is exchanged through the bus
+ * like for a real drive.
+ */
+class SimulatedElmo : public Elmo {
+ public:
+  typedef std::shared_ptr<SimulatedElmo> SharedPtr;
+
+  SimulatedElmo(const std::string& name, const uint32_t address);
+
+  /*!
+   * Set by SimulatedBus::attach. The device must outlive the drive.
+   */
+  void setSimulatedDevice(SimulatedDevice* simulatedDevice) { simulatedDevice_ = simulatedDevice; }
+
+  // the simulated bus has no EtherCAT state machine and no distributed clock
+  bool runStartupSequence() override;
+  void shutdown() override;
+
+ protected:
+  bool sdoReadBytes(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data, std::size_t size) override;
+  bool sdoWriteBytes(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                     std::size_t size) override;
+
+  SimulatedDevice* simulatedDevice_{nullptr};
+};
+
+}  // namespace elmo
@@ -21,6 +21,7 @@
 #include <iomanip>
 
 #include "elmo_ethercat_sdk/Command.hpp"
+#include "elmo_ethercat_sdk/UnitConversion.hpp"
 
 namespace elmo {
 
@@ -247,20 +248,20 @@ double Command::getTorqueOffset() const {
 
 void Command::doUnitConversion() {
   if (!useRawCommands_) {
-    targetPosition_ = static_cast<int32_t>(positionFactorRadToInteger_ * targetPositionUU_);
-    targetVelocity_ = static_cast<int32_t>(velocityFactorRadPerSecToIntegerPerSec_ * targetVelocityUU_);
-    targetTorque_ = static_cast<int16_t>(torqueFactorNmToInteger_ * targetTorqueUU_);
+    targetPosition_ = saturatingCast<int32_t>(positionFactorRadToInteger_ * targetPositionUU_);
+    targetVelocity_ = saturatingCast<int32_t>(velocityFactorRadPerSecToIntegerPerSec_ * targetVelocityUU_);
+    targetTorque_ = saturatingCast<int16_t>(torqueFactorNmToInteger_ * targetTorqueUU_);
     {
       std::lock_guard<std::mutex> lockGuard(targetTorqueCommandMutex_);
       if (targetTorqueCommandUsed_) {
-        targetCurrent_ = static_cast<int16_t>(torqueFactorNmToInteger_ * targetTorqueUU_);
+        targetCurrent_ = saturatingCast<int16_t>(torqueFactorNmToInteger_ * targetTorqueUU_);
       } else {
-        targetCurrent_ = static_cast<int16_t>(currentFactorAToInteger_ * targetCurrentUU_);
+        targetCurrent_ = saturatingCast<int16_t>(currentFactorAToInteger_ * targetCurrentUU_);
       }
     }
-    maxTorque_ = static_cast<uint16_t>(torqueFactorNmToInteger_ * maxTorqueUU_);
-    maxCurrent_ = static_cast<uint16_t>(currentFactorAToInteger_ * maxCurrentUU_);
-    torqueOffset_ = static_cast<int16_t>(torqueFactorNmToInteger_ * torqueOffsetUU_);
+    maxTorque_ = saturatingCast<uint16_t>(torqueFactorNmToInteger_ * maxTorqueUU_);
+    maxCurrent_ = saturatingCast<uint16_t>(currentFactorAToInteger_ * maxCurrentUU_);
+    torqueOffset_ = saturatingCast<int16_t>(torqueFactorNmToInteger_ * torqueOffsetUU_);
   }
 }
 
@@ -51,6 +51,10 @@ bool Configuration::sanityCheck(bool silent) {
       (driveStateChangeMinTimeout <= driveStateChangeMaxTimeout),
       "drive_state_change_min_timeout ≤ drive_state_change_max_timeout"
     },
+    {
+      (driveStateChangeConfirmationWindow <= driveStateChangeMaxTimeout),
+      "drive_state_change_confirmation_window ≤ drive_state_change_max_timeout"
+    },
     {
       (motorConstant > 0),
       "motor_constant > 0"
@@ -84,6 +88,27 @@ bool Configuration::sanityCheck(bool silent) {
       modeOfOperationEnum == ModeOfOperationEnum::CyclicSynchronousTorqueMode),
     "mode_of_operation ∈ {\"CyclicSynchronousVelocityMode\", \"CyclicSynchronounsTorqueMode\"}"
     },
+    {
+      (rxPdoTypeEnum != RxPdoTypeEnum::RxPdoCustom ||
+        (rxPdoLayout.contains(PdoEntry::Controlword) && rxPdoLayout.isRxPdoLayout())),
+      "rx_pdo_layout contains \"controlword\" and only RxPdo entries"
+    },
+    {
+      (txPdoTypeEnum != TxPdoTypeEnum::TxPdoCustom ||
+        (txPdoLayout.contains(PdoEntry::Statusword) && txPdoLayout.isTxPdoLayout())),
+      "tx_pdo_layout contains \"statusword\" and only TxPdo entries"
+    },
+    {
+      (rxPdoLayout.getSize() <= PdoLayout::maxSize && txPdoLayout.getSize() <= PdoLayout::maxSize &&
+        rxPdoLayout.getEntries().size() <= PdoLayout::maxNumberOfEntries &&
+        txPdoLayout.getEntries().size() <= PdoLayout::maxNumberOfEntries),
+      "rx_pdo_layout / tx_pdo_layout: ≤ " + std::to_string(PdoLayout::maxNumberOfEntries) + " entries, ≤ " +
+      std::to_string(PdoLayout::maxSize) + " bytes"
+    },
+    {
+      !(txPdoLayout.contains(PdoEntry::ActualCurrent) && txPdoLayout.contains(PdoEntry::ActualTorque)),
+      "tx_pdo_layout does not contain both \"actual_current\" and \"actual_torque\""
+    },
   };
 
   std::for_each(sanity_tests.begin(), sanity_tests.end(), check_and_inform);
@@ -123,6 +148,8 @@ std::string rxPdoString(RxPdoTypeEnum rxPdo) {
       return "Rx PDO Standard";
     case RxPdoTypeEnum::RxPdoCST:
       return "Rx PDO CST";
+    case RxPdoTypeEnum::RxPdoCustom:
+      return "Rx PDO Custom";
     default:
       return "Unsupported Type";
   }
@@ -136,6 +163,8 @@ std::string txPdoString(TxPdoTypeEnum txPdo) {
       return "Tx PDO CST";
     case TxPdoTypeEnum::TxPdoStandard:
       return "Tx PDO Standard";
+    case TxPdoTypeEnum::TxPdoCustom:
+      return "Tx PDO Custom";
     default:
       return "Unsupported Type";
   }
@@ -200,6 +229,10 @@ std::ostream& operator<<(std::ostream& os, const Configuration& configuration) {
      << "| " << std::setw(len2) << configuration.driveStateChangeMaxTimeout << "|\n"
      << std::setw(43) << "| Min Successful Target State Readings:"
      << "| " << std::setw(len2) << configuration.minNumberOfSuccessfulTargetStateReadings << "|\n"
+     << std::setw(43) << "| Adaptive Drive State Change:"
+     << "| " << std::setw(len2) << configuration.adaptiveDriveStateChange << "|\n"
+     << std::setw(43) << "| Drive State Change Confirmation Window:"
+     << "| " << std::setw(len2) << configuration.driveStateChangeConfirmationWindow << "|\n"
      << std::setw(43) << "| Force Append Equal Error:"
      << "| " << std::setw(len2) << configuration.forceAppendEqualError << "|\n"
      << std::setw(43) << "| Force Append Equal Fault:"
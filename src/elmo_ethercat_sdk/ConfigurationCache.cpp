@@ -0,0 +1,386 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/ConfigurationCache.hpp"
+#include "elmo_ethercat_sdk/ConfigurationParser.hpp"
+
+#include <message_logger/message_logger.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+
+namespace elmo {
+
+namespace {
+
+// converts to any field of an aggregate
+template <std::size_t>
+struct AnyField {
+  template <typename T>
+  operator T() const;
+};
+
+template <typename T, typename... Fields>
+constexpr auto isBraceInitializable(int) -> decltype(T{std::declval<Fields>()...}, true) {
+  return true;
+}
+
+template <typename T, typename... Fields>
+constexpr bool isBraceInitializable(...) {
+  return false;
+}
+
+template <typename T, std::size_t... Indices>
+constexpr bool isBraceInitializable(std::index_sequence<Indices...> /*indices*/) {
+  return isBraceInitializable<T, AnyField<Indices>...>(0);
+}
+
+// number of fields of an aggregate: the largest number of initializers it accepts
+template <typename T, std::size_t N = 0, bool = isBraceInitializable<T>(std::make_index_sequence<N + 1>())>
+struct NumberOfFields {
+  static constexpr std::size_t value = NumberOfFields<T, N + 1>::value;
+};
+
+template <typename T, std::size_t N>
+struct NumberOfFields<T, N, false> {
+  static constexpr std::size_t value = N;
+};
+
+/*!
+ * Content of a cache file. Increase the version whenever this struct or the
+ * meaning of a field of the Configuration changes.
+ */
+struct CachedConfiguration {
+  static constexpr char magic[8]{'E', 'L', 'M', 'O', 'C', 'F', 'G', 'C'};
+  // see the check of the number of fields of the Configuration below
+  static constexpr uint32_t currentVersion{1};
+
+  char fileMagic[8];
+  uint32_t version;
+  // [bytes] of this struct
+  uint32_t size;
+  // hash of the YAML file
+  uint64_t contentHash;
+  // hash of the fields below
+  uint64_t checksum;
+
+  int8_t modeOfOperationEnum;
+  int8_t rxPdoTypeEnum;
+  int8_t txPdoTypeEnum;
+  uint8_t encoderPosition;
+  uint8_t rxPdoNumberOfEntries;
+  uint8_t txPdoNumberOfEntries;
+  uint8_t rxPdoEntries[PdoLayout::maxNumberOfEntries];
+  uint8_t txPdoEntries[PdoLayout::maxNumberOfEntries];
+  uint8_t printDebugMessages;
+  uint8_t adaptiveDriveStateChange;
+  uint8_t forceAppendEqualError;
+  uint8_t forceAppendEqualFault;
+  uint8_t useRawCommands;
+  uint8_t useMultipleModeOfOperations;
+  uint32_t configRunSdoVerifyTimeout;
+  uint32_t driveStateChangeMinTimeout;
+  uint32_t minNumberOfSuccessfulTargetStateReadings;
+  uint32_t driveStateChangeMaxTimeout;
+  uint32_t driveStateChangeConfirmationWindow;
+  uint32_t errorStorageCapacity;
+  uint32_t faultStorageCapacity;
+  int32_t positionEncoderResolution;
+  int32_t direction;
+  double gearRatio;
+  double motorConstant;
+  double motorRatedCurrentA;
+  double maxCurrentA;
+};
+
+static_assert(std::is_trivially_copyable<CachedConfiguration>::value, "The cache file is copied bytewise");
+// Fails when a field is added to or removed from the Configuration: update CachedConfiguration,
+// encodeConfiguration and decodeConfiguration, increase currentVersion and update this number.
+static_assert(NumberOfFields<Configuration>::value == 25,
+              "The Configuration changed, update CachedConfiguration and its version");
+
+constexpr char CachedConfiguration::magic[];
+constexpr uint32_t CachedConfiguration::currentVersion;
+
+uint64_t hashBytes(const uint8_t* data, std::size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint64_t getChecksum(const CachedConfiguration& cachedConfiguration) {
+  const auto* data = reinterpret_cast<const uint8_t*>(&cachedConfiguration);
+  const std::size_t offset = offsetof(CachedConfiguration, checksum) + sizeof(cachedConfiguration.checksum);
+  return hashBytes(data + offset, sizeof(CachedConfiguration) - offset);
+}
+
+bool encodePdoLayout(const PdoLayout& layout, uint8_t& numberOfEntries, uint8_t* entries) {
+  if (layout.getEntries().size() > PdoLayout::maxNumberOfEntries) {
+    return false;
+  }
+  numberOfEntries = static_cast<uint8_t>(layout.getEntries().size());
+  for (std::size_t i = 0; i < numberOfEntries; i++) {
+    entries[i] = static_cast<uint8_t>(layout.getEntries()[i].entry);
+  }
+  return true;
+}
+
+bool decodePdoLayout(uint8_t numberOfEntries, const uint8_t* entries, PdoLayout& layout) {
+  layout.clear();
+  if (numberOfEntries > PdoLayout::maxNumberOfEntries) {
+    return false;
+  }
+  for (std::size_t i = 0; i < numberOfEntries; i++) {
+    if (entries[i] > static_cast<uint8_t>(PdoEntry::ModeOfOperationDisplay)) {
+      return false;
+    }
+    layout.addEntry(static_cast<PdoEntry>(entries[i]));
+  }
+  return true;
+}
+
+bool encodeConfiguration(const Configuration& configuration, CachedConfiguration& cachedConfiguration) {
+  cachedConfiguration.modeOfOperationEnum = static_cast<int8_t>(configuration.modeOfOperationEnum);
+  cachedConfiguration.rxPdoTypeEnum = static_cast<int8_t>(configuration.rxPdoTypeEnum);
+  cachedConfiguration.txPdoTypeEnum = static_cast<int8_t>(configuration.txPdoTypeEnum);
+  cachedConfiguration.encoderPosition = static_cast<uint8_t>(configuration.encoderPosition);
+  cachedConfiguration.printDebugMessages = configuration.printDebugMessages;
+  cachedConfiguration.adaptiveDriveStateChange = configuration.adaptiveDriveStateChange;
+  cachedConfiguration.forceAppendEqualError = configuration.forceAppendEqualError;
+  cachedConfiguration.forceAppendEqualFault = configuration.forceAppendEqualFault;
+  cachedConfiguration.useRawCommands = configuration.useRawCommands;
+  cachedConfiguration.useMultipleModeOfOperations = configuration.useMultipleModeOfOperations;
+  cachedConfiguration.configRunSdoVerifyTimeout = configuration.configRunSdoVerifyTimeout;
+  cachedConfiguration.driveStateChangeMinTimeout = configuration.driveStateChangeMinTimeout;
+  cachedConfiguration.minNumberOfSuccessfulTargetStateReadings = configuration.minNumberOfSuccessfulTargetStateReadings;
+  cachedConfiguration.driveStateChangeMaxTimeout = configuration.driveStateChangeMaxTimeout;
+  cachedConfiguration.driveStateChangeConfirmationWindow = configuration.driveStateChangeConfirmationWindow;
+  cachedConfiguration.errorStorageCapacity = configuration.errorStorageCapacity;
+  cachedConfiguration.faultStorageCapacity = configuration.faultStorageCapacity;
+  cachedConfiguration.positionEncoderResolution = configuration.positionEncoderResolution;
+  cachedConfiguration.direction = configuration.direction;
+  cachedConfiguration.gearRatio = configuration.gearRatio;
+  cachedConfiguration.motorConstant = configuration.motorConstant;
+  cachedConfiguration.motorRatedCurrentA = configuration.motorRatedCurrentA;
+  cachedConfiguration.maxCurrentA = configuration.maxCurrentA;
+  return encodePdoLayout(configuration.rxPdoLayout, cachedConfiguration.rxPdoNumberOfEntries,
+                         cachedConfiguration.rxPdoEntries) &&
+         encodePdoLayout(configuration.txPdoLayout, cachedConfiguration.txPdoNumberOfEntries,
+                         cachedConfiguration.txPdoEntries);
+}
+
+bool decodeConfiguration(const CachedConfiguration& cachedConfiguration, Configuration& configuration) {
+  configuration.modeOfOperationEnum = static_cast<ModeOfOperationEnum>(cachedConfiguration.modeOfOperationEnum);
+  configuration.rxPdoTypeEnum = static_cast<RxPdoTypeEnum>(cachedConfiguration.rxPdoTypeEnum);
+  configuration.txPdoTypeEnum = static_cast<TxPdoTypeEnum>(cachedConfiguration.txPdoTypeEnum);
+  configuration.encoderPosition = static_cast<Configuration::EncoderPosition>(cachedConfiguration.encoderPosition);
+  configuration.printDebugMessages = cachedConfiguration.printDebugMessages != 0;
+  configuration.adaptiveDriveStateChange = cachedConfiguration.adaptiveDriveStateChange != 0;
+  configuration.forceAppendEqualError = cachedConfiguration.forceAppendEqualError != 0;
+  configuration.forceAppendEqualFault = cachedConfiguration.forceAppendEqualFault != 0;
+  configuration.useRawCommands = cachedConfiguration.useRawCommands != 0;
+  configuration.useMultipleModeOfOperations = cachedConfiguration.useMultipleModeOfOperations != 0;
+  configuration.configRunSdoVerifyTimeout = cachedConfiguration.configRunSdoVerifyTimeout;
+  configuration.driveStateChangeMinTimeout = cachedConfiguration.driveStateChangeMinTimeout;
+  configuration.minNumberOfSuccessfulTargetStateReadings = cachedConfiguration.minNumberOfSuccessfulTargetStateReadings;
+  configuration.driveStateChangeMaxTimeout = cachedConfiguration.driveStateChangeMaxTimeout;
+  configuration.driveStateChangeConfirmationWindow = cachedConfiguration.driveStateChangeConfirmationWindow;
+  configuration.errorStorageCapacity = cachedConfiguration.errorStorageCapacity;
+  configuration.faultStorageCapacity = cachedConfiguration.faultStorageCapacity;
+  configuration.positionEncoderResolution = cachedConfiguration.positionEncoderResolution;
+  configuration.direction = cachedConfiguration.direction;
+  configuration.gearRatio = cachedConfiguration.gearRatio;
+  configuration.motorConstant = cachedConfiguration.motorConstant;
+  configuration.motorRatedCurrentA = cachedConfiguration.motorRatedCurrentA;
+  configuration.maxCurrentA = cachedConfiguration.maxCurrentA;
+  return decodePdoLayout(cachedConfiguration.rxPdoNumberOfEntries, cachedConfiguration.rxPdoEntries,
+                         configuration.rxPdoLayout) &&
+         decodePdoLayout(cachedConfiguration.txPdoNumberOfEntries, cachedConfiguration.txPdoEntries,
+                         configuration.txPdoLayout);
+}
+
+bool readFile(const std::string& fileName, std::string& content) {
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+// mkdir -p
+bool createDirectory(const std::string& directory) {
+  for (std::size_t position = directory.find('/', 1);; position = directory.find('/', position + 1)) {
+    const std::string path = directory.substr(0, position);
+    if (!path.empty() && mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+      return false;
+    }
+    if (position == std::string::npos) {
+      return true;
+    }
+  }
+}
+
+}  // namespace
+
+ConfigurationCache& ConfigurationCache::instance() {
+  static ConfigurationCache configurationCache;
+  return configurationCache;
+}
+
+void ConfigurationCache::setDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  directory_ = directory;
+  if (!directory_.empty() && !createDirectory(directory_)) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:ConfigurationCache::setDirectory] Cannot create '" << directory_
+                      << "': " << std::strerror(errno) << ", the configurations are only cached in memory.");
+    directory_.clear();
+  }
+}
+
+Configuration ConfigurationCache::getConfiguration(const std::string& fileName) {
+  std::string content;
+  if (!readFile(fileName, content)) {
+    // the parser reports the error
+    ConfigurationParser configurationParser(fileName);
+    return configurationParser.getConfiguration();
+  }
+  const uint64_t contentHash = hash(content);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto iterator = configurations_.find(contentHash);
+  if (iterator != configurations_.end()) {
+    return iterator->second;
+  }
+
+  Configuration configuration;
+  if (readCacheFile(contentHash, configuration)) {
+    configurations_.emplace(contentHash, configuration);
+    return configuration;
+  }
+
+  // parse the content which was hashed, the file may have changed meanwhile
+  ConfigurationParser configurationParser(YAML::Load(content));
+  configuration = configurationParser.getConfiguration();
+  Configuration checkedConfiguration = configuration;
+  if (checkedConfiguration.sanityCheck(true)) {
+    configurations_.emplace(contentHash, configuration);
+    writeCacheFile(contentHash, configuration);
+  }
+  return configuration;
+}
+
+void ConfigurationCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  configurations_.clear();
+}
+
+uint64_t ConfigurationCache::hash(const std::string& data) {
+  return hashBytes(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+std::string ConfigurationCache::getCacheFileName(uint64_t contentHash) const {
+  std::stringstream fileName;
+  fileName << directory_ << "/" << std::hex << std::setw(16) << std::setfill('0') << contentHash << ".bin";
+  return fileName.str();
+}
+
+bool ConfigurationCache::readCacheFile(uint64_t contentHash, Configuration& configuration) const {
+  if (directory_.empty()) {
+    return false;
+  }
+  const int fileDescriptor = ::open(getCacheFileName(contentHash).c_str(), O_RDONLY);
+  if (fileDescriptor < 0) {
+    return false;
+  }
+  struct stat fileStatus;
+  void* mapping = MAP_FAILED;
+  if (fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size == sizeof(CachedConfiguration)) {
+    mapping = mmap(nullptr, sizeof(CachedConfiguration), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  }
+  ::close(fileDescriptor);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  // a file of another version or a corrupted file is overwritten by the parsed configuration
+  const auto& cachedConfiguration = *static_cast<const CachedConfiguration*>(mapping);
+  const bool success =
+      std::memcmp(cachedConfiguration.fileMagic, CachedConfiguration::magic, sizeof(CachedConfiguration::magic)) == 0 &&
+      cachedConfiguration.version == CachedConfiguration::currentVersion &&
+      cachedConfiguration.size == sizeof(CachedConfiguration) && cachedConfiguration.contentHash == contentHash &&
+      cachedConfiguration.checksum == getChecksum(cachedConfiguration) &&
+      decodeConfiguration(cachedConfiguration, configuration);
+  munmap(mapping, sizeof(CachedConfiguration));
+  return success;
+}
+
+void ConfigurationCache::writeCacheFile(uint64_t contentHash, const Configuration& configuration) const {
+  if (directory_.empty()) {
+    return;
+  }
+  CachedConfiguration cachedConfiguration;
+  std::memset(&cachedConfiguration, 0, sizeof(cachedConfiguration));
+  if (!encodeConfiguration(configuration, cachedConfiguration)) {
+    return;
+  }
+  std::memcpy(cachedConfiguration.fileMagic, CachedConfiguration::magic, sizeof(CachedConfiguration::magic));
+  cachedConfiguration.version = CachedConfiguration::currentVersion;
+  cachedConfiguration.size = sizeof(CachedConfiguration);
+  cachedConfiguration.contentHash = contentHash;
+  cachedConfiguration.checksum = getChecksum(cachedConfiguration);
+
+  // write a temporary file and rename it, such that other processes never map a partial file
+  const std::string fileName = getCacheFileName(contentHash);
+  const std::string temporaryFileName = fileName + "." + std::to_string(getpid());
+  {
+    std::ofstream file(temporaryFileName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&cachedConfiguration), sizeof(cachedConfiguration));
+    if (!file) {
+      MELO_WARN_STREAM("[elmo_ethercat_sdk:ConfigurationCache::writeCacheFile] Cannot write '" << temporaryFileName
+                       << "'.");
+      std::remove(temporaryFileName.c_str());
+      return;
+    }
+  }
+  if (std::rename(temporaryFileName.c_str(), fileName.c_str()) != 0) {
+    MELO_WARN_STREAM("[elmo_ethercat_sdk:ConfigurationCache::writeCacheFile] Cannot write '" << fileName
+                     << "': " << std::strerror(errno));
+    std::remove(temporaryFileName.c_str());
+  }
+}
+
+}  // namespace elmo
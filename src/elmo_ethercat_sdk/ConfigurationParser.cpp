@@ -73,6 +73,9 @@ bool getRxPdoFromFile(YAML::Node& yamlNode, const std::string& varName, RxPdoTyp
     } else if (str == "RxPdoCST") {
       rxPdo = RxPdoTypeEnum::RxPdoCST;
       return true;
+    } else if (str == "RxPdoCustom") {
+      rxPdo = RxPdoTypeEnum::RxPdoCustom;
+      return true;
     } else {
       MELO_ERROR_STREAM("[elmo_ethercat_sdk:ConfigurationParser::getRxPdoFromFile] Unsupported Rx PDO Type");
       return false;
@@ -109,6 +112,9 @@ bool getTxPdoFromFile(YAML::Node& yamlNode, const std::string& varName, TxPdoTyp
     } else if (str == "TxPdoStandard") {
       txPdo = TxPdoTypeEnum::TxPdoStandard;
       return true;
+    } else if (str == "TxPdoCustom") {
+      txPdo = TxPdoTypeEnum::TxPdoCustom;
+      return true;
     } else {
       MELO_ERROR_STREAM("[elmo_ethercat_sdk:ConfigurationParser::getTxPdoFromFile] Unsupported Tx PDO Type");
       return false;
@@ -121,6 +127,38 @@ bool getTxPdoFromFile(YAML::Node& yamlNode, const std::string& varName, TxPdoTyp
   }
 }
 
+/*!
+ * Function to read the layout of a custom PDO from the yaml file
+ * @param[in] yamlNode	the node containing the requested value
+ * @param [in] varName	The name of the variable
+ * @param [out] pdoLayout	The read layout, a sequence of PDO entry names
+ * @return	true on success
+ */
+bool getPdoLayoutFromFile(YAML::Node& yamlNode, const std::string& varName, PdoLayout& pdoLayout) {
+  if (!yamlNode[varName].IsDefined()) {
+    return false;
+  }
+  try {
+    PdoLayout tmpPdoLayout;
+    for (const auto& entryNode : yamlNode[varName]) {
+      const std::string str = entryNode.as<std::string>();
+      PdoEntry entry;
+      if (!PdoLayout::getEntryFromName(str, entry)) {
+        MELO_ERROR_STREAM("[elmo_ethercat_sdk:ConfigurationParser::getPdoLayoutFromFile] Unsupported PDO entry '"
+                          << str << "' in \"" << varName << "\"");
+        return false;
+      }
+      tmpPdoLayout.addEntry(entry);
+    }
+    pdoLayout = tmpPdoLayout;
+    return true;
+  } catch (...) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:ConfigurationParser::getPdoLayoutFromFile] Error while parsing value \""
+                      << varName << "\", default values will be used");
+    return false;
+  }
+}
+
 /*!
  * Function to read a Mode of Operation enum from the yaml file
  * @param[in] yamlNode	the node containing the requested value
@@ -252,6 +290,16 @@ void ConfigurationParser::parseConfiguration(YAML::Node configNode) {
     if (getValueFromFile(elmoNode, "drive_state_change_max_timeout", driveStateChangeMaxTimeout)) {
       configuration_.driveStateChangeMaxTimeout = driveStateChangeMaxTimeout ;
     }
+
+    bool adaptiveDriveStateChange;
+    if (getValueFromFile(elmoNode, "adaptive_drive_state_change", adaptiveDriveStateChange)) {
+      configuration_.adaptiveDriveStateChange = adaptiveDriveStateChange ;
+    }
+
+    unsigned int driveStateChangeConfirmationWindow;
+    if (getValueFromFile(elmoNode, "drive_state_change_confirmation_window", driveStateChangeConfirmationWindow)) {
+      configuration_.driveStateChangeConfirmationWindow = driveStateChangeConfirmationWindow ;
+    }
   }
 
   /// The configuration options for the elmo::ethercat::Reading class
@@ -293,6 +341,16 @@ void ConfigurationParser::parseConfiguration(YAML::Node configNode) {
       configuration_.txPdoTypeEnum = txPdo ;
     }
 
+    PdoLayout rxPdoLayout;
+    if (getPdoLayoutFromFile(hardwareNode, "rx_pdo_layout", rxPdoLayout)) {
+      configuration_.rxPdoLayout = rxPdoLayout;
+    }
+
+    PdoLayout txPdoLayout;
+    if (getPdoLayoutFromFile(hardwareNode, "tx_pdo_layout", txPdoLayout)) {
+      configuration_.txPdoLayout = txPdoLayout;
+    }
+
     ModeOfOperationEnum modeOfOperation_;
     if (getModeFromFile(hardwareNode, "mode_of_operation", modeOfOperation_)) {
       configuration_.modeOfOperationEnum = modeOfOperation_ ;
@@ -0,0 +1,68 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _USE_MATH_DEFINES  // for M_PI
+#include <cmath>
+
+#include "elmo_ethercat_sdk/ConversionTable.hpp"
+
+namespace elmo {
+
+ConversionTable::ConversionTable(const Configuration& configuration) {
+  const double resolution = static_cast<double>(configuration.positionEncoderResolution);
+
+  if (configuration.encoderPosition == Configuration::EncoderPosition::joint) {
+    positionFactorIntegerToRad_ = (2.0 * M_PI) / resolution;
+    velocityFactorIntegerPerSecToRadPerSec_ = (2.0 * M_PI) / resolution;
+    positionFactorRadToInteger_ = resolution / (2.0 * M_PI);
+    velocityFactorRadPerSecToIntegerPerSec_ = resolution / (2.0 * M_PI);
+  } else if (configuration.encoderPosition == Configuration::EncoderPosition::motor) {
+    positionFactorIntegerToRad_ = (2.0 * M_PI) / resolution / configuration.gearRatio;
+    velocityFactorIntegerPerSecToRadPerSec_ = (2.0 * M_PI) / resolution / configuration.gearRatio;
+    positionFactorRadToInteger_ = resolution / (2.0 * M_PI) * configuration.gearRatio;
+    velocityFactorRadPerSecToIntegerPerSec_ = resolution / (2.0 * M_PI) * configuration.gearRatio;
+  } else {
+    // no position / velocity commands without a valid encoder position
+    positionFactorRadToInteger_ = 0.0;
+    velocityFactorRadPerSecToIntegerPerSec_ = 0.0;
+  }
+
+  currentFactorIntegerToAmp_ = configuration.motorRatedCurrentA / 1000.0;
+  torqueFactorIntegerToNm_ = currentFactorIntegerToAmp_ * configuration.motorConstant * configuration.gearRatio;
+
+  maxCurrent_ = configuration.maxCurrentA;
+  maxTorque_ = configuration.maxCurrentA * configuration.motorConstant * configuration.gearRatio;
+
+  // the motor rated current may only be known after reading it from the drive
+  // (see Elmo::startup), no current / torque commands until then
+  if (configuration.motorRatedCurrentA > 0.0) {
+    currentFactorAToInteger_ = 1000.0 / configuration.motorRatedCurrentA;
+    torqueFactorNmToInteger_ = currentFactorAToInteger_ / configuration.motorConstant / configuration.gearRatio;
+  } else {
+    currentFactorAToInteger_ = 0.0;
+    torqueFactorNmToInteger_ = 0.0;
+  }
+  maxCurrentRaw_ = saturatingCast<uint16_t>(currentFactorAToInteger_ * maxCurrent_);
+  maxTorqueRaw_ = saturatingCast<uint16_t>(torqueFactorNmToInteger_ * maxTorque_);
+
+  direction_ = configuration.direction;
+}
+
+}  // namespace elmo
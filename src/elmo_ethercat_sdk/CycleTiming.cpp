@@ -0,0 +1,133 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/CycleTiming.hpp"
+
+#include <algorithm>
+
+std::ostream& operator<<(std::ostream& os, const elmo::CycleStatistics& statistics) {
+  os << "count: " << statistics.count << ", overruns: " << statistics.overruns
+     << ", min: " << statistics.min.count() / 1000.0 << " us, p50: " << statistics.p50.count() / 1000.0
+     << " us, p99: " << statistics.p99.count() / 1000.0 << " us, p99.9: " << statistics.p999.count() / 1000.0
+     << " us, max: " << statistics.max.count() / 1000.0 << " us";
+  return os;
+}
+
+namespace elmo {
+
+constexpr std::size_t CycleHistogram::subBucketBits_;
+constexpr std::size_t CycleHistogram::numberOfBuckets_;
+
+CycleHistogram::CycleHistogram() {
+  clear();
+}
+
+std::size_t CycleHistogram::getBucketIndex(uint64_t value) {
+  constexpr uint64_t subBuckets = 1 << subBucketBits_;
+  if (value < subBuckets) {
+    return static_cast<std::size_t>(value);
+  }
+  const std::size_t exponent = 63 - __builtin_clzll(value);
+  const std::size_t index = ((exponent - subBucketBits_ + 1) << subBucketBits_) +
+                            static_cast<std::size_t>((value >> (exponent - subBucketBits_)) & (subBuckets - 1));
+  return std::min(index, numberOfBuckets_ - 1);
+}
+
+uint64_t CycleHistogram::getBucketUpperBound(std::size_t index) {
+  constexpr uint64_t subBuckets = 1 << subBucketBits_;
+  if (index < subBuckets) {
+    return index;
+  }
+  const std::size_t shift = (index >> subBucketBits_) - 1;
+  const uint64_t lowerBound = (subBuckets + (index & (subBuckets - 1))) << shift;
+  return lowerBound + (uint64_t(1) << shift) - 1;
+}
+
+void CycleHistogram::clear() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  overruns_.store(0, std::memory_order_relaxed);
+  min_.store(UINT64_MAX, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+void CycleHistogram::record(std::chrono::nanoseconds value) {
+  if (resetRequested_.load(std::memory_order_relaxed)) {
+    resetRequested_.store(false, std::memory_order_relaxed);
+    clear();
+  }
+
+  // single writer: plain load / store instead of read-modify-write operations
+  const uint64_t nanoseconds = value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0;
+  auto& bucket = buckets_[getBucketIndex(nanoseconds)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  if (nanoseconds < min_.load(std::memory_order_relaxed)) {
+    min_.store(nanoseconds, std::memory_order_relaxed);
+  }
+  if (nanoseconds > max_.load(std::memory_order_relaxed)) {
+    max_.store(nanoseconds, std::memory_order_relaxed);
+  }
+  const int64_t overrunThreshold = overrunThreshold_.load(std::memory_order_relaxed);
+  if (overrunThreshold > 0 && value.count() > overrunThreshold) {
+    overruns_.store(overruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+}
+
+CycleStatistics CycleHistogram::getStatistics() const {
+  CycleStatistics statistics;
+  statistics.count = count_.load(std::memory_order_relaxed);
+  statistics.overruns = overruns_.load(std::memory_order_relaxed);
+  if (statistics.count == 0) {
+    return statistics;
+  }
+  const uint64_t min = min_.load(std::memory_order_relaxed);
+  const uint64_t max = max_.load(std::memory_order_relaxed);
+  statistics.min = std::chrono::nanoseconds(min == UINT64_MAX ? 0 : min);
+  statistics.max = std::chrono::nanoseconds(max);
+
+  // the writer may add values while the buckets are copied, use the copied total
+  std::array<uint64_t, numberOfBuckets_> buckets;
+  uint64_t total = 0;
+  for (std::size_t i = 0; i < numberOfBuckets_; i++) {
+    buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += buckets[i];
+  }
+
+  auto percentile = [&](double fraction) {
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * total + 0.5));
+    uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < numberOfBuckets_; i++) {
+      cumulative += buckets[i];
+      if (cumulative >= rank) {
+        return std::chrono::nanoseconds(std::min(getBucketUpperBound(i), max));
+      }
+    }
+    return statistics.max;
+  };
+  statistics.p50 = percentile(0.5);
+  statistics.p99 = percentile(0.99);
+  statistics.p999 = percentile(0.999);
+  return statistics;
+}
+
+}  // namespace elmo
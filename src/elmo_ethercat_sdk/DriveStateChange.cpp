@@ -0,0 +1,70 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/DriveStateChange.hpp"
+#include "elmo_ethercat_sdk/Elmo.hpp"
+
+#include <thread>
+
+namespace elmo {
+
+DriveStateChangeStatus DriveStateChangeHandle::getStatus() const {
+  if (elmo_ == nullptr) {
+    return DriveStateChangeStatus::Invalid;
+  }
+  return elmo_->getDriveStateChangeStatus(sequenceNumber_);
+}
+
+bool DriveStateChangeHandle::isFinished() const {
+  return getStatus() != DriveStateChangeStatus::Pending;
+}
+
+DriveStateChangeStatus DriveStateChangeHandle::waitFor(const std::chrono::microseconds& timeout) const {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  DriveStateChangeStatus status = getStatus();
+  while (status == DriveStateChangeStatus::Pending && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+    status = getStatus();
+  }
+  return status;
+}
+
+}  // namespace elmo
+
+std::ostream& operator<<(std::ostream& os, const elmo::DriveStateChangeStatus& status) {
+  switch (status) {
+    case elmo::DriveStateChangeStatus::Pending:
+      os << "Pending";
+      break;
+    case elmo::DriveStateChangeStatus::Succeeded:
+      os << "Succeeded";
+      break;
+    case elmo::DriveStateChangeStatus::TimedOut:
+      os << "TimedOut";
+      break;
+    case elmo::DriveStateChangeStatus::Superseded:
+      os << "Superseded";
+      break;
+    case elmo::DriveStateChangeStatus::Invalid:
+      os << "Invalid";
+      break;
+  }
+  return os;
+}
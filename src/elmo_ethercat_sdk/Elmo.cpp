@@ -19,17 +19,114 @@
  */
 
 #include "elmo_ethercat_sdk/Elmo.hpp"
+#include "elmo_ethercat_sdk/ConfigurationCache.hpp"
 #include "elmo_ethercat_sdk/ConfigurationParser.hpp"
 #include "elmo_ethercat_sdk/ObjectDictionary.hpp"
+#include "elmo_ethercat_sdk/PdoAssignment.hpp"
+#include "elmo_ethercat_sdk/PdoCodec.hpp"
 #include "elmo_ethercat_sdk/RxPdo.hpp"
+#include "elmo_ethercat_sdk/StateTransitionTable.hpp"
 #include "elmo_ethercat_sdk/TxPdo.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <cstring>
 #include <thread>
 #include <chrono>
 #include <stdexcept>
+#include <utility>
 
 namespace elmo{
+  namespace {
+    // the bus reads / writes PDO structs whose size matches the process image,
+    // the custom PDOs are copied through a byte array of the size of the layout
+    template <std::size_t Size>
+    void readTxPdoBytes(soem_interface::EthercatBusBase& bus, uint16_t address, uint8_t* data){
+      std::array<uint8_t, Size> txPdo;
+      bus.readTxPdo(address, txPdo);
+      std::memcpy(data, txPdo.data(), Size);
+    }
+    template <>
+    void readTxPdoBytes<0>(soem_interface::EthercatBusBase&, uint16_t, uint8_t*){}
+
+    template <std::size_t Size>
+    void writeRxPdoBytes(soem_interface::EthercatBusBase& bus, uint16_t address, const uint8_t* data){
+      std::array<uint8_t, Size> rxPdo;
+      std::memcpy(rxPdo.data(), data, Size);
+      bus.writeRxPdo(address, rxPdo);
+    }
+    template <>
+    void writeRxPdoBytes<0>(soem_interface::EthercatBusBase&, uint16_t, const uint8_t*){}
+
+    template <std::size_t... Sizes>
+    constexpr std::array<Elmo::ReadTxPdoBytesFunction, sizeof...(Sizes)>
+    makeReadTxPdoBytesFunctions(std::index_sequence<Sizes...>){
+      return {{&readTxPdoBytes<Sizes>...}};
+    }
+    template <std::size_t... Sizes>
+    constexpr std::array<Elmo::WriteRxPdoBytesFunction, sizeof...(Sizes)>
+    makeWriteRxPdoBytesFunctions(std::index_sequence<Sizes...>){
+      return {{&writeRxPdoBytes<Sizes>...}};
+    }
+
+    // indexed by the size of the PDO layout
+    constexpr auto readTxPdoBytesFunctions =
+      makeReadTxPdoBytesFunctions(std::make_index_sequence<PdoLayout::maxSize + 1>());
+    constexpr auto writeRxPdoBytesFunctions =
+      makeWriteRxPdoBytesFunctions(std::make_index_sequence<PdoLayout::maxSize + 1>());
+
+    // the mailbox of the bus transfers SDO values of a fixed size, the byte arrays of
+    // Elmo::sdoReadBytes / sdoWriteBytes are copied through an array of that size
+    using SdoReadBytesFunction = bool (*)(soem_interface::EthercatSlaveBase&, uint16_t, uint8_t, bool, uint8_t*);
+    using SdoWriteBytesFunction =
+      bool (*)(soem_interface::EthercatSlaveBase&, uint16_t, uint8_t, bool, const uint8_t*);
+
+    // largest SDO transfer, e.g. the complete access upload of a PDO assignment
+    constexpr std::size_t sdoMaxSize = 32;
+
+    template <std::size_t Size>
+    bool sdoReadBytes(soem_interface::EthercatSlaveBase& slave, uint16_t index, uint8_t subindex,
+                      bool completeAccess, uint8_t* data){
+      std::array<uint8_t, Size> value{};
+      if(!slave.sendSdoRead(index, subindex, completeAccess, value)){
+        return false;
+      }
+      std::memcpy(data, value.data(), Size);
+      return true;
+    }
+    template <>
+    bool sdoReadBytes<0>(soem_interface::EthercatSlaveBase&, uint16_t, uint8_t, bool, uint8_t*){ return false; }
+
+    template <std::size_t Size>
+    bool sdoWriteBytes(soem_interface::EthercatSlaveBase& slave, uint16_t index, uint8_t subindex,
+                       bool completeAccess, const uint8_t* data){
+      std::array<uint8_t, Size> value;
+      std::memcpy(value.data(), data, Size);
+      return slave.sendSdoWrite(index, subindex, completeAccess, value);
+    }
+    template <>
+    bool sdoWriteBytes<0>(soem_interface::EthercatSlaveBase&, uint16_t, uint8_t, bool, const uint8_t*){
+      return false;
+    }
+
+    template <std::size_t... Sizes>
+    constexpr std::array<SdoReadBytesFunction, sizeof...(Sizes)>
+    makeSdoReadBytesFunctions(std::index_sequence<Sizes...>){
+      return {{&sdoReadBytes<Sizes>...}};
+    }
+    template <std::size_t... Sizes>
+    constexpr std::array<SdoWriteBytesFunction, sizeof...(Sizes)>
+    makeSdoWriteBytesFunctions(std::index_sequence<Sizes...>){
+      return {{&sdoWriteBytes<Sizes>...}};
+    }
+
+    // indexed by the size of the SDO value
+    constexpr auto sdoReadBytesFunctions = makeSdoReadBytesFunctions(std::make_index_sequence<sdoMaxSize + 1>());
+    constexpr auto sdoWriteBytesFunctions = makeSdoWriteBytesFunctions(std::make_index_sequence<sdoMaxSize + 1>());
+  } // namespace
+
   std::string binstring(uint16_t var){
     std::string s = "0000000000000000";
     for(int i = 0; i < 16; i++){
@@ -59,60 +156,83 @@ namespace elmo{
     return elmo;
   }
 
+  constexpr unsigned int Elmo::sdoMaxNumberOfAttempts_;
+  constexpr unsigned int Elmo::sdoRetryInitialBackoff_;
+
   Elmo::Elmo(const std::string& name, const uint32_t address){
     address_ = address;
     name_ = name;
   }
 
   bool Elmo::startup(){
+    if(startupOrchestrator_){
+      return startupOrchestrator_->startup(this);
+    }
+    return runStartupSequence();
+  }
+
+  void Elmo::setStartupOrchestrator(const StartupOrchestrator::SharedPtr& startupOrchestrator){
+    startupOrchestrator_ = startupOrchestrator;
+  }
+
+  bool Elmo::runStartupSequence(){
     bool success = true;
     success &= bus_->waitForState(EC_STATE_PRE_OP, address_, 50, 0.05);
     bus_->syncDistributedClock0(address_, true, timeStep_, timeStep_/2.f);
+    setDefaultCycleOverrunThresholds();
+    // settling time after the distributed clock sync
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    success &= configureDriveViaSdo();
+    return success;
+  }
+
+  bool Elmo::configureDriveViaSdo(){
+    bool success = true;
 
     // use hardware motor rated current value if necessary
     // TODO test
     if(configuration_.motorRatedCurrentA == 0.0){
       uint32_t motorRatedCurrent;
-      success &= sendSdoRead(OD_INDEX_MOTOR_RATED_CURRENT, 0, false, motorRatedCurrent);
+      success &= sdoRead(OD_INDEX_MOTOR_RATED_CURRENT, 0, false, motorRatedCurrent);
       // update the configuration to accomodate the new motor rated current value
       configuration_.motorRatedCurrentA = static_cast<double>(motorRatedCurrent)/1000.0 ;
-      // update the reading_ object to ensure correct unit conversion
-      reading_.configureReading(configuration_);
+      // update the conversion factors of readings and commands
+      updateConversionTable();
     }
     success &= setDriveStateViaSdo(DriveState::ReadyToSwitchOn);
     // PDO mapping
     success &= mapPdos(configuration_.rxPdoTypeEnum, configuration_.txPdoTypeEnum);
     // Set initial mode of operation
-    success &= sdoVerifyWrite(OD_INDEX_MODES_OF_OPERATION,
-                              0,
-                              false, static_cast<int8_t>(configuration_.modeOfOperationEnum),
-                              configuration_.configRunSdoVerifyTimeout);
+    success &= sdoWriteVerified(OD_INDEX_MODES_OF_OPERATION, 0,
+                                static_cast<int8_t>(configuration_.modeOfOperationEnum));
     // To be on the safe side: set currect PDO sizes
     autoConfigurePdoSizes();
 
     // write the motor rated current / torque to the drives
     uint32_t motorRatedCurrent = static_cast<uint32_t>(
       round(1000.0 * configuration_.motorRatedCurrentA));
-    success &= sdoVerifyWrite(OD_INDEX_MOTOR_RATED_CURRENT, 0, false, motorRatedCurrent);
-    success &= sdoVerifyWrite(OD_INDEX_MOTOR_RATED_TORQUE, 0, false, motorRatedCurrent);
+    success &= sdoWriteVerified(OD_INDEX_MOTOR_RATED_CURRENT, 0, motorRatedCurrent);
+    success &= sdoWriteVerified(OD_INDEX_MOTOR_RATED_TORQUE, 0, motorRatedCurrent);
 
     // Write maximum current to drive
     uint16_t maxCurrent = static_cast<uint16_t>(floor(1000.0 * configuration_.maxCurrentA));
-    success &= sdoVerifyWrite(OD_INDEX_MAX_CURRENT, 0, false, maxCurrent);
+    success &= sdoWriteVerified(OD_INDEX_MAX_CURRENT, 0, maxCurrent);
 
     // Actual voltage on 5v bus (e.g. for connected analog sensors)
     uint16_t actual5vVoltage = 5000;
-    success &= sendSdoRead(OD_INDEX_5VDC_SUPPLY, 0, false, actual5vVoltage); // [mV]
+    success &= sdoRead(OD_INDEX_5VDC_SUPPLY, 0, false, actual5vVoltage); // [mV]
     actual5vVoltage_ = static_cast<double>(actual5vVoltage)/1000.0; // [V]
 
     if(!success){
       MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::preStartupOnlineConfiguration] hardware configuration of '"
                         << name_ <<"' not successful!");
       addErrorToReading(ErrorType::ConfigurationError);
+      return false;
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    return success;
+    // the state transitions written above are executed asynchronously by the drive. a drive which
+    // is not ReadyToSwitchOn yet is reported, but does not fail the startup.
+    waitForDriveStateViaSdo(DriveState::ReadyToSwitchOn);
+    return true;
   }
 
   void Elmo::shutdown(){
@@ -121,135 +241,271 @@ namespace elmo{
 
   void Elmo::updateWrite(){
     std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const auto start = std::chrono::steady_clock::now();
+    updateWriteInternal();
+    updateWriteHistogram_.record(std::chrono::steady_clock::now() - start);
+  }
+
+  void Elmo::updateWriteInternal(){
+
+    // most recent command, already converted to raw units by stageCommand
+    const RxPdoStandard& stagedCommand = stagedCommand_.read();
 
     /*
     ** Check if the Mode of Operation has been set properly
     */
-    if (modeOfOperation_ == ModeOfOperationEnum::NA) {
-      reading_.addError(ErrorType::ModeOfOperationError);
-      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::updateWrite] Mode of operation for '"
-                        << name_ << "' has not been set.");
+    const bool modeOfOperationNotSet =
+      static_cast<ModeOfOperationEnum>(stagedCommand.modeOfOperation_) == ModeOfOperationEnum::NA;
+    if (modeOfOperationNotSetLog_.update(modeOfOperationNotSet, name_)) {
+      addErrorToReading(ErrorType::ModeOfOperationError);
+    }
+    if (modeOfOperationNotSet) {
       return;
     }
 
     /*!
-    * engage the state machine if a state change is requested
+    * take over state change requests and engage the state machine
     */
-    if (conductStateChange_ && hasRead_) {
-      engagePdoStateMachine();
-    }
-
-    switch (configuration_.rxPdoTypeEnum) {
-      case RxPdoTypeEnum::RxPdoStandard: {
-        RxPdoStandard rxPdo{};
-        rxPdo.targetPosition_ = stagedCommand_.getTargetPositionRaw() * configuration_.direction;
-        rxPdo.targetVelocity_ = stagedCommand_.getTargetVelocityRaw() * configuration_.direction;
-        rxPdo.targetTorque_ = stagedCommand_.getTargetTorqueRaw() * configuration_.direction;
-        rxPdo.maxTorque_ = stagedCommand_.getMaxTorqueRaw();
-        rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-        rxPdo.torqueOffset_ = stagedCommand_.getTorqueOffsetRaw() * configuration_.direction;
-        rxPdo.controlWord_ = controlword_.getRawControlword();
-
-        // actually writing to the hardware
-        bus_->writeRxPdo(address_, rxPdo);
-      } break;
-      case RxPdoTypeEnum::RxPdoCST: {
-        RxPdoCST rxPdo{};
-        rxPdo.targetTorque_ = stagedCommand_.getTargetTorqueRaw() * configuration_.direction;
-        rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
-        rxPdo.controlWord_ = controlword_.getRawControlword();
-
-        // actually writing to the hardware
-        bus_->writeRxPdo(address_, rxPdo);
-      } break;
+    engagePdoStateMachine();
 
-      default:
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::updateWrite] Unsupported Rx Pdo type for '"
-                        << name_ << "'");
-        addErrorToReading(ErrorType::RxPdoTypeError);
+    // actually writing to the hardware
+    const bool rxPdoTypeSupported = (this->*writeRxPdoFunction_)(stagedCommand);
+    if (unsupportedRxPdoTypeLog_.update(!rxPdoTypeSupported, name_,
+                                        static_cast<int32_t>(configuration_.rxPdoTypeEnum))) {
+      addErrorToReading(ErrorType::RxPdoTypeError);
     }
-
   }
 
   void Elmo::updateRead(){
     std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const auto start = std::chrono::steady_clock::now();
+    if (lastUpdateReadTimePoint_ != std::chrono::steady_clock::time_point()) {
+      readPeriodHistogram_.record(start - lastUpdateReadTimePoint_);
+    }
+    lastUpdateReadTimePoint_ = start;
+    updateReadInternal(cycleClock_ == nullptr ? start : cycleClock_->now());
+    updateReadHistogram_.record(std::chrono::steady_clock::now() - start);
+  }
 
-    // TODO(duboisf): implement some sort of time stamp
-    switch (configuration_.txPdoTypeEnum) {
-      case TxPdoTypeEnum::TxPdoStandard: {
-        TxPdoStandard txPdo{};
-        // reading from the bus
-        bus_->readTxPdo(address_, txPdo);
-        reading_.setActualPosition(txPdo.actualPosition_ * configuration_.direction);
-        reading_.setDigitalInputs(txPdo.digitalInputs_);
-        reading_.setActualVelocity(txPdo.actualVelocity_ * configuration_.direction);
-        reading_.setStatusword(txPdo.statusword_);
-        reading_.setAnalogInput(txPdo.analogInput_);
-        reading_.setActualCurrent(txPdo.actualCurrent_ * configuration_.direction);
-        reading_.setBusVoltage(txPdo.busVoltage_);
-      } break;
-      case TxPdoTypeEnum::TxPdoCST: {
-        TxPdoCST txPdo{};
-        // reading from the bus
-        bus_->readTxPdo(address_, txPdo);
-        reading_.setActualPosition(txPdo.actualPosition_ * configuration_.direction);
-        reading_.setActualCurrent(txPdo.actualTorque_ * configuration_.direction);  /// torque readings are actually current readings,
-                                                        /// the conversion is handled later
-        reading_.setStatusword(txPdo.statusword_);
-        reading_.setActualVelocity(txPdo.actualVelocity_ * configuration_.direction);
-      } break;
+  void Elmo::updateReadInternal(const std::chrono::steady_clock::time_point& timePoint){
+    // reading from the bus
+    const bool txPdoTypeSupported = (this->*readTxPdoFunction_)();
+    if (unsupportedTxPdoTypeLog_.update(!txPdoTypeSupported, name_,
+                                        static_cast<int32_t>(configuration_.txPdoTypeEnum))) {
+      addErrorToReading(ErrorType::TxPdoTypeError);
+    }
 
-      default:
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::updateRrite] Unsupported Tx Pdo type for '"
-                        << name_ << "'");
-        reading_.addError(ErrorType::TxPdoTypeError);
+    readingSnapshot_.setTimePoint(timePoint);
+
+    if (telemetryChannel_ != nullptr) {
+      const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint.time_since_epoch());
+      telemetryChannel_->push({timestamp.count(),
+                               readingSnapshot_.getActualPositionRaw(),
+                               readingSnapshot_.getActualVelocityRaw(),
+                               readingSnapshot_.getActualCurrentRaw(),
+                               readingSnapshot_.getRawStatusword(),
+                               readingSnapshot_.getBusVoltageRaw()});
     }
 
+    // make the new process data available to the readers
+    publishedReading_.store(readingSnapshot_);
+
     // set the hasRead_ variable to true since a nes reading was read
     if (!hasRead_) {
       hasRead_ = true;
     }
 
-    // Print warning if drive is in Fault state.
-    if (reading_.getDriveState() == DriveState::Fault) {
-      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::updateRead] '"
-                        << name_ << "' is in drive state 'Fault'");
+    // Report entering (and leaving) the Fault state, formatted outside of the bus thread.
+    driveInFaultLog_.update(readingSnapshot_.getDriveState() == DriveState::Fault, name_,
+                            readingSnapshot_.getRawStatusword());
+  }
+
+  template <typename TxPdo>
+  bool Elmo::readTxPdo(){
+    TxPdo txPdo;
+    bus_->readTxPdo(address_, txPdo);
+    recordPdo(PdoRecord::Type::TxPdo, reinterpret_cast<const uint8_t*>(&txPdo), sizeof(txPdo));
+    PdoCodec<TxPdo>::decode(txPdo, conversionTable_.getDirection(), readingSnapshot_);
+    return true;
+  }
+
+  bool Elmo::readCustomTxPdo(){
+    std::array<uint8_t, PdoLayout::maxSize> txPdo;
+    readTxPdoBytesFunction_(*bus_, address_, txPdo.data());
+    recordPdo(PdoRecord::Type::TxPdo, txPdo.data(), configuration_.txPdoLayout.getSize());
+    configuration_.txPdoLayout.decodeTxPdo(txPdo.data(), conversionTable_.getDirection(), readingSnapshot_);
+    return true;
+  }
+
+  template <typename TxPdo>
+  bool Elmo::readTxPdoInPlace(){
+    recordPdo(PdoRecord::Type::TxPdo, processImageInputs_, PdoCodec<TxPdo>::size);
+    PdoCodec<TxPdo>::decode(processImageInputs_, conversionTable_.getDirection(), readingSnapshot_);
+    return true;
+  }
+
+  bool Elmo::readCustomTxPdoInPlace(){
+    recordPdo(PdoRecord::Type::TxPdo, processImageInputs_, configuration_.txPdoLayout.getSize());
+    configuration_.txPdoLayout.decodeTxPdo(processImageInputs_, conversionTable_.getDirection(), readingSnapshot_);
+    return true;
+  }
+
+  template <typename RxPdo>
+  bool Elmo::writeRxPdo(const RxPdoStandard& stagedCommand){
+    RxPdo rxPdo;
+    PdoCodec<RxPdo>::encode(stagedCommand, rawControlword_, rxPdo);
+    recordPdo(PdoRecord::Type::RxPdo, reinterpret_cast<const uint8_t*>(&rxPdo), sizeof(rxPdo));
+    bus_->writeRxPdo(address_, rxPdo);
+    return true;
+  }
+
+  bool Elmo::writeCustomRxPdo(const RxPdoStandard& stagedCommand){
+    std::array<uint8_t, PdoLayout::maxSize> rxPdo;
+    configuration_.rxPdoLayout.encodeRxPdo(stagedCommand, rawControlword_, rxPdo.data());
+    recordPdo(PdoRecord::Type::RxPdo, rxPdo.data(), configuration_.rxPdoLayout.getSize());
+    writeRxPdoBytesFunction_(*bus_, address_, rxPdo.data());
+    return true;
+  }
+
+  template <typename RxPdo>
+  bool Elmo::writeRxPdoInPlace(const RxPdoStandard& stagedCommand){
+    PdoCodec<RxPdo>::encode(stagedCommand, rawControlword_, processImageOutputs_);
+    recordPdo(PdoRecord::Type::RxPdo, processImageOutputs_, PdoCodec<RxPdo>::size);
+    return true;
+  }
+
+  bool Elmo::writeCustomRxPdoInPlace(const RxPdoStandard& stagedCommand){
+    configuration_.rxPdoLayout.encodeRxPdo(stagedCommand, rawControlword_, processImageOutputs_);
+    recordPdo(PdoRecord::Type::RxPdo, processImageOutputs_, configuration_.rxPdoLayout.getSize());
+    return true;
+  }
+
+  std::size_t Elmo::getConfiguredRxPdoSize() const{
+    switch(configuration_.rxPdoTypeEnum){
+      case RxPdoTypeEnum::RxPdoStandard:
+        return PdoCodec<RxPdoStandard>::size;
+      case RxPdoTypeEnum::RxPdoCST:
+        return PdoCodec<RxPdoCST>::size;
+      case RxPdoTypeEnum::RxPdoCustom:
+        // an oversized layout fails the sanity check and is treated as unsupported
+        return configuration_.rxPdoLayout.getSize() <= PdoLayout::maxSize ? configuration_.rxPdoLayout.getSize() : 0;
+      default:
+        return 0;
     }
   }
 
-  void Elmo::stageCommand(const Command& command){
-    std::lock_guard<std::recursive_mutex> lock(stagedCommandMutex_);
-    stagedCommand_ = command;
-    if(configuration_.encoderPosition == Configuration::EncoderPosition::joint){
-      stagedCommand_.setPositionFactorRadToInteger(
-        static_cast<double>(configuration_.positionEncoderResolution) / (2.0 * M_PI));
-      stagedCommand_.setVelocityFactorRadPerSecToIntegerPerSec(
-        static_cast<double>(configuration_.positionEncoderResolution) / (2.0 * M_PI));
-    } else if(configuration_.encoderPosition == Configuration::EncoderPosition::motor){
-      stagedCommand_.setPositionFactorRadToInteger(
-        static_cast<double>(configuration_.positionEncoderResolution) /
-        (2.0 * M_PI) * configuration_.gearRatio);
-      stagedCommand_.setVelocityFactorRadPerSecToIntegerPerSec(
-        static_cast<double>(configuration_.positionEncoderResolution) /
-        (2.0 * M_PI) * configuration_.gearRatio);
-    } else {
-      stagedCommand_.setPositionFactorRadToInteger(0.0);
-      stagedCommand_.setVelocityFactorRadPerSecToIntegerPerSec(0.0);
+  std::size_t Elmo::getConfiguredTxPdoSize() const{
+    switch(configuration_.txPdoTypeEnum){
+      case TxPdoTypeEnum::TxPdoStandard:
+        return PdoCodec<TxPdoStandard>::size;
+      case TxPdoTypeEnum::TxPdoCST:
+        return PdoCodec<TxPdoCST>::size;
+      case TxPdoTypeEnum::TxPdoCustom:
+        return configuration_.txPdoLayout.getSize() <= PdoLayout::maxSize ? configuration_.txPdoLayout.getSize() : 0;
+      default:
+        return 0;
+    }
+  }
+
+  void Elmo::selectPdoCodecs(){
+    const bool inPlace = (processImageInputs_ != nullptr && processImageOutputs_ != nullptr);
+
+    const std::size_t rxPdoSize = getConfiguredRxPdoSize();
+    switch(rxPdoSize > 0 ? configuration_.rxPdoTypeEnum : RxPdoTypeEnum::NA){
+      case RxPdoTypeEnum::RxPdoStandard:
+        writeRxPdoFunction_ = inPlace ? &Elmo::writeRxPdoInPlace<RxPdoStandard> : &Elmo::writeRxPdo<RxPdoStandard>;
+        break;
+      case RxPdoTypeEnum::RxPdoCST:
+        writeRxPdoFunction_ = inPlace ? &Elmo::writeRxPdoInPlace<RxPdoCST> : &Elmo::writeRxPdo<RxPdoCST>;
+        break;
+      case RxPdoTypeEnum::RxPdoCustom:
+        writeRxPdoFunction_ = inPlace ? &Elmo::writeCustomRxPdoInPlace : &Elmo::writeCustomRxPdo;
+        writeRxPdoBytesFunction_ = writeRxPdoBytesFunctions[rxPdoSize];
+        break;
+      default:
+        writeRxPdoFunction_ = &Elmo::writeUnsupportedRxPdo;
+    }
+
+    const std::size_t txPdoSize = getConfiguredTxPdoSize();
+    switch(txPdoSize > 0 ? configuration_.txPdoTypeEnum : TxPdoTypeEnum::NA){
+      case TxPdoTypeEnum::TxPdoStandard:
+        readTxPdoFunction_ = inPlace ? &Elmo::readTxPdoInPlace<TxPdoStandard> : &Elmo::readTxPdo<TxPdoStandard>;
+        break;
+      case TxPdoTypeEnum::TxPdoCST:
+        readTxPdoFunction_ = inPlace ? &Elmo::readTxPdoInPlace<TxPdoCST> : &Elmo::readTxPdo<TxPdoCST>;
+        break;
+      case TxPdoTypeEnum::TxPdoCustom:
+        readTxPdoFunction_ = inPlace ? &Elmo::readCustomTxPdoInPlace : &Elmo::readCustomTxPdo;
+        readTxPdoBytesFunction_ = readTxPdoBytesFunctions[txPdoSize];
+        break;
+      default:
+        readTxPdoFunction_ = &Elmo::readUnsupportedTxPdo;
     }
 
-    double currentFactorAToInt = 1000.0 / configuration_.motorRatedCurrentA;
-    stagedCommand_.setCurrentFactorAToInteger(currentFactorAToInt);
-    stagedCommand_.setTorqueFactorNmToInteger(
-      currentFactorAToInt / configuration_.motorConstant / configuration_.gearRatio);
+    describeRecordedPdos();
+  }
+
+  void Elmo::setCycleClock(const CycleClock* cycleClock){
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    cycleClock_ = cycleClock;
+  }
+
+  void Elmo::setPdoRecorder(const PdoRecorder::SharedPtr& pdoRecorder){
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    pdoRecorder_ = pdoRecorder;
+    describeRecordedPdos();
+  }
 
-    stagedCommand_.setMaxCurrent(configuration_.maxCurrentA);
-    stagedCommand_.setMaxTorque(
-      configuration_.maxCurrentA * configuration_.motorConstant * configuration_.gearRatio);
+  void Elmo::setTelemetryStream(const TelemetryStream::SharedPtr& telemetryStream){
+    // add the channel before locking, addChannel may wait for the writer thread of the stream
+    TelemetryChannel* telemetryChannel = telemetryStream ? telemetryStream->addChannel(name_) : nullptr;
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    telemetryStream_ = telemetryStream;
+    telemetryChannel_ = telemetryChannel;
+  }
+
+  void Elmo::describeRecordedPdos(){
+    if(!pdoRecorder_){
+      return;
+    }
+    pdoRecorder_->setPdos(name_,
+                          configuration_.rxPdoTypeEnum,
+                          getRxPdoLayout(configuration_.rxPdoTypeEnum, configuration_.rxPdoLayout),
+                          configuration_.txPdoTypeEnum,
+                          getTxPdoLayout(configuration_.txPdoTypeEnum, configuration_.txPdoLayout));
+  }
 
-    stagedCommand_.setUseRawCommands(configuration_.useRawCommands);
+  bool Elmo::setProcessImage(const uint8_t* inputs, std::size_t inputsSize, uint8_t* outputs, std::size_t outputsSize){
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    // the sizes of the PDOs mapped by the drive
+    autoConfigurePdoSizes();
+    const std::size_t txPdoSize = getConfiguredTxPdoSize();
+    const std::size_t rxPdoSize = getConfiguredRxPdoSize();
+    if(inputs == nullptr || outputs == nullptr || txPdoSize == 0 || rxPdoSize == 0 ||
+       inputsSize != txPdoSize || inputsSize != pdoInfo_.txPdoSize_ ||
+       outputsSize != rxPdoSize || outputsSize != pdoInfo_.rxPdoSize_){
+      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setProcessImage] The process image of '" << name_
+                        << "' (inputs: " << inputsSize << " bytes, outputs: " << outputsSize
+                        << " bytes) does not match the TxPdo (" << txPdoSize << " bytes, mapped: "
+                        << pdoInfo_.txPdoSize_ << " bytes) / RxPdo (" << rxPdoSize << " bytes, mapped: "
+                        << pdoInfo_.rxPdoSize_ << " bytes), the PDOs are copied.");
+      clearProcessImage();
+      return false;
+    }
+    processImageInputs_ = inputs;
+    processImageOutputs_ = outputs;
+    selectPdoCodecs();
+    return true;
+  }
 
-    stagedCommand_.doUnitConversion();
+  void Elmo::clearProcessImage(){
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    processImageInputs_ = nullptr;
+    processImageOutputs_ = nullptr;
+    selectPdoCodecs();
+  }
 
+  void Elmo::stageCommand(const Command& command){
     if(allowModeChange_ && command.getModeOfOperation() != ModeOfOperationEnum::NA){
       modeOfOperation_ = command.getModeOfOperation();
     }else{
@@ -258,21 +514,105 @@ namespace elmo{
                           << name_ << "' is not allowed for the active configuration.");
       }
     }
+
+    // the startup may update the factors concurrently
+    ConversionTable conversionTable;
+    publishedConversionTable_.load(conversionTable);
+    const int direction = conversionTable.getDirection();
+    RxPdoStandard rxPdo{};
+    if(configuration_.useRawCommands){
+      rxPdo.targetPosition_ = command.getTargetPositionRaw() * direction;
+      rxPdo.targetVelocity_ = command.getTargetVelocityRaw() * direction;
+      rxPdo.targetTorque_ = command.getTargetTorqueRaw() * direction;
+      rxPdo.maxTorque_ = command.getMaxTorqueRaw();
+      rxPdo.torqueOffset_ = command.getTorqueOffsetRaw() * direction;
+    }else{
+      // same conversion as Command::doUnitConversion, with the precomputed factors and the direction applied
+      rxPdo.targetPosition_ = conversionTable.positionToRaw(command.getTargetPosition());
+      rxPdo.targetVelocity_ = conversionTable.velocityToRaw(command.getTargetVelocity());
+      rxPdo.targetTorque_ = conversionTable.torqueToRaw(command.getTargetTorque());
+      rxPdo.maxTorque_ = conversionTable.getMaxTorqueRaw();
+      rxPdo.torqueOffset_ = conversionTable.torqueToRaw(command.getTorqueOffset());
+    }
+    stageRawCommand(rxPdo);
+  }
+
+  void Elmo::stageRawCommand(const RxPdoStandard& rxPdo){
+#ifndef NDEBUG
+    // the mailbox has a single producer, the first staging thread after loadConfiguration
+    const std::thread::id thisThread = std::this_thread::get_id();
+    std::thread::id stagingThread;
+    if(!stagingThread_.compare_exchange_strong(stagingThread, thisThread, std::memory_order_relaxed)){
+      assert(stagingThread == thisThread && "commands of a drive must be staged from a single thread");
+    }
+#endif
+    RxPdoStandard stagedRxPdo = rxPdo;
+    stagedRxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
+
+    // hand the converted command over to the bus thread
+    stagedCommand_.write(stagedRxPdo);
   }
 
   Reading Elmo::getReading() const{
-    std::lock_guard<std::recursive_mutex> lock(readingMutex_);
-    return reading_;
+    Reading reading;
+    getReading(reading);
+    return reading;
   }
 
   void Elmo::getReading(Reading &reading) const{
-    std::lock_guard<std::recursive_mutex> lock(readingMutex_);
-    reading = reading_;
+    {
+      std::lock_guard<std::recursive_mutex> lock(readingMutex_);
+      reading = reading_;
+    }
+    // the process data is not part of reading_, it is published by updateRead
+    static_cast<ReadingSnapshot&>(reading) = publishedReading_.load();
+  }
+
+  ReadingSnapshot Elmo::getReadingSnapshot() const{
+    return publishedReading_.load();
+  }
+
+  void Elmo::getReadingSnapshot(ReadingSnapshot &snapshot) const{
+    publishedReading_.load(snapshot);
+  }
+
+  CycleStatistics Elmo::getUpdateReadStatistics() const{
+    return updateReadHistogram_.getStatistics();
+  }
+
+  CycleStatistics Elmo::getUpdateWriteStatistics() const{
+    return updateWriteHistogram_.getStatistics();
+  }
+
+  CycleStatistics Elmo::getReadPeriodStatistics() const{
+    return readPeriodHistogram_.getStatistics();
+  }
+
+  void Elmo::resetCycleStatistics(){
+    updateReadHistogram_.reset();
+    updateWriteHistogram_.reset();
+    readPeriodHistogram_.reset();
+  }
+
+  void Elmo::setCycleOverrunThresholds(const std::chrono::nanoseconds& updateDuration,
+                                       const std::chrono::nanoseconds& readPeriod){
+    updateReadHistogram_.setOverrunThreshold(updateDuration);
+    updateWriteHistogram_.setOverrunThreshold(updateDuration);
+    readPeriodHistogram_.setOverrunThreshold(readPeriod);
+  }
+
+  void Elmo::setDefaultCycleOverrunThresholds(){
+    // keep thresholds which were set explicitly
+    if(timeStep_ <= 0.0 || readPeriodHistogram_.getOverrunThreshold().count() != 0){
+      return;
+    }
+    // an update must not take the whole cycle, a period of more than 1.5 time steps means a missed cycle
+    const auto timeStep = std::chrono::nanoseconds(static_cast<int64_t>(timeStep_ * 1e9));
+    setCycleOverrunThresholds(timeStep, timeStep * 3 / 2);
   }
 
   bool Elmo::loadConfigFile(const std::string &fileName){
-    ConfigurationParser configurationParser(fileName);
-    return loadConfiguration(configurationParser.getConfiguration());
+    return loadConfiguration(ConfigurationCache::instance().getConfiguration(fileName));
   }
 
   bool Elmo::loadConfigNode(YAML::Node configNode){
@@ -281,7 +621,10 @@ namespace elmo{
   }
 
   bool Elmo::loadConfiguration(const Configuration& configuration){
-    reading_.configureReading(configuration);
+    configuration_ = configuration;
+    updateConversionTable();
+    // the PDO types may change, the process image has to be set again
+    clearProcessImage();
 
     // Check if changing mode of operation will be allowed
     allowModeChange_ = true;
@@ -291,7 +634,13 @@ namespace elmo{
 
     modeOfOperation_ = configuration.modeOfOperationEnum;
 
-    configuration_ = configuration;
+    // stage an empty command such that the configured mode of operation is used
+    // until the first command is staged. the staging thread may change afterwards.
+    RxPdoStandard rxPdo{};
+    rxPdo.modeOfOperation_ = static_cast<int8_t>(modeOfOperation_);
+    stagedCommand_.write(rxPdo);
+    stagingThread_.store(std::thread::id(), std::memory_order_relaxed);
+
     MELO_INFO_STREAM("Configuration Sanity Check of Elmo '" << getName() << "':");
     return configuration_.sanityCheck();
   }
@@ -302,13 +651,13 @@ namespace elmo{
 
   bool Elmo::getStatuswordViaSdo(Statusword &statusword){
     uint16_t statuswordValue = 0;
-    bool success = sendSdoRead(OD_INDEX_STATUSWORD, 0, false, statuswordValue);
+    bool success = sdoRead(OD_INDEX_STATUSWORD, 0, false, statuswordValue);
     statusword.setFromRawStatusword(statuswordValue);
     return success;
   }
 
   bool Elmo::setControlwordViaSdo(Controlword &controlword){
-    return sendSdoWrite(OD_INDEX_CONTROLWORD, 0, false, controlword.getRawControlword());
+    return sdoWrite(OD_INDEX_CONTROLWORD, 0, false, controlword.getRawControlword());
   }
 
   bool Elmo::setDriveStateViaSdo(const DriveState &driveState){
@@ -319,549 +668,295 @@ namespace elmo{
 
     // do the adequate state changes (via sdo) depending on the requested and
     // current drive states
-    switch (driveState) {
-      // Target: switch on disabled
-      // This is the lowest state in which the state machine can be brought over
-      // EtherCAT
-      case DriveState::SwitchOnDisabled:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            success &= true;
-            break;
-          case DriveState::ReadyToSwitchOn:
-            success &= stateTransitionViaSdo(StateTransition::_7);
-            break;
-          case DriveState::SwitchedOn:
-            success &= stateTransitionViaSdo(StateTransition::_10);
-            break;
-          case DriveState::OperationEnabled:
-            success &= stateTransitionViaSdo(StateTransition::_9);
-            break;
-          case DriveState::QuickStopActive:
-            success &= stateTransitionViaSdo(StateTransition::_12);
-            break;
-          case DriveState::Fault:
-            success &= stateTransitionViaSdo(StateTransition::_15);
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setDriveStateViaSdo] State Transition not implemented");
-            addErrorToReading(ErrorType::SdoStateTransitionError);
-            success = false;
-        }
-        break;
-
-      case DriveState::ReadyToSwitchOn:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            break;
-          case DriveState::ReadyToSwitchOn:
-            success &= true;
-            break;
-          case DriveState::SwitchedOn:
-            success &= stateTransitionViaSdo(StateTransition::_6);
-            break;
-          case DriveState::OperationEnabled:
-            success &= stateTransitionViaSdo(StateTransition::_8);
-            break;
-          case DriveState::QuickStopActive:
-            success &= stateTransitionViaSdo(StateTransition::_12);
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            break;
-          case DriveState::Fault:
-            success &= stateTransitionViaSdo(StateTransition::_15);
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setDriveStateViaSdo] State Transition not implemented");
-            addErrorToReading(ErrorType::SdoStateTransitionError);
-            success = false;
-        }
-        break;
-
-      case DriveState::SwitchedOn:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            break;
-          case DriveState::ReadyToSwitchOn:
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            break;
-          case DriveState::SwitchedOn:
-            success &= true;
-            break;
-          case DriveState::OperationEnabled:
-            success &= stateTransitionViaSdo(StateTransition::_5);
-            break;
-          case DriveState::QuickStopActive:
-            success &= stateTransitionViaSdo(StateTransition::_12);
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            break;
-          case DriveState::Fault:
-            success &= stateTransitionViaSdo(StateTransition::_15);
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setDriveStateViaSdo] State Transition not implemented");
-            addErrorToReading(ErrorType::SdoStateTransitionError);
-            success = false;
-        }
-        break;
-
-      case DriveState::OperationEnabled:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            break;
-          case DriveState::ReadyToSwitchOn:
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            break;
-          case DriveState::SwitchedOn:
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            break;
-          case DriveState::OperationEnabled:
-            success &= true;
-            break;
-          case DriveState::QuickStopActive:
-            success &= stateTransitionViaSdo(StateTransition::_12);
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            break;
-          case DriveState::Fault:
-            success &= stateTransitionViaSdo(StateTransition::_15);
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setDriveStateViaSdo] State Transition not implemented");
-            addErrorToReading(ErrorType::SdoStateTransitionError);
-            success = false;
-        }
-        break;
-
-      case DriveState::QuickStopActive:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            success &= stateTransitionViaSdo(StateTransition::_11);
-            break;
-          case DriveState::ReadyToSwitchOn:
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            success &= stateTransitionViaSdo(StateTransition::_11);
-            break;
-          case DriveState::SwitchedOn:
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            success &= stateTransitionViaSdo(StateTransition::_11);
-            break;
-          case DriveState::OperationEnabled:
-            success &= stateTransitionViaSdo(StateTransition::_11);
-            break;
-          case DriveState::QuickStopActive:
-            success &= true;
-            break;
-          case DriveState::Fault:
-            success &= stateTransitionViaSdo(StateTransition::_15);
-            success &= stateTransitionViaSdo(StateTransition::_2);
-            success &= stateTransitionViaSdo(StateTransition::_3);
-            success &= stateTransitionViaSdo(StateTransition::_4);
-            success &= stateTransitionViaSdo(StateTransition::_11);
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setDriveStateViaSdo] State Transition not implemented");
-            addErrorToReading(ErrorType::SdoStateTransitionError);
-            success = false;
-        }
-        break;
-
-      default:
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setDriveStateViaSdo] State Transition not implemented");
-        addErrorToReading(ErrorType::SdoStateTransitionError);
-        success = false;
+    const StateTransitionSequence sequence = StateTransitionTable::getSequence(currentDriveState, driveState);
+    if(!sequence.valid){
+      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::setDriveStateViaSdo] Drive state '" << driveState
+                        << "' cannot be reached from '" << currentDriveState << "' for '" << name_ << "'");
+      addErrorToReading(ErrorType::SdoStateTransitionError);
+      return false;
+    }
+    for(std::size_t i = 0; i < sequence.size; i++){
+      success &= stateTransitionViaSdo(sequence.transitions[i]);
     }
     return success;
   }
 
-  bool Elmo::stateTransitionViaSdo(const StateTransition& stateTransition){
-    Controlword controlword;
-    switch (stateTransition) {
-      case StateTransition::_2:
-        controlword.setStateTransition2();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_3:
-        controlword.setStateTransition3();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_4:
-        controlword.setStateTransition4();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_5:
-        controlword.setStateTransition5();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_6:
-        controlword.setStateTransition6();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_7:
-        controlword.setStateTransition7();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_8:
-        controlword.setStateTransition8();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_9:
-        controlword.setStateTransition9();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_10:
-        controlword.setStateTransition10();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_11:
-        controlword.setStateTransition11();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_12:
-        controlword.setStateTransition12();
-        return setControlwordViaSdo(controlword);
-        break;
-      case StateTransition::_15:
-        controlword.setStateTransition15();
-        return setControlwordViaSdo(controlword);
+  bool Elmo::waitForDriveStateViaSdo(const DriveState& driveState){
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::microseconds(configuration_.driveStateChangeMaxTimeout);
+    Statusword statusword;
+    while(getStatuswordViaSdo(statusword)){
+      if(statusword.getDriveState() == driveState){
+        return true;
+      }
+      if(std::chrono::steady_clock::now() >= deadline){
         break;
-      default:
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::stateTransitionViaSdo] State Transition not implemented");
-        addErrorToReading(ErrorType::SdoStateTransitionError);
-        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::waitForDriveStateViaSdo] '" << name_
+                      << "' did not reach the drive state '" << driveState << "' (current: '"
+                      << statusword.getDriveState() << "').");
+    addErrorToReading(ErrorType::SdoStateTransitionError);
+    return false;
   }
 
-  bool Elmo::setDriveStateViaPdo(const DriveState &driveState, const bool waitForState){
-    bool success = false;
-    /*
-    ** locking the mutex_
-    ** This is not done with a lock_guard here because during the waiting time the
-    ** mutex_ must be unlocked periodically such that PDO writing (and thus state
-    ** changes) may occur at all!
-    */
-    mutex_.lock();
-
-    // reset the "stateChangeSuccessful_" flag to false such that a new successful
-    // state change can be detected
-    stateChangeSuccessful_ = false;
+  bool Elmo::stateTransitionViaSdo(const StateTransition& stateTransition){
+    return sdoWrite(OD_INDEX_CONTROLWORD, 0, false, StateTransitionTable::getControlword(stateTransition));
+  }
 
-    // make the state machine realize that a state change will have to happen
-    conductStateChange_ = true;
+  DriveStateChangeHandle Elmo::requestDriveStateViaPdo(const DriveState &driveState){
+    // a new sequence number, taken over by the bus thread in the next updateWrite
+    uint64_t requestedDriveStateChange = requestedDriveStateChange_.load(std::memory_order_relaxed);
+    uint64_t newDriveStateChange = 0;
+    do{
+      newDriveStateChange = (((requestedDriveStateChange >> 8) + 1) << 8) | static_cast<uint8_t>(driveState);
+    }while(!requestedDriveStateChange_.compare_exchange_weak(requestedDriveStateChange, newDriveStateChange,
+                                                             std::memory_order_release,
+                                                             std::memory_order_relaxed));
+    return DriveStateChangeHandle(this, newDriveStateChange >> 8, driveState);
+  }
 
-    // overwrite the target drive state
-    targetDriveState_ = driveState;
+  bool Elmo::setDriveStateViaPdo(const DriveState &driveState, const bool waitForState){
+    const DriveStateChangeHandle driveStateChange = requestDriveStateViaPdo(driveState);
 
-    // set the hasRead flag to false such that at least one new reading will be
-    // available when starting the state change
-    hasRead_ = false;
+    // return true if no waiting is requested
+    if (!waitForState) {
+      return true;
+    }
 
-    // set the time point of the last pdo change to now
-    driveStateChangeTimePoint_ = std::chrono::steady_clock::now();
+    // the bus thread reports a timeout, the deadline here prevents blocking if the bus is not updated
+    return driveStateChange.waitFor(std::chrono::microseconds(configuration_.driveStateChangeMaxTimeout)) ==
+           DriveStateChangeStatus::Succeeded;
+  }
 
-    // set a temporary time point to prevent getting caught in an infinite loop
-    auto driveStateChangeStartTimePoint = std::chrono::steady_clock::now();
+  bool Elmo::lastPdoStateChangeSuccessful() const{
+    const uint64_t sequenceNumber = requestedDriveStateChange_.load(std::memory_order_acquire) >> 8;
+    return sequenceNumber > 0 && getDriveStateChangeStatus(sequenceNumber) == DriveStateChangeStatus::Succeeded;
+  }
 
-    // return if no waiting is requested
-    if (!waitForState) {
-      // unlock the mutex
-      mutex_.unlock();
-      // return true if no waiting is requested
-      return true;
+  DriveStateChangeStatus Elmo::getDriveStateChangeStatus(uint64_t sequenceNumber) const{
+    const uint64_t finishedDriveStateChange = finishedDriveStateChange_.load(std::memory_order_acquire);
+    const uint64_t finishedSequenceNumber = finishedDriveStateChange >> 8;
+    if(finishedSequenceNumber == sequenceNumber){
+      return static_cast<DriveStateChangeStatus>(finishedDriveStateChange & 0xff);
+    }
+    if(finishedSequenceNumber > sequenceNumber){
+      return DriveStateChangeStatus::Superseded;
     }
+    return DriveStateChangeStatus::Pending;
+  }
 
-    // Wait for the state change to be successful
-    // during the waiting time the mutex MUST be unlocked!
+  void Elmo::finishDriveStateChange(DriveStateChangeStatus status){
+    finishedDriveStateChange_.store((activeDriveStateChange_ << 8) | static_cast<uint8_t>(status),
+                                    std::memory_order_release);
+  }
 
-    while (true) {
-      // break loop as soon as the state change was successful
-      if (stateChangeSuccessful_) {
-        success = true;
-        break;
+  bool Elmo::mapPdos(RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum){
+    bool rxSuccess = true;
+    PdoAssignment rxPdoAssignment;
+    if(getPdoAssignment(rxPdoTypeEnum, rxPdoAssignment)){
+      if(rxPdoTypeEnum == RxPdoTypeEnum::RxPdoCustom){
+        rxSuccess &= updatePdoMapping(OD_INDEX_RX_PDO_MAPPING_CUSTOM,
+                                      configuration_.rxPdoLayout.getMappingEntries());
       }
+      rxSuccess &= updatePdoAssignment(rxPdoAssignment);
+    }else{
+      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::mapPdos] Cannot map RxPdo type '" << rxPdoTypeEnum
+                        << "', PdoType not configured properly");
+      addErrorToReading(ErrorType::PdoMappingError);
+      rxSuccess = false;
+    }
 
-      // break the loop if the state change takes too long
-      // this prevents a freezing of the end user's program if the hardware is not
-      // able to change it's state.
-      if ((std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - driveStateChangeStartTimePoint)).count() >
-          configuration_.driveStateChangeMaxTimeout) {
-        break;
+    bool txSuccess = true;
+    PdoAssignment txPdoAssignment;
+    if(getPdoAssignment(txPdoTypeEnum, txPdoAssignment)){
+      if(txPdoTypeEnum == TxPdoTypeEnum::TxPdoCustom){
+        txSuccess &= updatePdoMapping(OD_INDEX_TX_PDO_MAPPING_CUSTOM,
+                                      configuration_.txPdoLayout.getMappingEntries());
       }
-      // unlock the mutex during sleep time
-      mutex_.unlock();
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
-      // lock the mutex to be able to check the success flag
-      mutex_.lock();
+      txSuccess &= updatePdoAssignment(txPdoAssignment);
+    }else{
+      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::mapPdos] Cannot map TxPdo type '" << txPdoTypeEnum
+                        << "', PdoType not configured properly");
+      addErrorToReading(ErrorType::TxPdoMappingError);
+      txSuccess = false;
     }
-    // unlock the mutex one last time
-    mutex_.unlock();
+    return (txSuccess && rxSuccess);
+  }
+
+  bool Elmo::updatePdoMapping(uint16_t mappingIndex, const std::vector<uint32_t>& mappingEntries){
+    // read the current mapping first, the drive keeps it like the assignment
+    bool upToDate = true;
+    uint8_t numberOfEntries = 0;
+    if(sdoRead(mappingIndex, 0, false, numberOfEntries) && numberOfEntries == mappingEntries.size()){
+      for(uint8_t subindex = 1; subindex <= numberOfEntries && upToDate; subindex++){
+        uint32_t mappingEntry = 0;
+        upToDate = sdoRead(mappingIndex, subindex, false, mappingEntry) &&
+                   mappingEntry == mappingEntries[subindex - 1];
+      }
+    }else{
+      upToDate = false;
+    }
+    if(upToDate){
+      MELO_INFO_STREAM("[elmo_ethercat_sdk:Elmo::updatePdoMapping] PDO mapping 0x" << std::hex
+                       << mappingIndex << std::dec << " of '" << name_
+                       << "' is up to date, skipping the mapping.");
+      return true;
+    }
+
+    bool success = true;
+    // the mapping has to be disabled (0 entries) while it is changed
+    success &= sdoWriteVerified(mappingIndex, 0, static_cast<uint8_t>(0));
+    for(std::size_t i = 0; i < mappingEntries.size(); i++){
+      success &= sdoWriteVerified(mappingIndex, static_cast<uint8_t>(i + 1), mappingEntries[i]);
+    }
+    success &= sdoWriteVerified(mappingIndex, 0, static_cast<uint8_t>(mappingEntries.size()));
     return success;
   }
 
-  bool Elmo::mapPdos(RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum){
-    bool rxSuccess = true;
-    switch (rxPdoTypeEnum) {
-      case RxPdoTypeEnum::RxPdoStandard:
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(0), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 1, false, static_cast<uint16_t>(0x1605), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 2, false, static_cast<uint16_t>(0x1618), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(2), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        break;
-      case RxPdoTypeEnum::RxPdoCST:
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(0), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 1, false, static_cast<uint16_t>(0x1602), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 2, false, static_cast<uint16_t>(0x160b), configuration_.configRunSdoVerifyTimeout);
-        rxSuccess &= sdoVerifyWrite(OD_INDEX_RX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(2), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        break;
+  bool Elmo::updatePdoAssignment(const PdoAssignment& pdoAssignment){
+    // the drive keeps the assignment of the previous run, e.g. after a restart of the software
+    PdoAssignment currentPdoAssignment;
+    if(readPdoAssignment(pdoAssignment.assignmentIndex, currentPdoAssignment) &&
+       currentPdoAssignment == pdoAssignment){
+      MELO_INFO_STREAM("[elmo_ethercat_sdk:Elmo::updatePdoAssignment] PDO assignment 0x" << std::hex
+                       << pdoAssignment.assignmentIndex << std::dec << " of '" << name_
+                       << "' is up to date, skipping the mapping.");
+      return true;
+    }
+    return writePdoAssignment(pdoAssignment);
+  }
 
-      case RxPdoTypeEnum::NA:
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::mapPdos] Cannot map RxPdoTypeEnum::NA, PdoType not configured properly");
-        addErrorToReading(ErrorType::PdoMappingError);
-        rxSuccess = false;
-        break;
-      default:  // Non-implemented type
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::mapPdos] Cannot map unimplemented RxPdo, PdoType not configured properly");
-        addErrorToReading(ErrorType::PdoMappingError);
-        rxSuccess = false;
-        break;
+  bool Elmo::readPdoAssignment(uint16_t assignmentIndex, PdoAssignment& pdoAssignment){
+    pdoAssignment.assignmentIndex = assignmentIndex;
+    pdoAssignment.mappingIndices.clear();
+
+    // the size of a complete access upload has to match the number of entries held by the drive,
+    // otherwise soem reports an error
+    uint8_t numberOfEntries = 0;
+    if(!sdoRead(assignmentIndex, 0, false, numberOfEntries)){
+      return false;
     }
 
-    bool txSuccess = true;
-    switch (txPdoTypeEnum) {
-      case TxPdoTypeEnum::TxPdoStandard:
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(0), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 1, false, static_cast<uint16_t>(0x1a03), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 2, false, static_cast<uint16_t>(0x1a1d), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 3, false, static_cast<uint16_t>(0x1a1f), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 4, false, static_cast<uint16_t>(0x1a18), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(4), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        break;
+    // one complete access upload for the entries, if the drive supports it
+    bool success = false;
+    switch(numberOfEntries){
+      case 0: success = true; break;
+      case 1: success = readPdoAssignmentCompleteAccess<1>(assignmentIndex, pdoAssignment); break;
+      case 2: success = readPdoAssignmentCompleteAccess<2>(assignmentIndex, pdoAssignment); break;
+      case 3: success = readPdoAssignmentCompleteAccess<3>(assignmentIndex, pdoAssignment); break;
+      case 4: success = readPdoAssignmentCompleteAccess<4>(assignmentIndex, pdoAssignment); break;
+      case 5: success = readPdoAssignmentCompleteAccess<5>(assignmentIndex, pdoAssignment); break;
+      case 6: success = readPdoAssignmentCompleteAccess<6>(assignmentIndex, pdoAssignment); break;
+      case 7: success = readPdoAssignmentCompleteAccess<7>(assignmentIndex, pdoAssignment); break;
+      case 8: success = readPdoAssignmentCompleteAccess<8>(assignmentIndex, pdoAssignment); break;
+      default: break;
+    }
+    if(success){
+      return true;
+    }
 
-      case TxPdoTypeEnum::TxPdoCST:
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(0), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 1, false, static_cast<uint16_t>(0x1a02), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 2, false, static_cast<uint16_t>(0x1a11), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        txSuccess &= sdoVerifyWrite(OD_INDEX_TX_PDO_ASSIGNMENT, 0, false, static_cast<uint8_t>(2), configuration_.configRunSdoVerifyTimeout);
-        std::this_thread::sleep_for(std::chrono::microseconds(configuration_.configRunSdoVerifyTimeout));
-        break;
+    // fall back to reading the subindices one by one
+    pdoAssignment.mappingIndices.clear();
+    for(uint8_t subindex = 1; subindex <= numberOfEntries; subindex++){
+      uint16_t mappingIndex = 0;
+      if(!sdoRead(assignmentIndex, subindex, false, mappingIndex)){
+        return false;
+      }
+      pdoAssignment.mappingIndices.push_back(mappingIndex);
+    }
+    return true;
+  }
 
-      case TxPdoTypeEnum::NA:
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::mapPdos] Cannot map TxPdoTypeEnum::NA, PdoType not configured properly");
-        addErrorToReading(ErrorType::TxPdoMappingError);
-        txSuccess = false;
-        break;
-      default:  // if any case was forgotten
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::mapPdos] Cannot map undefined TxPdo, PdoType not configured properly");
-        addErrorToReading(ErrorType::TxPdoMappingError);
-        txSuccess = false;
-        break;
+  template <std::size_t NumberOfEntries>
+  bool Elmo::readPdoAssignmentCompleteAccess(uint16_t assignmentIndex, PdoAssignment& pdoAssignment){
+    // complete access layout: number of entries (uint8), padding (uint8), entries (uint16)
+    std::array<uint16_t, NumberOfEntries + 1> data{};
+    if(!sdoRead(assignmentIndex, 0, true, data)){
+      return false;
     }
-    return (txSuccess && rxSuccess);
+    if((data[0] & 0xff) != NumberOfEntries){
+      return false;
+    }
+    pdoAssignment.mappingIndices.assign(data.begin() + 1, data.end());
+    return true;
   }
-  Controlword Elmo::getNextStateTransitionControlword(const DriveState& requestedDriveState,
-                                                      const DriveState& currentDriveState){
-    Controlword controlword;
-    controlword.setAllFalse();
-    switch (requestedDriveState) {
-      case DriveState::SwitchOnDisabled:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "drive state has already been reached for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-            break;
-          case DriveState::ReadyToSwitchOn:
-            controlword.setStateTransition7();
-            break;
-          case DriveState::SwitchedOn:
-            controlword.setStateTransition10();
-            break;
-          case DriveState::OperationEnabled:
-            controlword.setStateTransition9();
-            break;
-          case DriveState::QuickStopActive:
-            controlword.setStateTransition12();
-            break;
-          case DriveState::Fault:
-            controlword.setStateTransition15();
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "PDO state transition not implemented for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-        }
-        break;
 
-      case DriveState::ReadyToSwitchOn:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            controlword.setStateTransition2();
-            break;
-          case DriveState::ReadyToSwitchOn:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "drive state has already been reached for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-            break;
-          case DriveState::SwitchedOn:
-            controlword.setStateTransition6();
-            break;
-          case DriveState::OperationEnabled:
-            controlword.setStateTransition8();
-            break;
-          case DriveState::QuickStopActive:
-            controlword.setStateTransition12();
-            break;
-          case DriveState::Fault:
-            controlword.setStateTransition15();
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "PDO state transition not implemented for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-        }
-        break;
+  bool Elmo::writePdoAssignment(const PdoAssignment& pdoAssignment){
+    bool success = true;
+    // the assignment has to be disabled (0 entries) while it is changed
+    success &= sdoWriteVerified(pdoAssignment.assignmentIndex, 0, static_cast<uint8_t>(0));
+    for(std::size_t i = 0; i < pdoAssignment.mappingIndices.size(); i++){
+      success &= sdoWriteVerified(pdoAssignment.assignmentIndex, static_cast<uint8_t>(i + 1),
+                                  pdoAssignment.mappingIndices[i]);
+    }
+    success &= sdoWriteVerified(pdoAssignment.assignmentIndex, 0,
+                                static_cast<uint8_t>(pdoAssignment.mappingIndices.size()));
+    return success;
+  }
 
-      case DriveState::SwitchedOn:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            controlword.setStateTransition2();
-            break;
-          case DriveState::ReadyToSwitchOn:
-            controlword.setStateTransition3();
-            break;
-          case DriveState::SwitchedOn:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "drive state has already been reached for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-            break;
-          case DriveState::OperationEnabled:
-            controlword.setStateTransition5();
-            break;
-          case DriveState::QuickStopActive:
-            controlword.setStateTransition12();
-            break;
-          case DriveState::Fault:
-            controlword.setStateTransition15();
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "PDO state transition not implemented for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-        }
-        break;
+  bool Elmo::sdoReadBytes(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data, std::size_t size){
+    if(size > sdoMaxSize){
+      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::sdoReadBytes] Reading 0x" << std::hex << index << ":"
+                        << static_cast<unsigned int>(subindex) << std::dec << " of '" << name_ << "': "
+                        << size << " bytes are more than the supported " << sdoMaxSize << " bytes.");
+      return false;
+    }
+    return sdoReadBytesFunctions[size](*this, index, subindex, completeAccess, data);
+  }
 
-      case DriveState::OperationEnabled:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            controlword.setStateTransition2();
-            break;
-          case DriveState::ReadyToSwitchOn:
-            controlword.setStateTransition3();
-            break;
-          case DriveState::SwitchedOn:
-            controlword.setStateTransition4();
-            break;
-          case DriveState::OperationEnabled:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "drive state has already been reached for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-            break;
-          case DriveState::QuickStopActive:
-            controlword.setStateTransition12();
-            break;
-          case DriveState::Fault:
-            controlword.setStateTransition15();
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "PDO state transition not implemented for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-        }
-        break;
+  bool Elmo::sdoWriteBytes(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                           std::size_t size){
+    if(size > sdoMaxSize){
+      MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::sdoWriteBytes] Writing 0x" << std::hex << index << ":"
+                        << static_cast<unsigned int>(subindex) << std::dec << " of '" << name_ << "': "
+                        << size << " bytes are more than the supported " << sdoMaxSize << " bytes.");
+      return false;
+    }
+    return sdoWriteBytesFunctions[size](*this, index, subindex, completeAccess, data);
+  }
 
-      case DriveState::QuickStopActive:
-        switch (currentDriveState) {
-          case DriveState::SwitchOnDisabled:
-            controlword.setStateTransition2();
-            break;
-          case DriveState::ReadyToSwitchOn:
-            controlword.setStateTransition3();
-            break;
-          case DriveState::SwitchedOn:
-            controlword.setStateTransition4();
-            break;
-          case DriveState::OperationEnabled:
-            controlword.setStateTransition11();
-            break;
-          case DriveState::QuickStopActive:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "drive state has already been reached for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-            break;
-          case DriveState::Fault:
-            controlword.setStateTransition15();
-            break;
-          default:
-            MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                              << "PDO state transition not implemented for '"
-                              << name_ << "'");
-            addErrorToReading(ErrorType::PdoStateTransitionError);
-        }
-        break;
+  template <typename Value>
+  bool Elmo::sdoRead(uint16_t index, uint8_t subindex, bool completeAccess, Value& value){
+    return sdoReadBytes(index, subindex, completeAccess, reinterpret_cast<uint8_t*>(&value), sizeof(Value));
+  }
 
-      default:
-        MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::getNextStateTransitionControlword] "
-                          << "PDO state cannot be reached for '"
-                          << name_ << "'");
-        addErrorToReading(ErrorType::PdoStateTransitionError);
+  template <typename Value>
+  bool Elmo::sdoWrite(uint16_t index, uint8_t subindex, bool completeAccess, const Value& value){
+    return sdoWriteBytes(index, subindex, completeAccess, reinterpret_cast<const uint8_t*>(&value), sizeof(Value));
+  }
+
+  template <typename Value>
+  bool Elmo::sdoWriteVerified(uint16_t index, uint8_t subindex, Value value){
+    // the SDO transfers are confirmed by the drive, wait only if the verification failed
+    unsigned int backoff = std::min(sdoRetryInitialBackoff_, configuration_.configRunSdoVerifyTimeout);
+    for(unsigned int attempt = 0; attempt < sdoMaxNumberOfAttempts_; attempt++){
+      if(attempt > 0){
+        std::this_thread::sleep_for(std::chrono::microseconds(backoff));
+        backoff = std::min(2 * backoff, configuration_.configRunSdoVerifyTimeout);
+      }
+      Value readValue{};
+      if(sdoWrite(index, subindex, false, value) &&
+         sdoRead(index, subindex, false, readValue) && readValue == value){
+        return true;
+      }
     }
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:Elmo::sdoWriteVerified] Writing 0x" << std::hex << index << ":"
+                      << static_cast<unsigned int>(subindex) << std::dec << " of '" << name_
+                      << "' could not be verified after " << sdoMaxNumberOfAttempts_ << " attempts.");
+    return false;
+  }
 
-    return controlword;
+  void Elmo::updateConversionTable(){
+    conversionTable_ = ConversionTable(configuration_);
+    publishedConversionTable_.store(conversionTable_);
+    {
+      std::lock_guard<std::recursive_mutex> lock(readingMutex_);
+      reading_.configureReading(configuration_, conversionTable_);
+      readingSnapshot_ = reading_;
+    }
+    publishedReading_.store(readingSnapshot_);
   }
 
   void Elmo::autoConfigurePdoSizes(){
@@ -879,32 +974,91 @@ namespace elmo{
   }
 
   void Elmo::engagePdoStateMachine(){
-    // locking the mutex
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const auto now = getCycleTime();
+
+    // take over a new request
+    const uint64_t requestedDriveStateChange = requestedDriveStateChange_.load(std::memory_order_acquire);
+    const uint64_t sequenceNumber = requestedDriveStateChange >> 8;
+    if (sequenceNumber != activeDriveStateChange_) {
+      if (conductStateChange_) {
+        finishDriveStateChange(DriveStateChangeStatus::Superseded);
+      }
+      activeDriveStateChange_ = sequenceNumber;
+      targetDriveState_ = static_cast<DriveState>(requestedDriveStateChange & 0xff);
+      conductStateChange_ = true;
+      driveStateChangeTimedOut_ = false;
+      numberOfSuccessfulTargetStateReadings_ = 0;
+      driveStateChangeStartTimePoint_ = now;
+      driveStateChangeTimePoint_ = now;
+      // the first controlword is sent with the first reading in the adaptive mode
+      lastControlwordDriveState_ = DriveState::NA;
+      // set the hasRead flag to false such that at least one new reading will be
+      // available when starting the state change
+      hasRead_ = false;
+      return;
+    }
+
+    if (!conductStateChange_ || !hasRead_) {
+      return;
+    }
 
     // elapsed time since the last new controlword
     auto microsecondsSinceChange =
-        (std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - driveStateChangeTimePoint_)).count();
+        (std::chrono::duration_cast<std::chrono::microseconds>(now - driveStateChangeTimePoint_)).count();
 
     // get the current state
     // since we wait until "hasRead" is true, this is guaranteed to be a newly
     // read value
-    const DriveState currentDriveState = reading_.getDriveState();
+    const DriveState currentDriveState = readingSnapshot_.getDriveState();
 
     // check if the state change already was successful:
     if (currentDriveState == targetDriveState_) {
+      if (numberOfSuccessfulTargetStateReadings_ == 0) {
+        targetDriveStateTimePoint_ = now;
+      }
       numberOfSuccessfulTargetStateReadings_++;
-      if (numberOfSuccessfulTargetStateReadings_ >= configuration_.minNumberOfSuccessfulTargetStateReadings) {
+      // confirmed by a number of readings or, in the adaptive mode, by a time window
+      const bool targetDriveStateConfirmed =
+          configuration_.adaptiveDriveStateChange
+              ? std::chrono::duration_cast<std::chrono::microseconds>(now - targetDriveStateTimePoint_).count() >=
+                    configuration_.driveStateChangeConfirmationWindow
+              : numberOfSuccessfulTargetStateReadings_ >= configuration_.minNumberOfSuccessfulTargetStateReadings;
+      if (targetDriveStateConfirmed) {
         // disable the state machine
         conductStateChange_ = false;
         numberOfSuccessfulTargetStateReadings_ = 0;
-        stateChangeSuccessful_ = true;
+        finishDriveStateChange(DriveStateChangeStatus::Succeeded);
         return;
       }
-    } else if (microsecondsSinceChange > configuration_.driveStateChangeMinTimeout) {
-      // get the next controlword from the state machine
-      controlword_ = getNextStateTransitionControlword(targetDriveState_, currentDriveState);
-      driveStateChangeTimePoint_ = std::chrono::steady_clock::now();
+    } else {
+      // in the adaptive mode the confirmation window restarts if the drive leaves the target state.
+      // the readings counted otherwise do not have to be consecutive.
+      if (configuration_.adaptiveDriveStateChange) {
+        numberOfSuccessfulTargetStateReadings_ = 0;
+      }
+      // get the next controlword from the state machine. In the adaptive mode this is
+      // done as soon as the drive left the state of the last controlword, the min
+      // timeout only repeats the controlword if the drive did not react.
+      if ((configuration_.adaptiveDriveStateChange && currentDriveState != lastControlwordDriveState_) ||
+          microsecondsSinceChange > configuration_.driveStateChangeMinTimeout) {
+        const StateTransitionStep step = StateTransitionTable::getNextStep(currentDriveState, targetDriveState_);
+        rawControlword_ = step.controlword;
+        lastControlwordDriveState_ = currentDriveState;
+        driveStateChangeTimePoint_ = now;
+        if (unreachableDriveStateLog_.update(step.type == StateTransitionStep::Type::Unreachable, name_,
+                                             static_cast<int32_t>(currentDriveState))) {
+          addErrorToReading(ErrorType::PdoStateTransitionError);
+        }
+      }
+    }
+
+    // report the timeout once, the state machine keeps running until the state is reached
+    // or another state is requested
+    if (!driveStateChangeTimedOut_ &&
+        std::chrono::duration_cast<std::chrono::microseconds>(now - driveStateChangeStartTimePoint_).count() >
+        configuration_.driveStateChangeMaxTimeout) {
+      driveStateChangeTimedOut_ = true;
+      finishDriveStateChange(DriveStateChangeStatus::TimedOut);
     }
 
     // set the "hasRead" variable to false such that there will definitely be a
@@ -914,7 +1068,7 @@ namespace elmo{
   }
 
   void Elmo::addErrorToReading(const ErrorType& errorType){
-    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    std::lock_guard<std::recursive_mutex> lock(readingMutex_);
     reading_.addError(errorType);
   }
 } // namespace elmo
@@ -0,0 +1,211 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/ElmoGroup.hpp"
+#include "elmo_ethercat_sdk/UnitConversion.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace elmo {
+
+void GroupCommand::resize(std::size_t numberOfDrives) {
+  targetPositions.resize(numberOfDrives, 0.0);
+  targetVelocities.resize(numberOfDrives, 0.0);
+  targetTorques.resize(numberOfDrives, 0.0);
+  torqueOffsets.resize(numberOfDrives, 0.0);
+}
+
+void GroupReading::resize(std::size_t numberOfDrives) {
+  actualPositions.resize(numberOfDrives);
+  actualVelocities.resize(numberOfDrives);
+  actualCurrents.resize(numberOfDrives);
+  actualTorques.resize(numberOfDrives);
+  statuswords.resize(numberOfDrives);
+  driveStates.resize(numberOfDrives);
+}
+
+ElmoGroup::ElmoGroup(const std::vector<Elmo::SharedPtr>& drives) : drives_(drives) {
+  publishedSnapshots_.resize(drives_.size());
+  publishedReadings_.resize(drives_.size());
+}
+
+void ElmoGroup::addDrive(const Elmo::SharedPtr& drive) {
+  drives_.push_back(drive);
+  publishedSnapshots_.resize(drives_.size());
+  publishedReadings_.resize(drives_.size());
+}
+
+const StartupOrchestrator::SharedPtr& ElmoGroup::enableParallelStartup(std::size_t maxNumberOfWorkers) {
+  startupOrchestrator_ = std::make_shared<StartupOrchestrator>(maxNumberOfWorkers);
+  for (const auto& drive : drives_) {
+    startupOrchestrator_->addDrive(drive.get());
+    drive->setStartupOrchestrator(startupOrchestrator_);
+  }
+  return startupOrchestrator_;
+}
+
+void ElmoGroup::requestDriveStatesViaPdo(const DriveState& driveState,
+                                         std::vector<DriveStateChangeHandle>& driveStateChanges) {
+  driveStateChanges.resize(drives_.size());
+  for (std::size_t i = 0; i < drives_.size(); i++) {
+    driveStateChanges[i] = drives_[i]->requestDriveStateViaPdo(driveState);
+  }
+}
+
+bool ElmoGroup::setDriveStatesViaPdo(const DriveState& driveState, bool waitForState) {
+  std::vector<DriveStateChangeHandle> driveStateChanges;
+  requestDriveStatesViaPdo(driveState, driveStateChanges);
+  if (!waitForState) {
+    return true;
+  }
+
+  // all drives change their state at the same time, wait for the slowest one
+  unsigned int maxTimeout = 0;
+  for (const auto& drive : drives_) {
+    maxTimeout = std::max(maxTimeout, drive->getConfiguration().driveStateChangeMaxTimeout);
+  }
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(maxTimeout);
+
+  bool success = true;
+  for (std::size_t i = 0; i < drives_.size(); i++) {
+    const auto remainingTime = std::max(std::chrono::steady_clock::duration::zero(),
+                                        deadline - std::chrono::steady_clock::now());
+    const DriveStateChangeStatus status =
+        driveStateChanges[i].waitFor(std::chrono::duration_cast<std::chrono::microseconds>(remainingTime));
+    if (status != DriveStateChangeStatus::Succeeded) {
+      MELO_ERROR_STREAM("[elmo_ethercat_sdk:ElmoGroup::setDriveStatesViaPdo] '" << drives_[i]->getName()
+                        << "' did not reach the drive state " << driveState << ": " << status);
+      success = false;
+    }
+  }
+  return success;
+}
+
+void ElmoGroup::stageCommands(const GroupCommand& commands) {
+  if (commands.targetPositions.size() != drives_.size() || commands.targetVelocities.size() != drives_.size() ||
+      commands.targetTorques.size() != drives_.size() || commands.torqueOffsets.size() != drives_.size()) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:ElmoGroup::stageCommands] Command size does not match the number of drives ("
+                      << drives_.size() << ").");
+    return;
+  }
+
+  const std::size_t numberOfDrives = drives_.size();
+  commandScratch_.resize(numberOfDrives);
+  for (std::size_t i = 0; i < numberOfDrives; i++) {
+    // same factors as ConversionTable::positionToRaw etc., including the direction.
+    // the startup may update the factors concurrently, the table is copied once per drive.
+    ConversionTable& conversionTable = commandScratch_.conversionTables[i];
+    drives_[i]->getConversionTable(conversionTable);
+    const double direction = conversionTable.getDirection();
+    commandScratch_.positionFactors[i] = conversionTable.getPositionFactorRadToInteger() * direction;
+    commandScratch_.velocityFactors[i] = conversionTable.getVelocityFactorRadPerSecToIntegerPerSec() * direction;
+    commandScratch_.torqueFactors[i] = conversionTable.getTorqueFactorNmToInteger() * direction;
+  }
+
+  convertToRaw(commands.targetPositions.data(), commandScratch_.positionFactors.data(),
+               commandScratch_.rawPositions.data(), numberOfDrives);
+  convertToRaw(commands.targetVelocities.data(), commandScratch_.velocityFactors.data(),
+               commandScratch_.rawVelocities.data(), numberOfDrives);
+  convertToRaw(commands.targetTorques.data(), commandScratch_.torqueFactors.data(), commandScratch_.rawTorques.data(),
+               numberOfDrives);
+  convertToRaw(commands.torqueOffsets.data(), commandScratch_.torqueFactors.data(),
+               commandScratch_.rawTorqueOffsets.data(), numberOfDrives);
+
+  for (std::size_t i = 0; i < numberOfDrives; i++) {
+    RxPdoStandard rxPdo{};
+    rxPdo.targetPosition_ = commandScratch_.rawPositions[i];
+    rxPdo.targetVelocity_ = commandScratch_.rawVelocities[i];
+    rxPdo.targetTorque_ = commandScratch_.rawTorques[i];
+    rxPdo.maxTorque_ = commandScratch_.conversionTables[i].getMaxTorqueRaw();
+    rxPdo.torqueOffset_ = commandScratch_.rawTorqueOffsets[i];
+    drives_[i]->stageRawCommand(rxPdo);
+  }
+}
+
+void ElmoGroup::updateRead() {
+  for (const auto& drive : drives_) {
+    drive->updateRead();
+  }
+  publishReadings();
+}
+
+void ElmoGroup::publishReadings() {
+  for (std::size_t i = 0; i < drives_.size(); i++) {
+    drives_[i]->getReadingSnapshot(publishedSnapshots_[i]);
+  }
+  publishedReadings_.store(publishedSnapshots_.data());
+}
+
+void ElmoGroup::getReadings(GroupReading& readings) {
+  const std::size_t numberOfDrives = drives_.size();
+  readings.resize(numberOfDrives);
+  readingScratch_.resize(numberOfDrives);
+
+  // one synchronization point for all drives
+  publishedReadings_.load(readingScratch_.snapshots.data());
+  for (std::size_t i = 0; i < numberOfDrives; i++) {
+    const ReadingSnapshot& snapshot = readingScratch_.snapshots[i];
+    readingScratch_.rawPositions[i] = snapshot.getActualPositionRaw();
+    readingScratch_.rawVelocities[i] = snapshot.getActualVelocityRaw();
+    readingScratch_.rawCurrents[i] = snapshot.getActualCurrentRaw();
+    readings.statuswords[i] = snapshot.getRawStatusword();
+    readings.driveStates[i] = snapshot.getDriveState();
+
+    // the factors of the configuration the values were read with
+    readingScratch_.positionFactors[i] = snapshot.getPositionFactorIntegerToRad();
+    readingScratch_.velocityFactors[i] = snapshot.getVelocityFactorIntegerPerSecToRadPerSec();
+    readingScratch_.currentFactors[i] = snapshot.getCurrentFactorIntegerToAmp();
+    readingScratch_.torqueFactors[i] = snapshot.getTorqueFactorIntegerToNm();
+  }
+
+  convertFromRaw(readingScratch_.rawPositions.data(), readingScratch_.positionFactors.data(),
+                 readings.actualPositions.data(), numberOfDrives);
+  convertFromRaw(readingScratch_.rawVelocities.data(), readingScratch_.velocityFactors.data(),
+                 readings.actualVelocities.data(), numberOfDrives);
+  convertFromRaw(readingScratch_.rawCurrents.data(), readingScratch_.currentFactors.data(),
+                 readings.actualCurrents.data(), numberOfDrives);
+  convertFromRaw(readingScratch_.rawCurrents.data(), readingScratch_.torqueFactors.data(),
+                 readings.actualTorques.data(), numberOfDrives);
+}
+
+void ElmoGroup::CommandScratch::resize(std::size_t numberOfDrives) {
+  conversionTables.resize(numberOfDrives);
+  positionFactors.resize(numberOfDrives);
+  velocityFactors.resize(numberOfDrives);
+  torqueFactors.resize(numberOfDrives);
+  rawPositions.resize(numberOfDrives);
+  rawVelocities.resize(numberOfDrives);
+  rawTorques.resize(numberOfDrives);
+  rawTorqueOffsets.resize(numberOfDrives);
+}
+
+void ElmoGroup::ReadingScratch::resize(std::size_t numberOfDrives) {
+  snapshots.resize(numberOfDrives);
+  positionFactors.resize(numberOfDrives);
+  velocityFactors.resize(numberOfDrives);
+  currentFactors.resize(numberOfDrives);
+  torqueFactors.resize(numberOfDrives);
+  rawPositions.resize(numberOfDrives);
+  rawVelocities.resize(numberOfDrives);
+  rawCurrents.resize(numberOfDrives);
+}
+
+}  // namespace elmo
@@ -0,0 +1,62 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/PdoAssignment.hpp"
+#include "elmo_ethercat_sdk/ObjectDictionary.hpp"
+
+namespace elmo {
+
+bool getPdoAssignment(RxPdoTypeEnum rxPdoTypeEnum, PdoAssignment& assignment) {
+  assignment.assignmentIndex = OD_INDEX_RX_PDO_ASSIGNMENT;
+  switch (rxPdoTypeEnum) {
+    case RxPdoTypeEnum::RxPdoStandard:
+      assignment.mappingIndices = {0x1605, 0x1618};
+      return true;
+    case RxPdoTypeEnum::RxPdoCST:
+      assignment.mappingIndices = {0x1602, 0x160b};
+      return true;
+    case RxPdoTypeEnum::RxPdoCustom:
+      assignment.mappingIndices = {OD_INDEX_RX_PDO_MAPPING_CUSTOM};
+      return true;
+    default:
+      assignment.mappingIndices.clear();
+      return false;
+  }
+}
+
+bool getPdoAssignment(TxPdoTypeEnum txPdoTypeEnum, PdoAssignment& assignment) {
+  assignment.assignmentIndex = OD_INDEX_TX_PDO_ASSIGNMENT;
+  switch (txPdoTypeEnum) {
+    case TxPdoTypeEnum::TxPdoStandard:
+      assignment.mappingIndices = {0x1a03, 0x1a1d, 0x1a1f, 0x1a18};
+      return true;
+    case TxPdoTypeEnum::TxPdoCST:
+      assignment.mappingIndices = {0x1a02, 0x1a11};
+      return true;
+    case TxPdoTypeEnum::TxPdoCustom:
+      assignment.mappingIndices = {OD_INDEX_TX_PDO_MAPPING_CUSTOM};
+      return true;
+    default:
+      assignment.mappingIndices.clear();
+      return false;
+  }
+}
+
+}  // namespace elmo
@@ -0,0 +1,199 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/PdoLayout.hpp"
+#include "elmo_ethercat_sdk/ObjectDictionary.hpp"
+#include "elmo_ethercat_sdk/PdoCodec.hpp"
+#include "elmo_ethercat_sdk/ReadingSnapshot.hpp"
+
+#include <algorithm>
+
+namespace elmo {
+
+namespace {
+
+// ordered like PdoEntry
+const PdoEntryDescription pdoEntryDescriptions[] = {
+    {PdoEntry::TargetPosition, "target_position", OD_INDEX_TARGET_POSITION, 0, 4, true, false},
+    {PdoEntry::TargetVelocity, "target_velocity", OD_INDEX_TARGET_VELOCITY, 0, 4, true, false},
+    {PdoEntry::TargetTorque, "target_torque", OD_INDEX_TARGET_TORQUE, 0, 2, true, false},
+    {PdoEntry::MaxTorque, "max_torque", OD_INDEX_MAX_TORQUE, 0, 2, true, false},
+    {PdoEntry::Controlword, "controlword", OD_INDEX_CONTROLWORD, 0, 2, true, false},
+    {PdoEntry::ModeOfOperation, "mode_of_operation", OD_INDEX_MODES_OF_OPERATION, 0, 1, true, false},
+    {PdoEntry::TorqueOffset, "torque_offset", OD_INDEX_OFFSET_TORQUE, 0, 2, true, false},
+    {PdoEntry::ActualPosition, "actual_position", OD_INDEX_POSITION_ACTUAL, 0, 4, false, true},
+    {PdoEntry::DigitalInputs, "digital_inputs", OD_INDEX_DIGITAL_INPUTS, 0, 4, false, true},
+    {PdoEntry::ActualVelocity, "actual_velocity", OD_INDEX_VELOCITY_ACTUAL, 0, 4, false, true},
+    {PdoEntry::Statusword, "statusword", OD_INDEX_STATUSWORD, 0, 2, false, true},
+    {PdoEntry::AnalogInput, "analog_input", OD_INDEX_ANALOG_INPUT, 1, 2, false, true},
+    {PdoEntry::ActualCurrent, "actual_current", OD_INDEX_CURRENT_ACTUAL, 0, 2, false, true},
+    {PdoEntry::ActualTorque, "actual_torque", OD_INDEX_TORQUE_ACTUAL, 0, 2, false, true},
+    {PdoEntry::BusVoltage, "bus_voltage", OD_INDEX_DC_LINK_VOLTAGE, 0, 4, false, true},
+    {PdoEntry::Padding, "padding", OD_INDEX_DUMMY_UINT8, 0, 1, true, true},
+    {PdoEntry::ModeOfOperationDisplay, "mode_of_operation_display", OD_INDEX_MODES_OF_OPERATION_DISPLAY, 0, 1,
+     false, true},
+};
+
+}  // namespace
+
+constexpr std::size_t PdoLayout::maxSize;
+constexpr std::size_t PdoLayout::maxNumberOfEntries;
+
+const PdoEntryDescription& PdoLayout::getEntryDescription(PdoEntry entry) {
+  return pdoEntryDescriptions[static_cast<std::size_t>(entry)];
+}
+
+bool PdoLayout::getEntryFromName(const std::string& name, PdoEntry& entry) {
+  for (const auto& description : pdoEntryDescriptions) {
+    if (name == description.name) {
+      entry = description.entry;
+      return true;
+    }
+  }
+  return false;
+}
+
+void PdoLayout::addEntry(PdoEntry entry) {
+  const auto& description = getEntryDescription(entry);
+  entries_.push_back({entry, size_, description.size});
+  size_ += description.size;
+}
+
+void PdoLayout::clear() {
+  entries_.clear();
+  size_ = 0;
+}
+
+bool PdoLayout::contains(PdoEntry entry) const {
+  return std::any_of(entries_.begin(), entries_.end(),
+                     [entry](const MappedEntry& mappedEntry) { return mappedEntry.entry == entry; });
+}
+
+bool PdoLayout::isRxPdoLayout() const {
+  return std::all_of(entries_.begin(), entries_.end(), [](const MappedEntry& mappedEntry) {
+    return getEntryDescription(mappedEntry.entry).isRxPdoEntry;
+  });
+}
+
+bool PdoLayout::isTxPdoLayout() const {
+  return std::all_of(entries_.begin(), entries_.end(), [](const MappedEntry& mappedEntry) {
+    return getEntryDescription(mappedEntry.entry).isTxPdoEntry;
+  });
+}
+
+std::vector<uint32_t> PdoLayout::getMappingEntries() const {
+  std::vector<uint32_t> mappingEntries;
+  mappingEntries.reserve(entries_.size());
+  for (const auto& mappedEntry : entries_) {
+    const auto& description = getEntryDescription(mappedEntry.entry);
+    mappingEntries.push_back(static_cast<uint32_t>(description.index) << 16 |
+                             static_cast<uint32_t>(description.subindex) << 8 |
+                             static_cast<uint32_t>(8 * description.size));
+  }
+  return mappingEntries;
+}
+
+void PdoLayout::decodeTxPdo(const uint8_t* data, int direction, ReadingSnapshot& snapshot) const {
+  for (const auto& mappedEntry : entries_) {
+    const uint8_t* entryData = data + mappedEntry.offset;
+    switch (mappedEntry.entry) {
+      case PdoEntry::ActualPosition:
+        PdoEntryCodec<PdoEntry::ActualPosition>::decode(entryData, direction, snapshot);
+        break;
+      case PdoEntry::DigitalInputs:
+        PdoEntryCodec<PdoEntry::DigitalInputs>::decode(entryData, direction, snapshot);
+        break;
+      case PdoEntry::ActualVelocity:
+        PdoEntryCodec<PdoEntry::ActualVelocity>::decode(entryData, direction, snapshot);
+        break;
+      case PdoEntry::Statusword:
+        PdoEntryCodec<PdoEntry::Statusword>::decode(entryData, direction, snapshot);
+        break;
+      case PdoEntry::AnalogInput:
+        PdoEntryCodec<PdoEntry::AnalogInput>::decode(entryData, direction, snapshot);
+        break;
+      case PdoEntry::ActualCurrent:
+        PdoEntryCodec<PdoEntry::ActualCurrent>::decode(entryData, direction, snapshot);
+        break;
+      case PdoEntry::ActualTorque:
+        PdoEntryCodec<PdoEntry::ActualTorque>::decode(entryData, direction, snapshot);
+        break;
+      case PdoEntry::BusVoltage:
+        PdoEntryCodec<PdoEntry::BusVoltage>::decode(entryData, direction, snapshot);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void PdoLayout::encodeRxPdo(const RxPdoStandard& command, uint16_t controlword, uint8_t* data) const {
+  for (const auto& mappedEntry : entries_) {
+    uint8_t* entryData = data + mappedEntry.offset;
+    switch (mappedEntry.entry) {
+      case PdoEntry::TargetPosition:
+        PdoEntryCodec<PdoEntry::TargetPosition>::encode(command, controlword, entryData);
+        break;
+      case PdoEntry::TargetVelocity:
+        PdoEntryCodec<PdoEntry::TargetVelocity>::encode(command, controlword, entryData);
+        break;
+      case PdoEntry::TargetTorque:
+        PdoEntryCodec<PdoEntry::TargetTorque>::encode(command, controlword, entryData);
+        break;
+      case PdoEntry::MaxTorque:
+        PdoEntryCodec<PdoEntry::MaxTorque>::encode(command, controlword, entryData);
+        break;
+      case PdoEntry::Controlword:
+        PdoEntryCodec<PdoEntry::Controlword>::encode(command, controlword, entryData);
+        break;
+      case PdoEntry::ModeOfOperation:
+        PdoEntryCodec<PdoEntry::ModeOfOperation>::encode(command, controlword, entryData);
+        break;
+      case PdoEntry::TorqueOffset:
+        PdoEntryCodec<PdoEntry::TorqueOffset>::encode(command, controlword, entryData);
+        break;
+      case PdoEntry::Padding:
+        PdoEntryCodec<PdoEntry::Padding>::encode(command, controlword, entryData);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+bool PdoLayout::operator==(const PdoLayout& other) const {
+  return entries_.size() == other.entries_.size() &&
+         std::equal(entries_.begin(), entries_.end(), other.entries_.begin(),
+                    [](const MappedEntry& lhs, const MappedEntry& rhs) { return lhs.entry == rhs.entry; });
+}
+
+}  // namespace elmo
+
+std::ostream& operator<<(std::ostream& os, const elmo::PdoLayout& pdoLayout) {
+  os << "[";
+  for (std::size_t i = 0; i < pdoLayout.getEntries().size(); i++) {
+    if (i > 0) {
+      os << ", ";
+    }
+    os << elmo::PdoLayout::getEntryDescription(pdoLayout.getEntries()[i].entry).name;
+  }
+  os << "] (" << pdoLayout.getSize() << " bytes)";
+  return os;
+}
@@ -0,0 +1,306 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/PdoRecorder.hpp"
+#include "elmo_ethercat_sdk/PdoCodec.hpp"
+#include "elmo_ethercat_sdk/Statusword.hpp"
+
+#include <message_logger/message_logger.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace elmo {
+
+static_assert(sizeof(PdoRecordFileHeader) <= PdoRecordFileHeader::size, "The file header does not fit");
+static_assert(sizeof(PdoRecord) % 8 == 0, "The records must stay aligned in the ring");
+static_assert(PdoCodec<RxPdoStandard>::size <= PdoLayout::maxSize && PdoCodec<TxPdoStandard>::size <= PdoLayout::maxSize,
+              "The standard PDOs do not fit into a record");
+
+constexpr char PdoRecordFileHeader::magic[];
+constexpr uint32_t PdoRecordFileHeader::currentVersion;
+constexpr std::size_t PdoRecordFileHeader::size;
+constexpr std::size_t PdoRecordFileHeader::maxNumberOfEntries;
+
+namespace {
+
+int64_t toNanoseconds(const std::chrono::nanoseconds& duration) {
+  return static_cast<int64_t>(duration.count());
+}
+
+void describePdo(const PdoLayout& layout, uint8_t& numberOfEntries, uint8_t* entries) {
+  numberOfEntries = static_cast<uint8_t>(std::min(layout.getEntries().size(), PdoRecordFileHeader::maxNumberOfEntries));
+  for (std::size_t i = 0; i < numberOfEntries; i++) {
+    entries[i] = static_cast<uint8_t>(layout.getEntries()[i].entry);
+  }
+}
+
+bool readPdo(uint8_t numberOfEntries, const uint8_t* entries, PdoLayout& layout) {
+  layout.clear();
+  if (numberOfEntries > PdoRecordFileHeader::maxNumberOfEntries) {
+    return false;
+  }
+  for (std::size_t i = 0; i < numberOfEntries; i++) {
+    if (entries[i] > static_cast<uint8_t>(PdoEntry::ModeOfOperationDisplay)) {
+      return false;
+    }
+    layout.addEntry(static_cast<PdoEntry>(entries[i]));
+  }
+  return true;
+}
+
+void printEntry(std::ostream& os, PdoEntry entry, const uint8_t* data) {
+  switch (entry) {
+    case PdoEntry::TargetPosition:
+    case PdoEntry::TargetVelocity:
+    case PdoEntry::ActualPosition:
+    case PdoEntry::ActualVelocity:
+      os << loadPdoValue<int32_t>(data);
+      break;
+    case PdoEntry::TargetTorque:
+    case PdoEntry::TorqueOffset:
+    case PdoEntry::AnalogInput:
+    case PdoEntry::ActualCurrent:
+    case PdoEntry::ActualTorque:
+      os << loadPdoValue<int16_t>(data);
+      break;
+    case PdoEntry::MaxTorque:
+      os << loadPdoValue<uint16_t>(data);
+      break;
+    case PdoEntry::BusVoltage:
+      os << loadPdoValue<uint32_t>(data);
+      break;
+    case PdoEntry::ModeOfOperation:
+    case PdoEntry::ModeOfOperationDisplay:
+      os << static_cast<int>(loadPdoValue<int8_t>(data));
+      break;
+    case PdoEntry::Controlword:
+      os << "0x" << std::hex << std::setw(4) << std::setfill('0') << loadPdoValue<uint16_t>(data) << std::dec
+         << std::setfill(' ');
+      break;
+    case PdoEntry::Statusword: {
+      const uint16_t statusword = loadPdoValue<uint16_t>(data);
+      os << "0x" << std::hex << std::setw(4) << std::setfill('0') << statusword << std::dec << std::setfill(' ')
+         << " (" << decodeDriveState(statusword) << ")";
+      break;
+    }
+    case PdoEntry::DigitalInputs:
+      os << "0x" << std::hex << std::setw(8) << std::setfill('0') << loadPdoValue<uint32_t>(data) << std::dec
+         << std::setfill(' ');
+      break;
+    case PdoEntry::Padding:
+      break;
+  }
+}
+
+}  // namespace
+
+PdoRecorder::~PdoRecorder() {
+  close();
+}
+
+bool PdoRecorder::open(const std::string& fileName, std::size_t capacity) {
+  close();
+  if (capacity == 0) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecorder::open] The capacity of '" << fileName << "' must be > 0.");
+    return false;
+  }
+
+  const std::size_t mappingSize = PdoRecordFileHeader::size + capacity * sizeof(PdoRecord);
+  const int fileDescriptor = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fileDescriptor < 0) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecorder::open] Cannot create '" << fileName
+                      << "': " << std::strerror(errno));
+    return false;
+  }
+  // allocate the blocks now, writing to the mapping of a sparse file fails if the disk is full
+  const int error = posix_fallocate(fileDescriptor, 0, static_cast<off_t>(mappingSize));
+  if (error != 0) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecorder::open] Cannot allocate " << mappingSize << " bytes for '"
+                      << fileName << "': " << std::strerror(error));
+    ::close(fileDescriptor);
+    return false;
+  }
+  void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+  // the mapping keeps the file open
+  ::close(fileDescriptor);
+  if (mapping == MAP_FAILED) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecorder::open] Cannot map '" << fileName
+                      << "': " << std::strerror(errno));
+    return false;
+  }
+
+  // touch all pages, recording must not page fault. Locking the pages is optional
+  // (limited by RLIMIT_MEMLOCK).
+  std::memset(mapping, 0, mappingSize);
+  mlock(mapping, mappingSize);
+
+  header_ = static_cast<PdoRecordFileHeader*>(mapping);
+  records_ = reinterpret_cast<PdoRecord*>(static_cast<uint8_t*>(mapping) + PdoRecordFileHeader::size);
+  capacity_ = capacity;
+  mappingSize_ = mappingSize;
+  numberOfRecords_ = 0;
+
+  std::memcpy(header_->fileMagic, PdoRecordFileHeader::magic, sizeof(header_->fileMagic));
+  header_->version = PdoRecordFileHeader::currentVersion;
+  header_->recordSize = sizeof(PdoRecord);
+  header_->capacity = capacity;
+  header_->steadyTimeAtOpen = toNanoseconds(std::chrono::steady_clock::now().time_since_epoch());
+  header_->systemTimeAtOpen = toNanoseconds(std::chrono::system_clock::now().time_since_epoch());
+  header_->rxPdoType = static_cast<int8_t>(RxPdoTypeEnum::NA);
+  header_->txPdoType = static_cast<int8_t>(TxPdoTypeEnum::NA);
+  return true;
+}
+
+void PdoRecorder::close() {
+  if (header_ == nullptr) {
+    return;
+  }
+  munmap(header_, mappingSize_);
+  header_ = nullptr;
+  records_ = nullptr;
+  capacity_ = 0;
+  mappingSize_ = 0;
+}
+
+void PdoRecorder::setPdos(const std::string& name, RxPdoTypeEnum rxPdoType, const PdoLayout& rxPdoLayout,
+                          TxPdoTypeEnum txPdoType, const PdoLayout& txPdoLayout) {
+  if (header_ == nullptr) {
+    return;
+  }
+  std::memset(header_->name, 0, sizeof(header_->name));
+  std::strncpy(header_->name, name.c_str(), sizeof(header_->name) - 1);
+  header_->rxPdoType = static_cast<int8_t>(rxPdoType);
+  header_->txPdoType = static_cast<int8_t>(txPdoType);
+  describePdo(rxPdoLayout, header_->rxPdoNumberOfEntries, header_->rxPdoEntries);
+  describePdo(txPdoLayout, header_->txPdoNumberOfEntries, header_->txPdoEntries);
+}
+
+void PdoRecorder::record(PdoRecord::Type type, const uint8_t* data, std::size_t size) {
+  if (header_ == nullptr) {
+    return;
+  }
+  const uint64_t sequenceNumber = ++numberOfRecords_;
+  PdoRecord& record = records_[(sequenceNumber - 1) % capacity_];
+
+  // invalidate the record while it is written, such that a record torn by a
+  // crash is skipped by the reader
+  __atomic_store_n(&record.sequenceNumber, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  record.timestamp = toNanoseconds(std::chrono::steady_clock::now().time_since_epoch());
+  record.type = type;
+  record.size = static_cast<uint8_t>(std::min(size, PdoLayout::maxSize));
+  std::memcpy(record.data, data, record.size);
+  __atomic_store_n(&record.sequenceNumber, sequenceNumber, __ATOMIC_RELEASE);
+  __atomic_store_n(&header_->numberOfRecords, sequenceNumber, __ATOMIC_RELEASE);
+}
+
+bool PdoRecordReader::open(const std::string& fileName) {
+  records_.clear();
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecordReader::open] Cannot open '" << fileName << "'.");
+    return false;
+  }
+  file.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+  if (!file || std::memcmp(header_.fileMagic, PdoRecordFileHeader::magic, sizeof(header_.fileMagic)) != 0 ||
+      header_.version != PdoRecordFileHeader::currentVersion || header_.recordSize != sizeof(PdoRecord)) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecordReader::open] '" << fileName
+                      << "' is not a PDO record file of version " << PdoRecordFileHeader::currentVersion << ".");
+    return false;
+  }
+  header_.name[sizeof(header_.name) - 1] = '\0';
+  if (!readPdo(header_.rxPdoNumberOfEntries, header_.rxPdoEntries, rxPdoLayout_) ||
+      !readPdo(header_.txPdoNumberOfEntries, header_.txPdoEntries, txPdoLayout_)) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecordReader::open] The PDO description of '" << fileName
+                      << "' is invalid.");
+    return false;
+  }
+
+  // check the capacity against the size of the file before allocating the records
+  file.seekg(0, std::ios::end);
+  const std::streamoff fileSize = file.tellg();
+  if (header_.capacity == 0 || fileSize < static_cast<std::streamoff>(PdoRecordFileHeader::size) ||
+      header_.capacity > static_cast<uint64_t>(fileSize - PdoRecordFileHeader::size) / sizeof(PdoRecord)) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecordReader::open] '" << fileName << "' is truncated or corrupted: "
+                      << header_.capacity << " records do not fit into " << fileSize << " bytes.");
+    return false;
+  }
+
+  file.seekg(PdoRecordFileHeader::size);
+  std::vector<PdoRecord> records(header_.capacity);
+  file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(PdoRecord)));
+  if (!file) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoRecordReader::open] '" << fileName << "' is truncated.");
+    return false;
+  }
+
+  for (std::size_t slot = 0; slot < records.size(); slot++) {
+    const PdoRecord& record = records[slot];
+    // skip empty / torn records and records which are not in their slot
+    if (record.sequenceNumber == 0 || (record.sequenceNumber - 1) % header_.capacity != slot ||
+        record.size > PdoLayout::maxSize) {
+      continue;
+    }
+    records_.push_back(record);
+  }
+  std::sort(records_.begin(), records_.end(), [](const PdoRecord& a, const PdoRecord& b) {
+    return a.sequenceNumber < b.sequenceNumber;
+  });
+  return true;
+}
+
+double PdoRecordReader::getWallTime(const PdoRecord& record) const {
+  return 1.0e-9 * static_cast<double>(record.timestamp - header_.steadyTimeAtOpen + header_.systemTimeAtOpen);
+}
+
+void PdoRecordReader::printRecord(std::ostream& os, const PdoRecord& record) const {
+  const bool isRxPdo = record.type == PdoRecord::Type::RxPdo;
+  os << record.sequenceNumber << " " << std::fixed << std::setprecision(6) << getWallTime(record)
+     << (isRxPdo ? " RxPdo" : " TxPdo");
+  const PdoLayout& layout = isRxPdo ? rxPdoLayout_ : txPdoLayout_;
+  if (layout.getSize() != record.size) {
+    // recorded with another configuration
+    os << " (" << static_cast<unsigned int>(record.size) << " bytes, unknown layout)" << std::hex
+       << std::setfill('0');
+    for (std::size_t i = 0; i < record.size; i++) {
+      os << " " << std::setw(2) << static_cast<unsigned int>(record.data[i]);
+    }
+    os << std::dec << std::setfill(' ');
+    return;
+  }
+  for (const auto& mappedEntry : layout.getEntries()) {
+    if (mappedEntry.entry == PdoEntry::Padding) {
+      continue;
+    }
+    os << " " << PdoLayout::getEntryDescription(mappedEntry.entry).name << "=";
+    printEntry(os, mappedEntry.entry, record.data + mappedEntry.offset);
+  }
+}
+
+}  // namespace elmo
@@ -0,0 +1,148 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/PdoReplay.hpp"
+#include "elmo_ethercat_sdk/Elmo.hpp"
+#include "elmo_ethercat_sdk/PdoCodec.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace elmo {
+
+PdoReplay::PdoReplay(const std::string& name) : soem_interface::EthercatBusBase(name) {}
+
+bool PdoReplay::open(const std::string& fileName) {
+  if (!recording_.open(fileName)) {
+    return false;
+  }
+  outputs_.assign(recording_.getRxPdoLayout().getSize(), 0);
+  inputs_.assign(recording_.getTxPdoLayout().getSize(), 0);
+  return true;
+}
+
+bool PdoReplay::attach(Elmo& elmo) {
+  const uint32_t address = elmo.getAddress();
+  if (address == 0 || address >= EC_MAXSLAVE) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoReplay::attach] The address " << address << " of '" << elmo.getName()
+                      << "' is not valid.");
+    return false;
+  }
+
+  // the drive has to encode / decode the PDOs like the recorded drive
+  const PdoRecordFileHeader& header = recording_.getHeader();
+  const Configuration configuration = elmo.getConfiguration();
+  const PdoLayout rxPdoLayout = getRxPdoLayout(configuration.rxPdoTypeEnum, configuration.rxPdoLayout);
+  const PdoLayout txPdoLayout = getTxPdoLayout(configuration.txPdoTypeEnum, configuration.txPdoLayout);
+  if (static_cast<int8_t>(configuration.rxPdoTypeEnum) != header.rxPdoType ||
+      static_cast<int8_t>(configuration.txPdoTypeEnum) != header.txPdoType || rxPdoLayout.empty() ||
+      txPdoLayout.empty() || rxPdoLayout != recording_.getRxPdoLayout() ||
+      txPdoLayout != recording_.getTxPdoLayout()) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoReplay::attach] The PDOs of '"
+                      << elmo.getName() << "' (" << configuration.rxPdoTypeEnum << " " << rxPdoLayout << ", "
+                      << configuration.txPdoTypeEnum << " " << txPdoLayout << ") differ from the recording ("
+                      << static_cast<RxPdoTypeEnum>(header.rxPdoType) << " " << recording_.getRxPdoLayout() << ", "
+                      << static_cast<TxPdoTypeEnum>(header.txPdoType) << " " << recording_.getTxPdoLayout() << ").");
+    return false;
+  }
+
+  ecatSlavecount_ = static_cast<int>(address);
+  ecatSlavelist_[address].outputs = outputs_.data();
+  ecatSlavelist_[address].Obytes = static_cast<uint32_t>(outputs_.size());
+  ecatSlavelist_[address].inputs = inputs_.data();
+  ecatSlavelist_[address].Ibytes = static_cast<uint32_t>(inputs_.size());
+  elmo.setEthercatBusBasePointer(this);
+  elmo.setCycleClock(&clock_);
+  elmo_ = &elmo;
+  return true;
+}
+
+PdoReplayResult PdoReplay::run(const Controller& controller, std::size_t maxNumberOfReportedMismatches) {
+  PdoReplayResult result;
+  if (elmo_ == nullptr) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:PdoReplay::run] No drive is attached.");
+    return result;
+  }
+
+  const std::vector<PdoRecord>& records = recording_.getRecords();
+  const auto start = std::chrono::steady_clock::now();
+  for (const PdoRecord& record : records) {
+    clock_.setTime(record.timestamp);
+    if (record.type == PdoRecord::Type::TxPdo) {
+      std::memcpy(inputs_.data(), record.data, std::min<std::size_t>(record.size, inputs_.size()));
+      elmo_->updateRead();
+      result.numberOfTxPdos++;
+      continue;
+    }
+
+    if (controller) {
+      controller(*elmo_, result.numberOfRxPdos);
+    }
+    // a RxPdo which is not written by the drive differs from the recording
+    std::fill(outputs_.begin(), outputs_.end(), 0);
+    elmo_->updateWrite();
+    result.numberOfRxPdos++;
+    if (record.size != outputs_.size() || std::memcmp(outputs_.data(), record.data, record.size) != 0) {
+      if (result.numberOfMismatches < maxNumberOfReportedMismatches) {
+        reportMismatch(record);
+      }
+      if (result.numberOfMismatches == 0) {
+        result.firstMismatch = record.sequenceNumber;
+      }
+      result.numberOfMismatches++;
+    }
+  }
+  result.replayDuration = std::chrono::steady_clock::now() - start;
+  if (!records.empty()) {
+    result.recordedDuration = std::chrono::nanoseconds(records.back().timestamp - records.front().timestamp);
+  }
+  return result;
+}
+
+void PdoReplay::reportMismatch(const PdoRecord& record) const {
+  PdoRecord replayedRecord = record;
+  replayedRecord.size = static_cast<uint8_t>(outputs_.size());
+  std::memcpy(replayedRecord.data, outputs_.data(), outputs_.size());
+  std::stringstream recorded;
+  recording_.printRecord(recorded, record);
+  std::stringstream replayed;
+  recording_.printRecord(replayed, replayedRecord);
+  MELO_WARN_STREAM("[elmo_ethercat_sdk:PdoReplay::run] The RxPdo of '" << elmo_->getName()
+                   << "' differs from the recording:\n  recorded: " << recorded.str()
+                   << "\n  replayed: " << replayed.str());
+}
+
+}  // namespace elmo
+
+std::ostream& operator<<(std::ostream& os, const elmo::PdoReplayResult& result) {
+  const double recordedDuration = 1.0e-9 * static_cast<double>(result.recordedDuration.count());
+  const double replayDuration = 1.0e-9 * static_cast<double>(result.replayDuration.count());
+  os << "replayed " << result.numberOfRxPdos << " RxPdos / " << result.numberOfTxPdos << " TxPdos of "
+     << recordedDuration << " s in " << replayDuration << " s";
+  if (replayDuration > 0.0) {
+    os << " (" << recordedDuration / replayDuration << "x real time)";
+  }
+  os << ", " << result.numberOfMismatches << " RxPdos differ";
+  if (result.numberOfMismatches > 0) {
+    os << " (first: record " << result.firstMismatch << ")";
+  }
+  return os;
+}
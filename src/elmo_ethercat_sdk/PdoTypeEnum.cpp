@@ -31,6 +31,9 @@ std::ostream& operator<<(std::ostream& os, const elmo::TxPdoTypeEnum& txPdoTypeE
         case elmo::TxPdoTypeEnum::TxPdoCST:
             os << "TxPdoCST";
             break;
+        case elmo::TxPdoTypeEnum::TxPdoCustom:
+            os << "TxPdoCustom";
+            break;
         default:
             break;
     }
@@ -47,6 +50,9 @@ std::ostream& operator<<(std::ostream& os, const elmo::RxPdoTypeEnum& rxPdoTypeE
         case elmo::RxPdoTypeEnum::RxPdoCST:
             os << "RxPdoCST";
             break;
+        case elmo::RxPdoTypeEnum::RxPdoCustom:
+            os << "RxPdoCustom";
+            break;
         default:
             break;
     }
@@ -18,9 +18,6 @@
 ** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
  */
 
-#define _USE_MATH_DEFINES  // for M_PI
-#include <cmath>
-
 #include "elmo_ethercat_sdk/Reading.hpp"
 
 std::ostream& operator<<(std::ostream& os, const elmo::Reading& reading) {
@@ -40,137 +37,13 @@ std::ostream& operator<<(std::ostream& os, const elmo::Reading& reading) {
 
 namespace elmo{
 
-std::string Reading::getDigitalInputString() const {
-  std::string binString;
-  for (unsigned int i = 0; i < 8 * sizeof(digitalInputs_); i++) {
-    if ((digitalInputs_ & (1 << (8 * sizeof(digitalInputs_) - 1 - i))) != 0) {
-      binString += "1";
-    } else {
-      binString += "0";
-    }
-    if ((i + 1) % 8 == 0) {
-      binString += " ";
-    }
-  }
-  binString.erase(binString.end() - 1);
-  return binString;
-}
-
-DriveState Reading::getDriveState() const {
-  return getStatusword().getDriveState();
-}
-
-double Reading::getAgeOfLastReadingInMicroseconds() const {
-  ReadingDuration readingDuration = ReadingClock::now() - lastReadingTimePoint_;
-  return readingDuration.count();
-}
-
-/*!
- * Raw get methods
- */
-int32_t Reading::getActualPositionRaw() const {
-  return actualPosition_;
-}
-int32_t Reading::getActualVelocityRaw() const {
-  return actualVelocity_;
-}
-uint16_t Reading::getRawStatusword() const {
-  return statusword_;
-}
-int16_t Reading::getActualCurrentRaw() const {
-  return actualCurrent_;
-}
-uint16_t Reading::getAnalogInputRaw() const {
-  return analogInput_;
-}
-uint32_t Reading::getBusVoltageRaw() const {
-  return busVoltage_;
-}
-
-/*!
- * User unit get methods
- */
-double Reading::getActualPosition() const {
-  return static_cast<double>(actualPosition_) * positionFactorIntegerToRad_;
-}
-double Reading::getActualVelocity() const {
-  return static_cast<double>(actualVelocity_) * velocityFactorIntegerPerSecToRadPerSec_;
-}
-double Reading::getActualCurrent() const {
-  return static_cast<double>(actualCurrent_) * currentFactorIntegerToAmp_;
-}
-double Reading::getActualTorque() const {
-  return static_cast<double>(actualCurrent_) * torqueFactorIntegerToNm_;
-}
-double Reading::getAnalogInput() const {
-  return static_cast<double>(analogInput_) * 0.001;
-}
-
-/*!
- * Other readings
- */
-int32_t Reading::getDigitalInputs() const {
-  return digitalInputs_;
-}
-Statusword Reading::getStatusword() const {
-  Statusword statusword;
-  statusword.setFromRawStatusword(statusword_);
-  return statusword;
-}
-double Reading::getBusVoltage() const {
-  return 0.001 * static_cast<double>(busVoltage_);
-}
-
-/*!
- * Raw set methods
- */
-void Reading::setActualPosition(int32_t actualPosition) {
-  actualPosition_ = actualPosition;
-}
-void Reading::setDigitalInputs(int32_t digitalInputs) {
-  digitalInputs_ = digitalInputs;
-}
-void Reading::setActualVelocity(int32_t actualVelocity) {
-  actualVelocity_ = actualVelocity;
-}
-void Reading::setStatusword(uint16_t statusword) {
-  statusword_ = statusword;
-}
-
-void Reading::setAnalogInput(int16_t analogInput) {
-  analogInput_ = analogInput;
-}
-void Reading::setActualCurrent(int16_t actualCurrent) {
-  actualCurrent_ = actualCurrent;
-}
-void Reading::setBusVoltage(uint32_t busVoltage) {
-  busVoltage_ = busVoltage;
-}
-void Reading::setTimePointNow() {
-  lastReadingTimePoint_ = ReadingClock::now();
-}
-
-void Reading::setPositionFactorIntegerToRad(double positionFactor) {
-  positionFactorIntegerToRad_ = positionFactor;
-}
-void Reading::setVelocityFactorIntegerPerSecToRadPerSec(double velocityFactor) {
-  velocityFactorIntegerPerSecToRadPerSec_ = velocityFactor;
-}
-void Reading::setCurrentFactorIntegerToAmp(double currentFactor) {
-  currentFactorIntegerToAmp_ = currentFactor;
-}
-void Reading::setTorqueFactorIntegerToNm(double torqueFactor) {
-  torqueFactorIntegerToNm_ = torqueFactor;
-}
-
-
 double Reading::getAgeOfLastErrorInMicroseconds() const {
-  ReadingDuration errorDuration = ReadingClock::now() - lastError_.second;
+  const std::chrono::duration<double, std::micro> errorDuration = ReadingClock::now() - lastError_.second;
   return errorDuration.count();
 }
 
 double Reading::getAgeOfLastFaultInMicroseconds() const {
-  ReadingDuration faultDuration = ReadingClock::now() - lastFault_.second;
+  const std::chrono::duration<double, std::micro> faultDuration = ReadingClock::now() - lastFault_.second;
   return faultDuration.count();
 }
 
@@ -178,20 +51,14 @@ void Reading::addError(ErrorType errorType) {
   ErrorPair errorPair;
   errorPair.first = errorType;
   errorPair.second = ReadingClock::now();
-  if (lastError_.first == errorType) {
-    if (forceAppendEqualError_) {
-      errors_.push_front(errorPair);
-    } else {
-      errors_.pop_front();
-      errors_.push_front(errorPair);
-    }
+  if (lastError_.first == errorType && !forceAppendEqualError_ && !errors_.empty()) {
+    // replace the equal entry instead of appending
+    errors_.front() = errorPair;
   } else {
-    errors_.push_front(errorPair);
+    // overwrites the oldest entry if the storage capacity is reached
+    errors_.pushFront(errorPair);
   }
   lastError_ = errorPair;
-  if (errors_.size() > errorStorageCapacity_) {
-    errors_.pop_back();
-  }
   hasUnreadError_ = true;
 }
 
@@ -199,32 +66,24 @@ void Reading::addFault(uint16_t faultCode) {
   FaultPair faultPair;
   faultPair.first = faultCode;
   faultPair.second = ReadingClock::now();
-  if (lastFault_.first == faultCode) {
-    if (forceAppendEqualFault_) {
-      faults_.push_front(faultPair);
-    } else {
-      faults_.pop_front();
-      faults_.push_front(faultPair);
-    }
+  if (lastFault_.first == faultCode && !forceAppendEqualFault_ && !faults_.empty()) {
+    // replace the equal entry instead of appending
+    faults_.front() = faultPair;
   } else {
-    faults_.push_front(faultPair);
+    // overwrites the oldest entry if the storage capacity is reached
+    faults_.pushFront(faultPair);
   }
   lastFault_ = faultPair;
-  if (faults_.size() > faultStorageCapacity_) {
-    faults_.pop_back();
-  }
   hasUnreadFault_ = true;
 }
 
 ErrorTimePairDeque Reading::getErrors() const {
   ReadingTimePoint now = ReadingClock::now();
   ErrorTimePairDeque errors;
-  errors.resize(errors_.size());
   ReadingDuration duration;
-  for (unsigned int i = 0; i < errors_.size(); i++) {
-    errors[i].first = errors_[i].first;
-    duration = now - errors_[i].second;
-    errors[i].second = duration.count();
+  for (const ErrorPair& errorPair : errors_) {
+    duration = now - errorPair.second;
+    errors.emplace_back(errorPair.first, duration.count());
   }
   hasUnreadError_ = false;
   return errors;
@@ -233,17 +92,25 @@ ErrorTimePairDeque Reading::getErrors() const {
 FaultTimePairDeque Reading::getFaults() const {
   ReadingTimePoint now = ReadingClock::now();
   FaultTimePairDeque faults;
-  faults.resize(faults_.size());
   ReadingDuration duration;
-  for (unsigned int i = 0; i < faults_.size(); i++) {
-    faults[i].first = faults_[i].first;
-    duration = now - faults_[i].second;
-    faults[i].second = duration.count();
+  for (const FaultPair& faultPair : faults_) {
+    duration = now - faultPair.second;
+    faults.emplace_back(faultPair.first, duration.count());
   }
   hasUnreadFault_ = false;
   return faults;
 }
 
+const RingBuffer<ErrorPair>& Reading::getErrorHistory() const {
+  hasUnreadError_ = false;
+  return errors_;
+}
+
+const RingBuffer<FaultPair>& Reading::getFaultHistory() const {
+  hasUnreadFault_ = false;
+  return faults_;
+}
+
 ErrorType Reading::getLastError() const {
   hasUnreadError_ = false;
   return lastError_.first;
@@ -266,24 +133,16 @@ bool Reading::hasUnreadFault() const {
 }
 
 void Reading::configureReading(const Configuration& configuration) {
-  errorStorageCapacity_ = configuration.errorStorageCapacity;
-  faultStorageCapacity_ = configuration.faultStorageCapacity;
+  configureReading(configuration, ConversionTable(configuration));
+}
+
+void Reading::configureReading(const Configuration& configuration, const ConversionTable& conversionTable) {
+  errors_.setCapacity(configuration.errorStorageCapacity);
+  faults_.setCapacity(configuration.faultStorageCapacity);
   forceAppendEqualError_ = configuration.forceAppendEqualError;
   forceAppendEqualFault_ = configuration.forceAppendEqualFault;
 
-  if(configuration.encoderPosition == Configuration::EncoderPosition::joint){
-    positionFactorIntegerToRad_ = (2.0 * M_PI) / static_cast<double>(configuration.positionEncoderResolution);
-    velocityFactorIntegerPerSecToRadPerSec_ = (2.0 * M_PI) / static_cast<double>(configuration.positionEncoderResolution);
-  } else if(configuration.encoderPosition == Configuration::EncoderPosition::motor){
-    positionFactorIntegerToRad_ = (2.0 * M_PI) / static_cast<double>(configuration.positionEncoderResolution) / configuration.gearRatio;
-    velocityFactorIntegerPerSecToRadPerSec_ = (2.0 * M_PI) / static_cast<double>(configuration.positionEncoderResolution) / configuration.gearRatio;
-  }
-
-  double currentFactor = configuration.motorRatedCurrentA / 1000.0;
-
-  currentFactorIntegerToAmp_ = currentFactor;
-
-  torqueFactorIntegerToNm_ = currentFactor * configuration.motorConstant * configuration.gearRatio;
+  setConversionTable(conversionTable);
 }
 
 }  // namespace elmo
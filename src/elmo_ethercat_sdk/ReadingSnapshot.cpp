@@ -0,0 +1,155 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/ReadingSnapshot.hpp"
+
+namespace elmo {
+
+std::string ReadingSnapshot::getDigitalInputString() const {
+  std::string binString;
+  for (unsigned int i = 0; i < 8 * sizeof(digitalInputs_); i++) {
+    if ((digitalInputs_ & (1 << (8 * sizeof(digitalInputs_) - 1 - i))) != 0) {
+      binString += "1";
+    } else {
+      binString += "0";
+    }
+    if ((i + 1) % 8 == 0) {
+      binString += " ";
+    }
+  }
+  binString.erase(binString.end() - 1);
+  return binString;
+}
+
+DriveState ReadingSnapshot::getDriveState() const {
+  return Statusword(statusword_).getDriveState();
+}
+
+double ReadingSnapshot::getAgeOfLastReadingInMicroseconds() const {
+  const std::chrono::duration<double, std::micro> readingDuration = ReadingClock::now() - lastReadingTimePoint_;
+  return readingDuration.count();
+}
+
+/*!
+ * Raw get methods
+ */
+int32_t ReadingSnapshot::getActualPositionRaw() const {
+  return actualPosition_;
+}
+int32_t ReadingSnapshot::getActualVelocityRaw() const {
+  return actualVelocity_;
+}
+uint16_t ReadingSnapshot::getRawStatusword() const {
+  return statusword_;
+}
+int16_t ReadingSnapshot::getActualCurrentRaw() const {
+  return actualCurrent_;
+}
+uint16_t ReadingSnapshot::getAnalogInputRaw() const {
+  return analogInput_;
+}
+uint32_t ReadingSnapshot::getBusVoltageRaw() const {
+  return busVoltage_;
+}
+
+/*!
+ * User unit get methods
+ */
+double ReadingSnapshot::getActualPosition() const {
+  return static_cast<double>(actualPosition_) * positionFactorIntegerToRad_;
+}
+double ReadingSnapshot::getActualVelocity() const {
+  return static_cast<double>(actualVelocity_) * velocityFactorIntegerPerSecToRadPerSec_;
+}
+double ReadingSnapshot::getActualCurrent() const {
+  return static_cast<double>(actualCurrent_) * currentFactorIntegerToAmp_;
+}
+double ReadingSnapshot::getActualTorque() const {
+  return static_cast<double>(actualCurrent_) * torqueFactorIntegerToNm_;
+}
+double ReadingSnapshot::getAnalogInput() const {
+  return static_cast<double>(analogInput_) * 0.001;
+}
+
+/*!
+ * Other readings
+ */
+int32_t ReadingSnapshot::getDigitalInputs() const {
+  return digitalInputs_;
+}
+Statusword ReadingSnapshot::getStatusword() const {
+  return Statusword(statusword_);
+}
+double ReadingSnapshot::getBusVoltage() const {
+  return 0.001 * static_cast<double>(busVoltage_);
+}
+
+/*!
+ * Raw set methods
+ */
+void ReadingSnapshot::setActualPosition(int32_t actualPosition) {
+  actualPosition_ = actualPosition;
+}
+void ReadingSnapshot::setDigitalInputs(int32_t digitalInputs) {
+  digitalInputs_ = digitalInputs;
+}
+void ReadingSnapshot::setActualVelocity(int32_t actualVelocity) {
+  actualVelocity_ = actualVelocity;
+}
+void ReadingSnapshot::setStatusword(uint16_t statusword) {
+  statusword_ = statusword;
+}
+
+void ReadingSnapshot::setAnalogInput(int16_t analogInput) {
+  analogInput_ = analogInput;
+}
+void ReadingSnapshot::setActualCurrent(int16_t actualCurrent) {
+  actualCurrent_ = actualCurrent;
+}
+void ReadingSnapshot::setBusVoltage(uint32_t busVoltage) {
+  busVoltage_ = busVoltage;
+}
+void ReadingSnapshot::setTimePointNow() {
+  lastReadingTimePoint_ = ReadingClock::now();
+}
+void ReadingSnapshot::setTimePoint(const ReadingTimePoint& timePoint) {
+  lastReadingTimePoint_ = timePoint;
+}
+
+void ReadingSnapshot::setPositionFactorIntegerToRad(double positionFactor) {
+  positionFactorIntegerToRad_ = positionFactor;
+}
+void ReadingSnapshot::setVelocityFactorIntegerPerSecToRadPerSec(double velocityFactor) {
+  velocityFactorIntegerPerSecToRadPerSec_ = velocityFactor;
+}
+void ReadingSnapshot::setCurrentFactorIntegerToAmp(double currentFactor) {
+  currentFactorIntegerToAmp_ = currentFactor;
+}
+void ReadingSnapshot::setTorqueFactorIntegerToNm(double torqueFactor) {
+  torqueFactorIntegerToNm_ = torqueFactor;
+}
+void ReadingSnapshot::setConversionTable(const ConversionTable& conversionTable) {
+  positionFactorIntegerToRad_ = conversionTable.getPositionFactorIntegerToRad();
+  velocityFactorIntegerPerSecToRadPerSec_ = conversionTable.getVelocityFactorIntegerPerSecToRadPerSec();
+  currentFactorIntegerToAmp_ = conversionTable.getCurrentFactorIntegerToAmp();
+  torqueFactorIntegerToNm_ = conversionTable.getTorqueFactorIntegerToNm();
+}
+
+}  // namespace elmo
@@ -0,0 +1,210 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/RtLog.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <message_logger/message_logger.hpp>
+
+namespace elmo {
+
+namespace {
+
+const char* getMessageText(RtLogMessage message) {
+  switch (message) {
+    case RtLogMessage::ModeOfOperationNotSet:
+      return "[elmo_ethercat_sdk:Elmo::updateWrite] Mode of operation has not been set";
+    case RtLogMessage::UnsupportedRxPdoType:
+      return "[elmo_ethercat_sdk:Elmo::updateWrite] Unsupported Rx Pdo type";
+    case RtLogMessage::UnsupportedTxPdoType:
+      return "[elmo_ethercat_sdk:Elmo::updateRead] Unsupported Tx Pdo type";
+    case RtLogMessage::DriveInFault:
+      return "[elmo_ethercat_sdk:Elmo::updateRead] Drive is in drive state 'Fault'";
+    case RtLogMessage::UnreachableDriveState:
+      return "[elmo_ethercat_sdk:Elmo::engagePdoStateMachine] Requested drive state cannot be reached";
+    default:
+      return "[elmo_ethercat_sdk:RtLog] Unknown message";
+  }
+}
+
+const char* getValueName(RtLogMessage message) {
+  switch (message) {
+    case RtLogMessage::UnsupportedRxPdoType:
+    case RtLogMessage::UnsupportedTxPdoType:
+      return "pdo type";
+    case RtLogMessage::DriveInFault:
+      return "statusword";
+    case RtLogMessage::UnreachableDriveState:
+      return "current drive state";
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+constexpr std::size_t RtLog::capacity_;
+
+RtLog& RtLog::instance() {
+  static RtLog rtLog;
+  return rtLog;
+}
+
+RtLog::RtLog() {
+  for (std::size_t i = 0; i < capacity_; i++) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  worker_ = std::thread(&RtLog::work, this);
+}
+
+RtLog::~RtLog() {
+  running_ = false;
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+bool RtLog::push(const RtLogRecord& record) {
+  std::size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[position % capacity_];
+    const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+    if (difference == 0) {
+      if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // the worker has not consumed this cell yet, the ring is full
+      numberOfDroppedRecords_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = enqueuePosition_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->record = record;
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+bool RtLog::pop(RtLogRecord& record) {
+  Cell& cell = cells_[dequeuePosition_ % capacity_];
+  if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1) {
+    return false;
+  }
+  record = cell.record;
+  cell.sequence.store(dequeuePosition_ + capacity_, std::memory_order_release);
+  dequeuePosition_++;
+  return true;
+}
+
+void RtLog::print(const RtLogRecord& record) const {
+  switch (record.event) {
+    case RtLogEvent::Raised:
+      if (getValueName(record.message) != nullptr) {
+        MELO_ERROR_STREAM(getMessageText(record.message) << " for '" << record.deviceName << "' ("
+                                                         << getValueName(record.message) << " " << record.value << ").");
+      } else {
+        MELO_ERROR_STREAM(getMessageText(record.message) << " for '" << record.deviceName << "'.");
+      }
+      break;
+    case RtLogEvent::Repeated:
+      MELO_ERROR_STREAM(getMessageText(record.message) << " for '" << record.deviceName << "' (" << record.count
+                                                       << " more times).");
+      break;
+    case RtLogEvent::Cleared:
+      MELO_INFO_STREAM(getMessageText(record.message) << " for '" << record.deviceName << "': cleared after "
+                                                      << record.count << " occurrences.");
+      break;
+  }
+}
+
+void RtLog::work() {
+  RtLogRecord record;
+  while (true) {
+    // read the flag first to drain the ring once more after stopping
+    const bool running = running_;
+    while (pop(record)) {
+      print(record);
+    }
+    const uint64_t numberOfDroppedRecords = getNumberOfDroppedRecords();
+    if (numberOfDroppedRecords != numberOfReportedDroppedRecords_) {
+      MELO_WARN_STREAM("[elmo_ethercat_sdk:RtLog::work] Dropped "
+                       << numberOfDroppedRecords - numberOfReportedDroppedRecords_ << " log records.");
+      numberOfReportedDroppedRecords_ = numberOfDroppedRecords;
+    }
+    if (!running) {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+RtLogCondition::RtLogCondition(RtLogMessage message, std::chrono::steady_clock::duration repeatInterval)
+    : message_(message), repeatInterval_(repeatInterval) {
+  // construct the log (and start its worker) outside of the real-time loop
+  RtLog::instance();
+}
+
+bool RtLogCondition::update(bool active, const std::string& deviceName, int32_t value) {
+  if (!active) {
+    if (active_) {
+      push(RtLogEvent::Cleared, occurrences_, deviceName, value);
+      active_ = false;
+    }
+    return false;
+  }
+
+  occurrences_++;
+  occurrencesSinceLastRecord_++;
+  if (!active_) {
+    active_ = true;
+    occurrences_ = 1;
+    occurrencesSinceLastRecord_ = 0;
+    lastRecordTimePoint_ = std::chrono::steady_clock::now();
+    push(RtLogEvent::Raised, 1, deviceName, value);
+    return true;
+  }
+
+  const auto now = std::chrono::steady_clock::now();
+  if (now - lastRecordTimePoint_ >= repeatInterval_) {
+    push(RtLogEvent::Repeated, occurrencesSinceLastRecord_, deviceName, value);
+    occurrencesSinceLastRecord_ = 0;
+    lastRecordTimePoint_ = now;
+  }
+  return false;
+}
+
+void RtLogCondition::push(RtLogEvent event, uint32_t count, const std::string& deviceName, int32_t value) {
+  RtLogRecord record;
+  record.message = message_;
+  record.event = event;
+  record.count = count;
+  record.value = value;
+  const std::size_t length = std::min(deviceName.size(), sizeof(record.deviceName) - 1);
+  std::memcpy(record.deviceName, deviceName.data(), length);
+  record.deviceName[length] = '\0';
+  RtLog::instance().push(record);
+}
+
+}  // namespace elmo
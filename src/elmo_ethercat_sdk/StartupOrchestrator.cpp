@@ -0,0 +1,185 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/StartupOrchestrator.hpp"
+#include "elmo_ethercat_sdk/Elmo.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include <message_logger/message_logger.hpp>
+
+namespace elmo {
+
+StartupOrchestrator::StartupOrchestrator(std::size_t maxNumberOfWorkers) : maxNumberOfWorkers_(maxNumberOfWorkers) {}
+
+StartupOrchestrator::~StartupOrchestrator() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  workAvailable_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void StartupOrchestrator::addDrive(Elmo* drive) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  drives_.push_back(drive);
+  DriveStartupResult result;
+  result.name = drive->getName();
+  results_.push_back(result);
+}
+
+bool StartupOrchestrator::startup(const Elmo* drive) {
+  startupAll();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::size_t i = 0; i < drives_.size(); i++) {
+    if (drives_[i] == drive) {
+      return results_[i].state == DriveStartupResult::State::Succeeded;
+    }
+  }
+  MELO_ERROR_STREAM("[elmo_ethercat_sdk:StartupOrchestrator::startup] '" << drive->getName()
+                                                                         << "' is not registered.");
+  return false;
+}
+
+bool StartupOrchestrator::startupAll() {
+  std::lock_guard<std::mutex> startupLock(startupMutex_);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  const std::size_t numberOfPendingDrives = drives_.size() - nextDrive_;
+  if (numberOfPendingDrives > 0) {
+    numberOfRequestedDrives_ = drives_.size();
+    const auto start = std::chrono::steady_clock::now();
+    // grow the pool up to one worker per drive, or the maximum number of workers
+    const std::size_t numberOfWorkers =
+        maxNumberOfWorkers_ == 0 ? drives_.size() : std::min(maxNumberOfWorkers_, drives_.size());
+    while (workers_.size() < numberOfWorkers) {
+      workers_.emplace_back(&StartupOrchestrator::work, this);
+    }
+    workAvailable_.notify_all();
+    workFinished_.wait(lock,
+                       [this]() { return nextDrive_ >= numberOfRequestedDrives_ && numberOfRunningDrives_ == 0; });
+    lock.unlock();
+
+    MELO_INFO_STREAM("[elmo_ethercat_sdk:StartupOrchestrator::startupAll] Started up "
+                     << numberOfPendingDrives << " drive(s) with " << workers_.size() << " worker(s) in "
+                     << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+                            .count()
+                     << " ms.");
+    printResults();
+    lock.lock();
+  }
+
+  return std::all_of(results_.begin(), results_.end(), [](const DriveStartupResult& result) {
+    return result.state == DriveStartupResult::State::Succeeded;
+  });
+}
+
+void StartupOrchestrator::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    workAvailable_.wait(lock, [this]() { return stopping_ || nextDrive_ < numberOfRequestedDrives_; });
+    if (stopping_) {
+      return;
+    }
+    const std::size_t index = nextDrive_++;
+    results_[index].state = DriveStartupResult::State::Running;
+    numberOfRunningDrives_++;
+    lock.unlock();
+
+    runDrive(index);
+
+    lock.lock();
+    numberOfRunningDrives_--;
+    if (nextDrive_ >= numberOfRequestedDrives_ && numberOfRunningDrives_ == 0) {
+      workFinished_.notify_all();
+    }
+  }
+}
+
+void StartupOrchestrator::runDrive(std::size_t index) {
+  Elmo* drive;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    drive = drives_[index];
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  bool success = false;
+  try {
+    success = drive->runStartupSequence();
+  } catch (const std::exception& exception) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:StartupOrchestrator::runDrive] Startup of '"
+                      << drive->getName() << "' failed: " << exception.what());
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  // collect the errors which occured during the startup sequence
+  std::vector<ErrorType> errors;
+  const Reading reading = drive->getReading();
+  for (const ErrorPair& errorPair : reading.getErrorHistory()) {
+    if (errorPair.second >= start) {
+      errors.push_back(errorPair.first);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  DriveStartupResult& result = results_[index];
+  result.state = success ? DriveStartupResult::State::Succeeded : DriveStartupResult::State::Failed;
+  result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+  result.errors.assign(errors.rbegin(), errors.rend());
+}
+
+std::vector<DriveStartupResult> StartupOrchestrator::getResults() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return results_;
+}
+
+std::size_t StartupOrchestrator::getNumberOfFinishedDrives() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<std::size_t>(std::count_if(results_.begin(), results_.end(), [](const DriveStartupResult& result) {
+    return result.state == DriveStartupResult::State::Succeeded || result.state == DriveStartupResult::State::Failed;
+  }));
+}
+
+void StartupOrchestrator::printResults() const {
+  for (const DriveStartupResult& result : getResults()) {
+    switch (result.state) {
+      case DriveStartupResult::State::Succeeded:
+        MELO_INFO_STREAM("[elmo_ethercat_sdk:StartupOrchestrator] '" << result.name << "': successful ("
+                                                                     << result.duration.count() << " ms)");
+        break;
+      case DriveStartupResult::State::Failed:
+        MELO_ERROR_STREAM("[elmo_ethercat_sdk:StartupOrchestrator] '" << result.name << "': failed ("
+                                                                      << result.duration.count() << " ms, "
+                                                                      << result.errors.size() << " error(s))");
+        break;
+      default:
+        MELO_WARN_STREAM("[elmo_ethercat_sdk:StartupOrchestrator] '" << result.name << "': not started");
+    }
+  }
+}
+
+}  // namespace elmo
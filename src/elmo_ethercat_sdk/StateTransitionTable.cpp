@@ -0,0 +1,76 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/StateTransitionTable.hpp"
+
+namespace elmo {
+
+namespace {
+
+// every transition of the table leads to the target state
+constexpr bool isConsistent() {
+  for (uint8_t target = 0; target <= static_cast<uint8_t>(DriveState::NA); target++) {
+    for (uint8_t current = 0; current <= static_cast<uint8_t>(DriveState::NA); current++) {
+      const DriveState targetDriveState = static_cast<DriveState>(target);
+      const DriveState currentDriveState = static_cast<DriveState>(current);
+      const StateTransitionStep step = StateTransitionTable::getNextStep(currentDriveState, targetDriveState);
+      const bool reached = target == current && targetDriveState != DriveState::NA;
+      if ((step.type == StateTransitionStep::Type::Reached) != reached) {
+        return false;
+      }
+      if (step.type == StateTransitionStep::Type::Transition &&
+          (!StateTransitionTable::getSequence(currentDriveState, targetDriveState).valid ||
+           step.controlword != StateTransitionTable::getControlword(step.transition))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static_assert(isConsistent(), "The state transition table does not lead to the target states");
+static_assert(StateTransitionTable::getSequence(DriveState::Fault, DriveState::QuickStopActive).size ==
+                  StateTransitionSequence::maxSize,
+              "The longest state transition sequence does not fit");
+
+}  // namespace
+
+constexpr std::size_t StateTransitionSequence::maxSize;
+constexpr std::size_t StateTransitionTable::numberOfDriveStates_;
+constexpr std::size_t StateTransitionTable::numberOfStateTransitions_;
+constexpr uint16_t StateTransitionTable::controlwords_[];
+constexpr DriveState StateTransitionTable::resultingDriveStates_[];
+constexpr StateTransitionStep StateTransitionTable::reached_;
+constexpr StateTransitionStep StateTransitionTable::unreachable_;
+constexpr StateTransitionStep StateTransitionTable::t2_;
+constexpr StateTransitionStep StateTransitionTable::t3_;
+constexpr StateTransitionStep StateTransitionTable::t4_;
+constexpr StateTransitionStep StateTransitionTable::t5_;
+constexpr StateTransitionStep StateTransitionTable::t6_;
+constexpr StateTransitionStep StateTransitionTable::t7_;
+constexpr StateTransitionStep StateTransitionTable::t8_;
+constexpr StateTransitionStep StateTransitionTable::t9_;
+constexpr StateTransitionStep StateTransitionTable::t10_;
+constexpr StateTransitionStep StateTransitionTable::t11_;
+constexpr StateTransitionStep StateTransitionTable::t12_;
+constexpr StateTransitionStep StateTransitionTable::t15_;
+constexpr StateTransitionStep StateTransitionTable::steps_[][StateTransitionTable::numberOfDriveStates_];
+
+}  // namespace elmo
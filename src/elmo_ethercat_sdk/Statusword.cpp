@@ -22,6 +22,27 @@
 
 namespace elmo {
 
+constexpr std::size_t DriveStateTable::size;
+constexpr uint16_t DriveStateTable::mask;
+constexpr DriveStateTable Statusword::driveStateTable_;
+
+namespace {
+
+// the table lookup gives the same drive state for every statusword
+constexpr bool driveStateTableMatches() {
+  for (uint32_t rawStatusword = 0; rawStatusword <= 0xffff; rawStatusword++) {
+    if (Statusword(static_cast<uint16_t>(rawStatusword)).getDriveState() !=
+        decodeDriveState(static_cast<uint16_t>(rawStatusword))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(driveStateTableMatches(), "The drive state table does not match decodeDriveState");
+
+}  // namespace
+
 std::ostream& operator<<(std::ostream& os, const Statusword& statusword) {
   using std::setfill;
   using std::setw;
@@ -43,28 +64,28 @@ std::ostream& operator<<(std::ostream& os, const Statusword& statusword) {
      << setfill(' ') <<
 
       setw(25) << "| Ready to switch on:"
-     << "| " << setw(gapSize2) << statusword.readyToSwitchOn_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getReadyToSwitchOn() << "|\n"
      << setw(25) << "| Switched on:"
-     << "| " << setw(gapSize2) << statusword.switchedOn_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getSwitchedOn() << "|\n"
      << setw(25) << "| Operation enabled:"
-     << "| " << setw(gapSize2) << statusword.operationEnabled_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getOperationEnabled() << "|\n"
      << setw(25) << "| Fault:"
-     << "| " << setw(gapSize2) << statusword.fault_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getFault() << "|\n"
      << setw(25) << "| Voltage enabled:"
-     << "| " << setw(gapSize2) << statusword.voltageEnabled_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getVoltageEnabled() << "|\n"
      << setw(25) << "| Quick stop:"
-     << "| " << setw(gapSize2) << statusword.quickStop_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getQuickStop() << "|\n"
      << setw(25) << "| Switch on disabled:"
-     << "| " << setw(gapSize2) << statusword.switchOnDisabled_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getSwitchOnDisabled() << "|\n"
      << setw(25) << "| Warning:"
-     << "| " << setw(gapSize2) << statusword.warning_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getWarning() << "|\n"
      << setw(25) << "| Target reached:"
-     << "| " << setw(gapSize2) << statusword.targetReached_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getTargetReached() << "|\n"
      << setw(25) << "| Internal limit active:"
-     << "| " << setw(gapSize2) << statusword.internalLimitActive_ << "|\n"
+     << "| " << setw(gapSize2) << statusword.getInternalLimitActive() << "|\n"
      <<
       // setw(25)<<"| Following error:"<<"|
-      // "<<setw(gapSize2)<<statusword.followingError_<<"| \n"<< // mode of
+      // "<<setw(gapSize2)<<statusword.getFollowingError()<<"| \n"<< // mode of
       // operation specific
       setw(25) << setfill('-') << "|" << setw(gapSize2 + 2) << "+"
      << "|\n"
@@ -78,46 +99,6 @@ std::ostream& operator<<(std::ostream& os, const Statusword& statusword) {
   return os;
 }
 
-void Statusword::setFromRawStatusword(uint16_t status) {
-  readyToSwitchOn_ = static_cast<bool>(status & 1 << (0));
-  switchedOn_ = static_cast<bool>(status & 1 << (1));
-  operationEnabled_ = static_cast<bool>(status & 1 << (2));
-  fault_ = static_cast<bool>(status & 1 << (3));
-  voltageEnabled_ = static_cast<bool>(status & 1 << (4));
-  quickStop_ = static_cast<bool>(status & 1 << (5));
-  switchOnDisabled_ = static_cast<bool>(status & 1 << (6));
-  warning_ = static_cast<bool>(status & 1 << (7));
-  targetReached_ = static_cast<bool>(status & 1 << (10));
-  internalLimitActive_ = static_cast<bool>(status & 1 << (11));
-  followingError_ = static_cast<bool>(status & 1 << (13));
-
-  rawStatusword_ = status;
-}
-
-DriveState Statusword::getDriveState() const {
-  DriveState driveState = DriveState::NA;
-
-  // MAN-G-DS402 manual page 47
-  if ((rawStatusword_ & 0b0000000001001111) == 0b0000000000000000) {
-    driveState = DriveState::NotReadyToSwitchOn;
-  } else if ((rawStatusword_ & 0b0000000001001111) == 0b0000000001000000) {
-    driveState = DriveState::SwitchOnDisabled;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b0000000000100001) {
-    driveState = DriveState::ReadyToSwitchOn;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b0000000000100011) {
-    driveState = DriveState::SwitchedOn;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b0000000000100111) {
-    driveState = DriveState::OperationEnabled;
-  } else if ((rawStatusword_ & 0b0000000001101111) == 0b0000000000000111) {
-    driveState = DriveState::QuickStopActive;
-  } else if ((rawStatusword_ & 0b0000000001001111) == 0b0000000000001111) {
-    driveState = DriveState::FaultReactionActive;
-  } else if ((rawStatusword_ & 0b0000000001001111) == 0b0000000000001000) {
-    driveState = DriveState::Fault;
-  }
-
-  return driveState;
-}
 std::string Statusword::getDriveStateString() const {
   DriveState driveState = getDriveState();
   switch (driveState) {
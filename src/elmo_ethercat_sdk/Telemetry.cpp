@@ -0,0 +1,337 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/Telemetry.hpp"
+
+#include <message_logger/message_logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace elmo {
+
+constexpr char TelemetryFile::magic[];
+constexpr uint32_t TelemetryFile::currentVersion;
+constexpr uint8_t TelemetryFile::channelChunk;
+constexpr uint8_t TelemetryFile::blockChunk;
+
+namespace {
+
+// [bytes] of the fields of a block chunk before the columns
+constexpr std::size_t blockHeaderSize{1 + 2 + 4 + 8 + 4};
+
+template <typename Value>
+void putValue(std::vector<uint8_t>& buffer, Value value) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(Value));
+}
+
+template <typename Value>
+bool getValue(const uint8_t*& data, const uint8_t* end, Value& value) {
+  if (static_cast<std::size_t>(end - data) < sizeof(Value)) {
+    return false;
+  }
+  std::memcpy(&value, data, sizeof(Value));
+  data += sizeof(Value);
+  return true;
+}
+
+template <typename Value>
+void encodeColumn(std::vector<uint8_t>& buffer, const std::vector<Value>& column) {
+  int64_t previousValue = 0;
+  for (const Value value : column) {
+    const int64_t difference = static_cast<int64_t>(value) - previousValue;
+    previousValue = static_cast<int64_t>(value);
+    // zigzag: small differences of both signs become small numbers
+    uint64_t encoded = (static_cast<uint64_t>(difference) << 1) ^ static_cast<uint64_t>(difference >> 63);
+    // varint: 7 bits per byte, the high bit is set on all but the last byte
+    while (encoded >= 0x80) {
+      buffer.push_back(static_cast<uint8_t>(encoded | 0x80));
+      encoded >>= 7;
+    }
+    buffer.push_back(static_cast<uint8_t>(encoded));
+  }
+}
+
+template <typename Value>
+bool decodeColumn(const uint8_t*& data, const uint8_t* end, std::size_t numberOfValues, std::vector<Value>& column) {
+  int64_t previousValue = 0;
+  for (std::size_t i = 0; i < numberOfValues; i++) {
+    uint64_t encoded = 0;
+    for (unsigned int shift = 0;; shift += 7) {
+      if (data == end || shift > 63) {
+        return false;
+      }
+      const uint8_t byte = *data++;
+      encoded |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        break;
+      }
+    }
+    const int64_t difference = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+    previousValue += difference;
+    column.push_back(static_cast<Value>(previousValue));
+  }
+  return true;
+}
+
+}  // namespace
+
+void TelemetryColumns::reserve(std::size_t size) {
+  timestamp.reserve(size);
+  actualPosition.reserve(size);
+  actualVelocity.reserve(size);
+  actualCurrent.reserve(size);
+  statusword.reserve(size);
+  busVoltage.reserve(size);
+}
+
+void TelemetryColumns::clear() {
+  timestamp.clear();
+  actualPosition.clear();
+  actualVelocity.clear();
+  actualCurrent.clear();
+  statusword.clear();
+  busVoltage.clear();
+}
+
+void TelemetryColumns::push_back(const TelemetrySample& sample) {
+  timestamp.push_back(sample.timestamp);
+  actualPosition.push_back(sample.actualPosition);
+  actualVelocity.push_back(sample.actualVelocity);
+  actualCurrent.push_back(sample.actualCurrent);
+  statusword.push_back(sample.statusword);
+  busVoltage.push_back(sample.busVoltage);
+}
+
+TelemetryStream::TelemetryStream(std::size_t queueCapacity, std::size_t blockSize)
+    : queueCapacity_(queueCapacity), blockSize_(blockSize > 0 ? blockSize : 1) {}
+
+TelemetryStream::~TelemetryStream() {
+  stop();
+}
+
+bool TelemetryStream::start(const std::string& fileName) {
+  if (worker_.joinable()) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:TelemetryStream::start] The stream is already writing.");
+    return false;
+  }
+  file_.open(fileName, std::ios::binary | std::ios::trunc);
+  if (!file_) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:TelemetryStream::start] Cannot create '" << fileName << "'.");
+    return false;
+  }
+  file_.write(TelemetryFile::magic, sizeof(TelemetryFile::magic));
+  const uint32_t version = TelemetryFile::currentVersion;
+  file_.write(reinterpret_cast<const char*>(&version), sizeof(version));
+
+  std::lock_guard<std::mutex> lock(channelsMutex_);
+  for (auto& channel : channels_) {
+    channel->isDescribed_ = false;
+  }
+  writeFailed_ = false;
+  running_ = true;
+  worker_ = std::thread(&TelemetryStream::work, this);
+  return true;
+}
+
+void TelemetryStream::stop() {
+  if (!worker_.joinable()) {
+    return;
+  }
+  running_ = false;
+  worker_.join();
+  file_.close();
+}
+
+TelemetryChannel* TelemetryStream::addChannel(const std::string& name) {
+  std::lock_guard<std::mutex> lock(channelsMutex_);
+  channels_.emplace_back(new TelemetryChannel(static_cast<uint16_t>(channels_.size()), name, queueCapacity_));
+  channels_.back()->columns_.reserve(blockSize_);
+  return channels_.back().get();
+}
+
+uint64_t TelemetryStream::getNumberOfDroppedSamples() const {
+  std::lock_guard<std::mutex> lock(channelsMutex_);
+  uint64_t numberOfDroppedSamples = 0;
+  for (const auto& channel : channels_) {
+    numberOfDroppedSamples += channel->getNumberOfDroppedSamples();
+  }
+  return numberOfDroppedSamples;
+}
+
+void TelemetryStream::work() {
+  while (true) {
+    // read the flag first to drain the queues once more after stopping
+    const bool running = running_;
+    drain(!running);
+    if (!running) {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
+void TelemetryStream::drain(bool flush) {
+  {
+    // the channels are never removed, the file is written without the lock such
+    // that addChannel is not blocked by the disk
+    std::lock_guard<std::mutex> lock(channelsMutex_);
+    for (std::size_t i = drainedChannels_.size(); i < channels_.size(); i++) {
+      drainedChannels_.push_back(channels_[i].get());
+    }
+  }
+  for (TelemetryChannel* channel : drainedChannels_) {
+    if (!channel->isDescribed_) {
+      writeChannel(*channel);
+    }
+    TelemetrySample sample;
+    while (channel->queue_.pop(sample)) {
+      channel->columns_.push_back(sample);
+      if (channel->columns_.size() >= blockSize_) {
+        writeBlock(*channel);
+      }
+    }
+    if (flush && (channel->columns_.size() > 0 ||
+                  channel->getNumberOfDroppedSamples() != channel->numberOfWrittenDroppedSamples_)) {
+      writeBlock(*channel);
+    }
+  }
+  file_.flush();
+  // the queues are still drained, such that the bus threads are not affected
+  if (!file_ && !writeFailed_) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:TelemetryStream::drain] Writing the telemetry failed.");
+    writeFailed_ = true;
+  }
+}
+
+void TelemetryStream::writeChannel(TelemetryChannel& channel) {
+  const std::size_t nameLength = std::min<std::size_t>(channel.name_.size(), UINT8_MAX);
+  buffer_.clear();
+  putValue(buffer_, TelemetryFile::channelChunk);
+  putValue(buffer_, channel.id_);
+  putValue(buffer_, static_cast<uint8_t>(nameLength));
+  buffer_.insert(buffer_.end(), channel.name_.begin(), channel.name_.begin() + nameLength);
+  file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+  channel.isDescribed_ = true;
+}
+
+void TelemetryStream::writeBlock(TelemetryChannel& channel) {
+  const TelemetryColumns& columns = channel.columns_;
+  const uint64_t numberOfDroppedSamples = channel.getNumberOfDroppedSamples();
+
+  buffer_.clear();
+  putValue(buffer_, TelemetryFile::blockChunk);
+  putValue(buffer_, channel.id_);
+  putValue(buffer_, static_cast<uint32_t>(columns.size()));
+  putValue(buffer_, numberOfDroppedSamples - channel.numberOfWrittenDroppedSamples_);
+  // size of the columns, set below
+  putValue(buffer_, uint32_t{0});
+  encodeColumn(buffer_, columns.timestamp);
+  encodeColumn(buffer_, columns.actualPosition);
+  encodeColumn(buffer_, columns.actualVelocity);
+  encodeColumn(buffer_, columns.actualCurrent);
+  encodeColumn(buffer_, columns.statusword);
+  encodeColumn(buffer_, columns.busVoltage);
+  const auto columnsSize = static_cast<uint32_t>(buffer_.size() - blockHeaderSize);
+  std::memcpy(&buffer_[blockHeaderSize - sizeof(columnsSize)], &columnsSize, sizeof(columnsSize));
+  file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size()));
+
+  numberOfWrittenSamples_.fetch_add(columns.size(), std::memory_order_relaxed);
+  channel.numberOfWrittenDroppedSamples_ = numberOfDroppedSamples;
+  channel.columns_.clear();
+}
+
+bool TelemetryReader::open(const std::string& fileName) {
+  channels_.clear();
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:TelemetryReader::open] Cannot open '" << fileName << "'.");
+    return false;
+  }
+  const std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  const uint8_t* data = content.data();
+  const uint8_t* end = content.data() + content.size();
+
+  uint32_t version = 0;
+  const bool hasMagic = content.size() >= sizeof(TelemetryFile::magic) &&
+                        std::memcmp(data, TelemetryFile::magic, sizeof(TelemetryFile::magic)) == 0;
+  if (hasMagic) {
+    data += sizeof(TelemetryFile::magic);
+  }
+  if (!hasMagic || !getValue(data, end, version) || version != TelemetryFile::currentVersion) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:TelemetryReader::open] '" << fileName
+                      << "' is not a telemetry file of version " << TelemetryFile::currentVersion << ".");
+    return false;
+  }
+
+  uint8_t type;
+  uint16_t id;
+  while (getValue(data, end, type) && getValue(data, end, id)) {
+    if (id >= channels_.size()) {
+      channels_.resize(id + 1u);
+    }
+    Channel& channel = channels_[id];
+
+    if (type == TelemetryFile::channelChunk) {
+      uint8_t nameLength;
+      if (!getValue(data, end, nameLength) || static_cast<std::size_t>(end - data) < nameLength) {
+        break;
+      }
+      channel.name.assign(reinterpret_cast<const char*>(data), nameLength);
+      data += nameLength;
+      continue;
+    }
+
+    uint32_t numberOfSamples;
+    uint64_t numberOfDroppedSamples;
+    uint32_t columnsSize;
+    if (type != TelemetryFile::blockChunk || !getValue(data, end, numberOfSamples) ||
+        !getValue(data, end, numberOfDroppedSamples) || !getValue(data, end, columnsSize) ||
+        static_cast<std::size_t>(end - data) < columnsSize) {
+      break;
+    }
+    const uint8_t* columnsEnd = data + columnsSize;
+    TelemetryColumns columns;
+    if (!decodeColumn(data, columnsEnd, numberOfSamples, columns.timestamp) ||
+        !decodeColumn(data, columnsEnd, numberOfSamples, columns.actualPosition) ||
+        !decodeColumn(data, columnsEnd, numberOfSamples, columns.actualVelocity) ||
+        !decodeColumn(data, columnsEnd, numberOfSamples, columns.actualCurrent) ||
+        !decodeColumn(data, columnsEnd, numberOfSamples, columns.statusword) ||
+        !decodeColumn(data, columnsEnd, numberOfSamples, columns.busVoltage)) {
+      MELO_WARN_STREAM("[elmo_ethercat_sdk:TelemetryReader::open] A block of '" << fileName
+                       << "' is corrupted, the rest of the file is skipped.");
+      break;
+    }
+    data = columnsEnd;
+    auto append = [](auto& target, const auto& source) { target.insert(target.end(), source.begin(), source.end()); };
+    append(channel.columns.timestamp, columns.timestamp);
+    append(channel.columns.actualPosition, columns.actualPosition);
+    append(channel.columns.actualVelocity, columns.actualVelocity);
+    append(channel.columns.actualCurrent, columns.actualCurrent);
+    append(channel.columns.statusword, columns.statusword);
+    append(channel.columns.busVoltage, columns.busVoltage);
+    channel.numberOfDroppedSamples += numberOfDroppedSamples;
+  }
+  return true;
+}
+
+}  // namespace elmo
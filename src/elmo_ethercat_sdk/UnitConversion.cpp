@@ -0,0 +1,207 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ELMO_ETHERCAT_SDK_HAS_AVX2_KERNEL
+#include <immintrin.h>
+#endif
+
+#include "elmo_ethercat_sdk/UnitConversion.hpp"
+
+namespace elmo {
+
+namespace {
+
+/*!
+ * Scalar kernels, these define the reference results.
+ */
+template <typename T>
+void convertFromRawScalar(const T* raw, const double* factors, double* values, std::size_t begin, std::size_t end) {
+  for (std::size_t i = begin; i < end; i++) {
+    values[i] = static_cast<double>(raw[i]) * factors[i];
+  }
+}
+
+template <typename T>
+void convertToRawScalar(const double* values, const double* factors, T* raw, std::size_t begin, std::size_t end) {
+  for (std::size_t i = begin; i < end; i++) {
+    raw[i] = saturatingCast<T>(factors[i] * values[i]);
+  }
+}
+
+#ifdef ELMO_ETHERCAT_SDK_HAS_AVX2_KERNEL
+/*!
+ * AVX2 kernels, four elements per iteration. The remainder is handled by the
+ * scalar kernels.
+ * The conversions int32 -> double and the multiplication are exact / IEEE
+ * rounded in both kernels. For the conversion to integers, NaN is mapped to 0
+ * and the value is clamped to the (exactly representable) limits of the target
+ * type before the truncating conversion, which equals saturatingCast.
+ */
+__attribute__((target("avx2"))) inline __m256d clampedProduct(const double* values, const double* factors,
+                                                              __m256d lower, __m256d upper) {
+  __m256d product = _mm256_mul_pd(_mm256_loadu_pd(factors), _mm256_loadu_pd(values));
+  product = _mm256_and_pd(product, _mm256_cmp_pd(product, product, _CMP_ORD_Q));
+  return _mm256_min_pd(_mm256_max_pd(product, lower), upper);
+}
+
+__attribute__((target("avx2"))) void convertFromRawAvx2(const int32_t* raw, const double* factors, double* values,
+                                                        std::size_t size) {
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m256d converted = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i)));
+    _mm256_storeu_pd(values + i, _mm256_mul_pd(converted, _mm256_loadu_pd(factors + i)));
+  }
+  convertFromRawScalar(raw, factors, values, i, size);
+}
+
+__attribute__((target("avx2"))) void convertFromRawAvx2(const int16_t* raw, const double* factors, double* values,
+                                                        std::size_t size) {
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m128i widened = _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(raw + i)));
+    _mm256_storeu_pd(values + i, _mm256_mul_pd(_mm256_cvtepi32_pd(widened), _mm256_loadu_pd(factors + i)));
+  }
+  convertFromRawScalar(raw, factors, values, i, size);
+}
+
+__attribute__((target("avx2"))) void convertToRawAvx2(const double* values, const double* factors, int32_t* raw,
+                                                      std::size_t size) {
+  const __m256d lower = _mm256_set1_pd(static_cast<double>(std::numeric_limits<int32_t>::min()));
+  const __m256d upper = _mm256_set1_pd(static_cast<double>(std::numeric_limits<int32_t>::max()));
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m128i converted = _mm256_cvttpd_epi32(clampedProduct(values + i, factors + i, lower, upper));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(raw + i), converted);
+  }
+  convertToRawScalar(values, factors, raw, i, size);
+}
+
+__attribute__((target("avx2"))) void convertToRawAvx2(const double* values, const double* factors, int16_t* raw,
+                                                      std::size_t size) {
+  const __m256d lower = _mm256_set1_pd(static_cast<double>(std::numeric_limits<int16_t>::min()));
+  const __m256d upper = _mm256_set1_pd(static_cast<double>(std::numeric_limits<int16_t>::max()));
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m128i converted = _mm256_cvttpd_epi32(clampedProduct(values + i, factors + i, lower, upper));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(raw + i), _mm_packs_epi32(converted, converted));
+  }
+  convertToRawScalar(values, factors, raw, i, size);
+}
+
+__attribute__((target("avx2"))) void convertToRawAvx2(const double* values, const double* factors, uint16_t* raw,
+                                                      std::size_t size) {
+  const __m256d lower = _mm256_set1_pd(static_cast<double>(std::numeric_limits<uint16_t>::min()));
+  const __m256d upper = _mm256_set1_pd(static_cast<double>(std::numeric_limits<uint16_t>::max()));
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const __m128i converted = _mm256_cvttpd_epi32(clampedProduct(values + i, factors + i, lower, upper));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(raw + i), _mm_packus_epi32(converted, converted));
+  }
+  convertToRawScalar(values, factors, raw, i, size);
+}
+#endif
+
+ConversionKernel getFastestSupportedKernel() {
+  if (isConversionKernelSupported(ConversionKernel::Avx2)) {
+    return ConversionKernel::Avx2;
+  }
+  return ConversionKernel::Scalar;
+}
+
+std::atomic<ConversionKernel>& activeKernel() {
+  static std::atomic<ConversionKernel> kernel{getFastestSupportedKernel()};
+  return kernel;
+}
+
+bool useAvx2() {
+  return activeKernel().load(std::memory_order_relaxed) == ConversionKernel::Avx2;
+}
+
+}  // namespace
+
+bool isConversionKernelSupported(ConversionKernel kernel) {
+  switch (kernel) {
+    case ConversionKernel::Scalar:
+      return true;
+    case ConversionKernel::Avx2:
+#ifdef ELMO_ETHERCAT_SDK_HAS_AVX2_KERNEL
+      return __builtin_cpu_supports("avx2");
+#else
+      return false;
+#endif
+    default:
+      return false;
+  }
+}
+
+bool setConversionKernel(ConversionKernel kernel) {
+  if (!isConversionKernelSupported(kernel)) {
+    return false;
+  }
+  activeKernel().store(kernel, std::memory_order_relaxed);
+  return true;
+}
+
+ConversionKernel getConversionKernel() {
+  return activeKernel().load(std::memory_order_relaxed);
+}
+
+#ifdef ELMO_ETHERCAT_SDK_HAS_AVX2_KERNEL
+#define ELMO_ETHERCAT_SDK_DISPATCH(avx2Call, scalarCall) \
+  if (useAvx2()) {                                       \
+    avx2Call;                                            \
+  } else {                                               \
+    scalarCall;                                          \
+  }
+#else
+#define ELMO_ETHERCAT_SDK_DISPATCH(avx2Call, scalarCall) scalarCall;
+#endif
+
+void convertFromRaw(const int32_t* raw, const double* factors, double* values, std::size_t size) {
+  ELMO_ETHERCAT_SDK_DISPATCH(convertFromRawAvx2(raw, factors, values, size),
+                             convertFromRawScalar(raw, factors, values, 0, size))
+}
+
+void convertFromRaw(const int16_t* raw, const double* factors, double* values, std::size_t size) {
+  ELMO_ETHERCAT_SDK_DISPATCH(convertFromRawAvx2(raw, factors, values, size),
+                             convertFromRawScalar(raw, factors, values, 0, size))
+}
+
+void convertToRaw(const double* values, const double* factors, int32_t* raw, std::size_t size) {
+  ELMO_ETHERCAT_SDK_DISPATCH(convertToRawAvx2(values, factors, raw, size),
+                             convertToRawScalar(values, factors, raw, 0, size))
+}
+
+void convertToRaw(const double* values, const double* factors, int16_t* raw, std::size_t size) {
+  ELMO_ETHERCAT_SDK_DISPATCH(convertToRawAvx2(values, factors, raw, size),
+                             convertToRawScalar(values, factors, raw, 0, size))
+}
+
+void convertToRaw(const double* values, const double* factors, uint16_t* raw, std::size_t size) {
+  ELMO_ETHERCAT_SDK_DISPATCH(convertToRawAvx2(values, factors, raw, size),
+                             convertToRawScalar(values, factors, raw, 0, size))
+}
+
+#undef ELMO_ETHERCAT_SDK_DISPATCH
+
+}  // namespace elmo
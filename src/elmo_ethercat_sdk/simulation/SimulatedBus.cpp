@@ -0,0 +1,86 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/simulation/SimulatedBus.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedElmo.hpp"
+
+#include <stdexcept>
+
+namespace elmo {
+
+SimulatedBus::SimulatedBus(uint16_t numberOfDrives, const SimulatedDriveParameters& parameters,
+                           const std::string& name)
+    : soem_interface::EthercatBusBase(name),
+      outputs_(static_cast<std::size_t>(numberOfDrives) * SimulatedDrive::maxPdoSize, 0),
+      inputs_(static_cast<std::size_t>(numberOfDrives) * SimulatedDrive::maxPdoSize, 0) {
+  if (numberOfDrives >= EC_MAXSLAVE) {
+    throw std::invalid_argument("[elmo_ethercat_sdk:SimulatedBus::SimulatedBus] too many drives");
+  }
+  ecatSlavecount_ = numberOfDrives;
+  for (uint16_t address = 1; address <= numberOfDrives; address++) {
+    slaves_.emplace_back(new Slave(*this, address, parameters));
+    // the master brings the slaves to PRE_OP before the startup of the devices
+    slaves_.back()->setEthercatState(EC_STATE_PRE_OP);
+    ecatSlavelist_[address].outputs = getOutputs(address);
+    ecatSlavelist_[address].inputs = &inputs_[(address - 1) * SimulatedDrive::maxPdoSize];
+    updatePdoSizes(address);
+  }
+}
+
+bool SimulatedBus::attach(SimulatedElmo& elmo) {
+  const uint32_t address = elmo.getAddress();
+  if (address == 0 || address > slaves_.size()) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:SimulatedBus::attach] There is no simulated drive at address "
+                      << address << " for '" << elmo.getName() << "'");
+    return false;
+  }
+  elmo.setEthercatBusBasePointer(this);
+  elmo.setSimulatedDevice(slaves_[address - 1].get());
+  return true;
+}
+
+void SimulatedBus::setAllStates(uint16_t state) {
+  for (auto& slave : slaves_) {
+    slave->setEthercatState(state);
+  }
+}
+
+void SimulatedBus::update(double timeStep) {
+  for (uint16_t address = 1; address <= slaves_.size(); address++) {
+    slaves_[address - 1]->getDrive().update(ecatSlavelist_[address].outputs, ecatSlavelist_[address].inputs,
+                                            timeStep);
+  }
+}
+
+void SimulatedBus::updatePdoSizes(uint16_t address) {
+  SimulatedDrive& drive = getDrive(address);
+  ecatSlavelist_[address].Obytes = drive.getRxPdoSize();
+  ecatSlavelist_[address].Ibytes = drive.getTxPdoSize();
+}
+
+bool SimulatedBus::Slave::sdoWrite(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                                   std::size_t size) {
+  const bool success = drive_.sdoWrite(index, subindex, completeAccess, data, size);
+  // the sizes are read by Elmo::autoConfigurePdoSizes after the mapping
+  bus_.updatePdoSizes(address_);
+  return success;
+}
+
+}  // namespace elmo
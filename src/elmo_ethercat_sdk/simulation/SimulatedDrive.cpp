@@ -0,0 +1,684 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _USE_MATH_DEFINES  // for M_PI
+#include <cmath>
+
+#include "elmo_ethercat_sdk/simulation/SimulatedDrive.hpp"
+#include "elmo_ethercat_sdk/ModeOfOperationEnum.hpp"
+#include "elmo_ethercat_sdk/ObjectDictionary.hpp"
+#include "elmo_ethercat_sdk/PdoCodec.hpp"
+#include "elmo_ethercat_sdk/Statusword.hpp"
+#include "elmo_ethercat_sdk/UnitConversion.hpp"
+
+#include <soem_interface/EthercatBusBase.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace elmo {
+
+namespace {
+
+// ordered like DriveState, with the voltage enabled bit while the power stage is on
+constexpr uint16_t statuswords[] = {
+    0x0000,  // NotReadyToSwitchOn
+    0x0040,  // SwitchOnDisabled
+    0x0031,  // ReadyToSwitchOn
+    0x0033,  // SwitchedOn
+    0x0037,  // OperationEnabled
+    0x0017,  // QuickStopActive
+    0x001f,  // FaultReactionActive
+    0x0018,  // Fault
+    0x0000   // NA
+};
+
+constexpr bool statuswordsMatch() {
+  for (uint8_t driveState = 0; driveState < static_cast<uint8_t>(DriveState::NA); driveState++) {
+    if (decodeDriveState(statuswords[driveState]) != static_cast<DriveState>(driveState)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(statuswordsMatch(), "The statuswords of the simulated drive do not match their drive states");
+
+// mapping objects of the PDO types of PdoAssignment.cpp, see RxPdo.hpp / TxPdo.hpp
+struct FixedMapping {
+  uint16_t index;
+  std::vector<PdoEntry> entries;
+};
+
+const FixedMapping fixedMappings[] = {
+    {0x1605,
+     {PdoEntry::TargetPosition, PdoEntry::TargetVelocity, PdoEntry::TargetTorque, PdoEntry::MaxTorque,
+      PdoEntry::Controlword, PdoEntry::ModeOfOperation, PdoEntry::Padding}},
+    {0x1618, {PdoEntry::TorqueOffset}},
+    {0x1602, {PdoEntry::TargetTorque, PdoEntry::Controlword}},
+    {0x160b, {PdoEntry::ModeOfOperation, PdoEntry::Padding}},
+    {0x1a03, {PdoEntry::ActualPosition, PdoEntry::DigitalInputs, PdoEntry::ActualVelocity, PdoEntry::Statusword}},
+    {0x1a1d, {PdoEntry::AnalogInput}},
+    {0x1a1f, {PdoEntry::ActualCurrent}},
+    {0x1a18, {PdoEntry::BusVoltage}},
+    {0x1a02,
+     {PdoEntry::ActualPosition, PdoEntry::ActualTorque, PdoEntry::Statusword, PdoEntry::ModeOfOperationDisplay,
+      PdoEntry::Padding}},
+    {0x1a11, {PdoEntry::ActualVelocity}},
+};
+
+uint32_t getMappingEntry(PdoEntry entry) {
+  const auto& description = PdoLayout::getEntryDescription(entry);
+  return static_cast<uint32_t>(description.index) << 16 | static_cast<uint32_t>(description.subindex) << 8 |
+         static_cast<uint32_t>(description.size) * 8;
+}
+
+// reverse lookup of a subindex of a custom mapping object
+bool getEntryFromMappingEntry(uint32_t mappingEntry, PdoEntry& entry) {
+  for (uint8_t i = 0; i <= static_cast<uint8_t>(PdoEntry::ModeOfOperationDisplay); i++) {
+    if (getMappingEntry(static_cast<PdoEntry>(i)) == mappingEntry) {
+      entry = static_cast<PdoEntry>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+constexpr std::size_t SimulatedDrive::maxPdoSize;
+
+SimulatedDrive::SimulatedDrive(const SimulatedDriveParameters& parameters)
+    : parameters_(parameters), motorRatedCurrent_(parameters.motorRatedCurrent),
+      motorRatedTorque_(parameters.motorRatedCurrent) {}
+
+template <typename Value>
+bool SimulatedDrive::readValue(const Value& value, uint8_t* data, std::size_t size) const {
+  if (size != sizeof(Value)) {
+    return false;
+  }
+  std::memcpy(data, &value, sizeof(Value));
+  return true;
+}
+
+template <typename Value>
+bool SimulatedDrive::writeValue(Value& value, const uint8_t* data, std::size_t size) const {
+  if (size != sizeof(Value)) {
+    return false;
+  }
+  std::memcpy(&value, data, sizeof(Value));
+  return true;
+}
+
+bool SimulatedDrive::sdoRead(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data,
+                             std::size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ethercatState_ == EC_STATE_INIT) {
+    // no mailbox in INIT
+    return false;
+  }
+  switch (index) {
+    case OD_INDEX_RX_PDO_ASSIGNMENT:
+      return readPdoObject(rxPdoAssignment_, true, subindex, completeAccess, data, size);
+    case OD_INDEX_TX_PDO_ASSIGNMENT:
+      return readPdoObject(txPdoAssignment_, true, subindex, completeAccess, data, size);
+    case OD_INDEX_RX_PDO_MAPPING_CUSTOM:
+      return readPdoObject(rxPdoMapping_, false, subindex, completeAccess, data, size);
+    case OD_INDEX_TX_PDO_MAPPING_CUSTOM:
+      return readPdoObject(txPdoMapping_, false, subindex, completeAccess, data, size);
+    default:
+      break;
+  }
+  std::vector<PdoEntry> fixedMapping;
+  if (getFixedMapping(index, fixedMapping)) {
+    PdoObject pdoObject;
+    pdoObject.numberOfEntries = static_cast<uint8_t>(fixedMapping.size());
+    for (const auto entry : fixedMapping) {
+      pdoObject.entries.push_back(getMappingEntry(entry));
+    }
+    return readPdoObject(pdoObject, false, subindex, completeAccess, data, size);
+  }
+
+  if (completeAccess || subindex != 0) {
+    return false;
+  }
+  switch (index) {
+    case OD_INDEX_CONTROLWORD:
+      return readValue(controlword_, data, size);
+    case OD_INDEX_STATUSWORD:
+      return readValue(getStatusword(), data, size);
+    case OD_INDEX_MODES_OF_OPERATION:
+    case OD_INDEX_MODES_OF_OPERATION_DISPLAY:
+      return readValue(modeOfOperation_, data, size);
+    case OD_INDEX_MAX_CURRENT:
+      return readValue(maxCurrent_, data, size);
+    case OD_INDEX_MOTOR_RATED_CURRENT:
+      return readValue(motorRatedCurrent_, data, size);
+    case OD_INDEX_MOTOR_RATED_TORQUE:
+      return readValue(motorRatedTorque_, data, size);
+    case OD_INDEX_DC_LINK_VOLTAGE:
+      return readValue(parameters_.busVoltage, data, size);
+    case OD_INDEX_5VDC_SUPPLY:
+      return readValue(parameters_.supplyVoltage5v, data, size);
+    default:
+      return false;
+  }
+}
+
+bool SimulatedDrive::sdoWrite(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                              std::size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ethercatState_ == EC_STATE_INIT) {
+    return false;
+  }
+  switch (index) {
+    case OD_INDEX_RX_PDO_ASSIGNMENT:
+    case OD_INDEX_TX_PDO_ASSIGNMENT:
+    case OD_INDEX_RX_PDO_MAPPING_CUSTOM:
+    case OD_INDEX_TX_PDO_MAPPING_CUSTOM:
+      // the PDOs can only be changed in PRE_OP
+      if (ethercatState_ != EC_STATE_PRE_OP) {
+        return false;
+      }
+      break;
+    default:
+      break;
+  }
+  switch (index) {
+    case OD_INDEX_RX_PDO_ASSIGNMENT:
+      return writePdoObject(rxPdoAssignment_, index, subindex, completeAccess, data, size);
+    case OD_INDEX_TX_PDO_ASSIGNMENT:
+      return writePdoObject(txPdoAssignment_, index, subindex, completeAccess, data, size);
+    case OD_INDEX_RX_PDO_MAPPING_CUSTOM:
+      return writePdoObject(rxPdoMapping_, index, subindex, completeAccess, data, size);
+    case OD_INDEX_TX_PDO_MAPPING_CUSTOM:
+      return writePdoObject(txPdoMapping_, index, subindex, completeAccess, data, size);
+    default:
+      break;
+  }
+
+  if (completeAccess || subindex != 0) {
+    return false;
+  }
+  switch (index) {
+    case OD_INDEX_CONTROLWORD: {
+      uint16_t controlword = 0;
+      if (!writeValue(controlword, data, size)) {
+        return false;
+      }
+      // the mailbox is slow compared to the state machine of the drive
+      applyControlword(controlword, true);
+      return true;
+    }
+    case OD_INDEX_MODES_OF_OPERATION:
+      return writeValue(modeOfOperation_, data, size);
+    case OD_INDEX_MAX_CURRENT:
+      return writeValue(maxCurrent_, data, size);
+    case OD_INDEX_MOTOR_RATED_CURRENT:
+      return writeValue(motorRatedCurrent_, data, size);
+    case OD_INDEX_MOTOR_RATED_TORQUE:
+      return writeValue(motorRatedTorque_, data, size);
+    default:
+      return false;
+  }
+}
+
+void SimulatedDrive::setEthercatState(uint16_t state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ethercatState_ = state;
+  if (state != EC_STATE_SAFE_OP && state != EC_STATE_OPERATIONAL) {
+    // the power stage is switched off without process data
+    switch (driveState_) {
+      case DriveState::ReadyToSwitchOn:
+      case DriveState::SwitchedOn:
+      case DriveState::OperationEnabled:
+      case DriveState::QuickStopActive:
+        pendingDriveState_ = DriveState::NA;
+        driveState_ = DriveState::SwitchOnDisabled;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+uint16_t SimulatedDrive::getEthercatState() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ethercatState_;
+}
+
+void SimulatedDrive::update(const uint8_t* rxPdo, uint8_t* txPdo, double timeStep) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ethercatState_ != EC_STATE_SAFE_OP && ethercatState_ != EC_STATE_OPERATIONAL) {
+    return;
+  }
+  if (ethercatState_ == EC_STATE_OPERATIONAL) {
+    decodeRxPdo(rxPdo);
+  }
+  if (faultTriggered_) {
+    faultTriggered_ = false;
+    driveState_ = DriveState::FaultReactionActive;
+    pendingDriveState_ = DriveState::Fault;
+    pendingCycles_ = std::max(parameters_.stateTransitionDelay, 1u);
+  }
+  if (pendingDriveState_ != DriveState::NA) {
+    if (pendingCycles_ > 0) {
+      pendingCycles_--;
+    }
+    if (pendingCycles_ == 0) {
+      driveState_ = pendingDriveState_;
+      pendingDriveState_ = DriveState::NA;
+    }
+  }
+  stepMotorModel(timeStep);
+  encodeTxPdo(txPdo);
+}
+
+uint16_t SimulatedDrive::getRxPdoSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rxPdoLayout_.getSize();
+}
+
+uint16_t SimulatedDrive::getTxPdoSize() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return txPdoLayout_.getSize();
+}
+
+void SimulatedDrive::triggerFault() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  faultTriggered_ = true;
+}
+
+DriveState SimulatedDrive::getDriveState() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return driveState_;
+}
+
+double SimulatedDrive::getPosition() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return position_;
+}
+
+double SimulatedDrive::getVelocity() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return velocity_;
+}
+
+double SimulatedDrive::getTorque() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return torque_;
+}
+
+bool SimulatedDrive::readPdoObject(const PdoObject& pdoObject, bool isAssignment, uint8_t subindex,
+                                   bool completeAccess, uint8_t* data, std::size_t size) const {
+  if (completeAccess) {
+    // number of entries (uint8), padding (uint8), entries of 16 bit (assignment) or 32 bit (mapping)
+    if (subindex != 0 || pdoObject.numberOfEntries == 0) {
+      return false;
+    }
+    const std::size_t entrySize = isAssignment ? 2 : 4;
+    if (size != 2 + entrySize * pdoObject.numberOfEntries) {
+      return false;
+    }
+    std::memset(data, 0, size);
+    data[0] = pdoObject.numberOfEntries;
+    for (std::size_t i = 0; i < pdoObject.numberOfEntries; i++) {
+      if (isAssignment) {
+        storePdoValue(data + 2 + i * entrySize, static_cast<uint16_t>(pdoObject.entries[i]));
+      } else {
+        storePdoValue(data + 2 + i * entrySize, pdoObject.entries[i]);
+      }
+    }
+    return true;
+  }
+  if (subindex == 0) {
+    return readValue(pdoObject.numberOfEntries, data, size);
+  }
+  if (subindex > pdoObject.entries.size()) {
+    return false;
+  }
+  const uint32_t entry = pdoObject.entries[subindex - 1];
+  if (isAssignment) {
+    return readValue(static_cast<uint16_t>(entry), data, size);
+  }
+  return readValue(entry, data, size);
+}
+
+bool SimulatedDrive::writePdoObject(PdoObject& pdoObject, uint16_t index, uint8_t subindex, bool completeAccess,
+                                    const uint8_t* data, std::size_t size) {
+  const bool isAssignment = index == OD_INDEX_RX_PDO_ASSIGNMENT || index == OD_INDEX_TX_PDO_ASSIGNMENT;
+  const bool isRxPdo = index == OD_INDEX_RX_PDO_ASSIGNMENT || index == OD_INDEX_RX_PDO_MAPPING_CUSTOM;
+  if (completeAccess || subindex > PdoLayout::maxNumberOfEntries) {
+    return false;
+  }
+
+  if (subindex > 0) {
+    // the entries can only be changed while the object is disabled
+    if (pdoObject.numberOfEntries != 0) {
+      return false;
+    }
+    uint32_t entry = 0;
+    if (isAssignment) {
+      uint16_t mappingIndex = 0;
+      if (!writeValue(mappingIndex, data, size)) {
+        return false;
+      }
+      entry = mappingIndex;
+    } else if (!writeValue(entry, data, size)) {
+      return false;
+    }
+    if (pdoObject.entries.size() < subindex) {
+      pdoObject.entries.resize(subindex, 0);
+    }
+    pdoObject.entries[subindex - 1] = entry;
+    return true;
+  }
+
+  uint8_t numberOfEntries = 0;
+  if (!writeValue(numberOfEntries, data, size) || numberOfEntries > pdoObject.entries.size()) {
+    return false;
+  }
+  const uint8_t previousNumberOfEntries = pdoObject.numberOfEntries;
+  pdoObject.numberOfEntries = numberOfEntries;
+  if (isAssignment) {
+    if (!updatePdoLayout(isRxPdo, pdoObject)) {
+      pdoObject.numberOfEntries = previousNumberOfEntries;
+      return false;
+    }
+    return true;
+  }
+  // validate the mapping and update the layout if the mapping object is assigned
+  std::vector<PdoEntry> entries;
+  if (!getMapping(index, isRxPdo, entries) ||
+      !updatePdoLayout(isRxPdo, isRxPdo ? rxPdoAssignment_ : txPdoAssignment_)) {
+    pdoObject.numberOfEntries = previousNumberOfEntries;
+    return false;
+  }
+  return true;
+}
+
+bool SimulatedDrive::getFixedMapping(uint16_t mappingIndex, std::vector<PdoEntry>& entries) const {
+  for (const auto& fixedMapping : fixedMappings) {
+    if (fixedMapping.index == mappingIndex) {
+      entries = fixedMapping.entries;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SimulatedDrive::getMapping(uint16_t mappingIndex, bool isRxPdo, std::vector<PdoEntry>& entries) const {
+  if (mappingIndex == OD_INDEX_RX_PDO_MAPPING_CUSTOM || mappingIndex == OD_INDEX_TX_PDO_MAPPING_CUSTOM) {
+    if ((mappingIndex == OD_INDEX_RX_PDO_MAPPING_CUSTOM) != isRxPdo) {
+      return false;
+    }
+    const PdoObject& mapping = isRxPdo ? rxPdoMapping_ : txPdoMapping_;
+    entries.clear();
+    for (std::size_t i = 0; i < mapping.numberOfEntries; i++) {
+      PdoEntry entry;
+      if (!getEntryFromMappingEntry(mapping.entries[i], entry)) {
+        return false;
+      }
+      const auto& description = PdoLayout::getEntryDescription(entry);
+      if (isRxPdo ? !description.isRxPdoEntry : !description.isTxPdoEntry) {
+        return false;
+      }
+      entries.push_back(entry);
+    }
+    return true;
+  }
+  // the RxPdo mapping objects are 0x16xx, the TxPdo mapping objects 0x1Axx
+  if ((mappingIndex & 0xff00) != (isRxPdo ? 0x1600 : 0x1a00)) {
+    return false;
+  }
+  return getFixedMapping(mappingIndex, entries);
+}
+
+bool SimulatedDrive::updatePdoLayout(bool isRxPdo, const PdoObject& assignment) {
+  PdoLayout layout;
+  for (std::size_t i = 0; i < assignment.numberOfEntries; i++) {
+    std::vector<PdoEntry> entries;
+    if (!getMapping(static_cast<uint16_t>(assignment.entries[i]), isRxPdo, entries)) {
+      return false;
+    }
+    for (const auto entry : entries) {
+      layout.addEntry(entry);
+    }
+  }
+  if (layout.getSize() > maxPdoSize) {
+    return false;
+  }
+  (isRxPdo ? rxPdoLayout_ : txPdoLayout_) = layout;
+  return true;
+}
+
+void SimulatedDrive::applyControlword(uint16_t controlword, bool immediately) {
+  const uint16_t previousControlword = controlword_;
+  controlword_ = controlword;
+  if (pendingDriveState_ != DriveState::NA) {
+    // the drive is busy with the previous transition
+    return;
+  }
+
+  // commands of MAN-G-DS402, the fault reset bit is 0 for all but the fault reset
+  const bool faultReset = (controlword & 0x0080) != 0 && (previousControlword & 0x0080) == 0;
+  const bool disableVoltage = (controlword & 0x0082) == 0x0000;
+  const bool quickStop = (controlword & 0x0086) == 0x0002;
+  const bool shutdown = (controlword & 0x0087) == 0x0006;
+  const bool switchOn = (controlword & 0x008f) == 0x0007;
+  const bool enableOperation = (controlword & 0x008f) == 0x000f;
+
+  DriveState driveState = driveState_;
+  switch (driveState_) {
+    case DriveState::SwitchOnDisabled:
+      if (shutdown) {
+        driveState = DriveState::ReadyToSwitchOn;  // 2
+      }
+      break;
+    case DriveState::ReadyToSwitchOn:
+      if (disableVoltage || quickStop) {
+        driveState = DriveState::SwitchOnDisabled;  // 7
+      } else if (switchOn || enableOperation) {
+        driveState = DriveState::SwitchedOn;  // 3
+      }
+      break;
+    case DriveState::SwitchedOn:
+      if (disableVoltage || quickStop) {
+        driveState = DriveState::SwitchOnDisabled;  // 10
+      } else if (shutdown) {
+        driveState = DriveState::ReadyToSwitchOn;  // 6
+      } else if (enableOperation) {
+        driveState = DriveState::OperationEnabled;  // 4
+      }
+      break;
+    case DriveState::OperationEnabled:
+      if (disableVoltage) {
+        driveState = DriveState::SwitchOnDisabled;  // 9
+      } else if (quickStop) {
+        driveState = DriveState::QuickStopActive;  // 11
+      } else if (shutdown) {
+        driveState = DriveState::ReadyToSwitchOn;  // 8
+      } else if (switchOn) {
+        driveState = DriveState::SwitchedOn;  // 5
+      }
+      break;
+    case DriveState::QuickStopActive:
+      if (disableVoltage) {
+        driveState = DriveState::SwitchOnDisabled;  // 12
+      } else if (enableOperation) {
+        driveState = DriveState::OperationEnabled;  // 16
+      }
+      break;
+    case DriveState::Fault:
+      if (faultReset) {
+        driveState = DriveState::SwitchOnDisabled;  // 15
+      }
+      break;
+    default:
+      break;
+  }
+  if (driveState != driveState_) {
+    setDriveState(driveState, immediately);
+  }
+}
+
+void SimulatedDrive::setDriveState(DriveState driveState, bool immediately) {
+  if (immediately || parameters_.stateTransitionDelay == 0) {
+    driveState_ = driveState;
+    return;
+  }
+  pendingDriveState_ = driveState;
+  pendingCycles_ = parameters_.stateTransitionDelay;
+}
+
+uint16_t SimulatedDrive::getStatusword() const {
+  return statuswords[static_cast<std::size_t>(driveState_)];
+}
+
+void SimulatedDrive::decodeRxPdo(const uint8_t* rxPdo) {
+  for (const auto& mappedEntry : rxPdoLayout_.getEntries()) {
+    const uint8_t* data = rxPdo + mappedEntry.offset;
+    switch (mappedEntry.entry) {
+      case PdoEntry::TargetPosition:
+        targetPosition_ = loadPdoValue<int32_t>(data);
+        break;
+      case PdoEntry::TargetVelocity:
+        targetVelocity_ = loadPdoValue<int32_t>(data);
+        break;
+      case PdoEntry::TargetTorque:
+        targetTorque_ = loadPdoValue<int16_t>(data);
+        break;
+      case PdoEntry::MaxTorque:
+        maxTorque_ = loadPdoValue<uint16_t>(data);
+        break;
+      case PdoEntry::Controlword:
+        applyControlword(loadPdoValue<uint16_t>(data), false);
+        break;
+      case PdoEntry::ModeOfOperation:
+        modeOfOperation_ = loadPdoValue<int8_t>(data);
+        break;
+      case PdoEntry::TorqueOffset:
+        torqueOffset_ = loadPdoValue<int16_t>(data);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void SimulatedDrive::encodeTxPdo(uint8_t* txPdo) const {
+  const double radToTicks = static_cast<double>(parameters_.positionEncoderResolution) / (2.0 * M_PI);
+  const int16_t current = saturatingCast<int16_t>(torqueToCurrent(torque_));
+  for (const auto& mappedEntry : txPdoLayout_.getEntries()) {
+    uint8_t* data = txPdo + mappedEntry.offset;
+    switch (mappedEntry.entry) {
+      case PdoEntry::ActualPosition:
+        // the position counter wraps around
+        storePdoValue(data, static_cast<uint32_t>(static_cast<int64_t>(std::floor(radToTicks * position_))));
+        break;
+      case PdoEntry::DigitalInputs:
+        storePdoValue(data, static_cast<uint32_t>(0));
+        break;
+      case PdoEntry::ActualVelocity:
+        storePdoValue(data, saturatingCast<int32_t>(radToTicks * velocity_));
+        break;
+      case PdoEntry::Statusword:
+        storePdoValue(data, getStatusword());
+        break;
+      case PdoEntry::AnalogInput:
+        storePdoValue(data, static_cast<int16_t>(0));
+        break;
+      case PdoEntry::ActualCurrent:
+      case PdoEntry::ActualTorque:
+        storePdoValue(data, current);
+        break;
+      case PdoEntry::BusVoltage:
+        storePdoValue(data, parameters_.busVoltage);
+        break;
+      case PdoEntry::ModeOfOperationDisplay:
+        storePdoValue(data, modeOfOperation_);
+        break;
+      case PdoEntry::Padding:
+        storePdoValue(data, static_cast<uint8_t>(0));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void SimulatedDrive::stepMotorModel(double timeStep) {
+  const double ticksToRad = (2.0 * M_PI) / static_cast<double>(parameters_.positionEncoderResolution);
+  const double timeConstant = parameters_.trackingTimeConstant;
+
+  // torque demand of the active mode
+  double torque = 0.0;
+  double acceleration = 0.0;
+  const auto modeOfOperation = static_cast<ModeOfOperationEnum>(modeOfOperation_);
+  if (driveState_ == DriveState::OperationEnabled) {
+    switch (modeOfOperation) {
+      case ModeOfOperationEnum::CyclicSynchronousTorqueMode:
+        torque = currentToTorque(static_cast<double>(targetTorque_) + static_cast<double>(torqueOffset_));
+        break;
+      case ModeOfOperationEnum::CyclicSynchronousVelocityMode:
+        acceleration = (ticksToRad * targetVelocity_ - velocity_) / timeConstant;
+        torque = parameters_.inertia * acceleration + parameters_.damping * velocity_ +
+                 currentToTorque(torqueOffset_);
+        break;
+      case ModeOfOperationEnum::CyclicSynchronousPositionMode: {
+        // second order tracking with a damping ratio of 0.7
+        const double velocity = (ticksToRad * targetPosition_ - position_) / (2.0 * timeConstant);
+        acceleration = (velocity - velocity_) / timeConstant;
+        torque = parameters_.inertia * acceleration + parameters_.damping * velocity_ +
+                 currentToTorque(torqueOffset_);
+        break;
+      }
+      default:
+        break;
+    }
+  } else if (driveState_ == DriveState::QuickStopActive) {
+    // decelerate to standstill
+    acceleration = -velocity_ / timeConstant;
+    torque = parameters_.inertia * acceleration + parameters_.damping * velocity_;
+  }
+
+  // current limits of the drive [per mille of the motor rated current]
+  double maxCurrent = motorRatedCurrent_ > 0 ? 1000.0 * maxCurrent_ / motorRatedCurrent_ : 0.0;
+  if (maxTorque_ > 0) {
+    maxCurrent = std::min(maxCurrent, static_cast<double>(maxTorque_));
+  }
+  const double maxTorque = currentToTorque(maxCurrent);
+  torque_ = std::max(-maxTorque, std::min(maxTorque, torque));
+
+  // semi-implicit Euler
+  velocity_ += (torque_ - parameters_.damping * velocity_) / parameters_.inertia * timeStep;
+  position_ += velocity_ * timeStep;
+}
+
+double SimulatedDrive::currentToTorque(double current) const {
+  return 0.001 * current * 0.001 * motorRatedCurrent_ * parameters_.motorConstant;
+}
+
+double SimulatedDrive::torqueToCurrent(double torque) const {
+  const double factor = 0.001 * 0.001 * motorRatedCurrent_ * parameters_.motorConstant;
+  return factor > 0.0 ? torque / factor : 0.0;
+}
+
+}  // namespace elmo
@@ -0,0 +1,66 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "elmo_ethercat_sdk/simulation/SimulatedElmo.hpp"
+
+namespace elmo {
+
+SimulatedElmo::SimulatedElmo(const std::string& name, const uint32_t address) : Elmo(name, address) {}
+
+bool SimulatedElmo::runStartupSequence() {
+  if (simulatedDevice_ == nullptr) {
+    MELO_ERROR_STREAM("[elmo_ethercat_sdk:SimulatedElmo::runStartupSequence] '"
+                      << name_ << "' is not attached to a simulated bus.");
+    addErrorToReading(ErrorType::ConfigurationError);
+    return false;
+  }
+  // brought to PRE_OP by the simulated bus
+  bool success = simulatedDevice_->getEthercatState() == EC_STATE_PRE_OP;
+  setDefaultCycleOverrunThresholds();
+  success &= configureDriveViaSdo();
+  return success;
+}
+
+void SimulatedElmo::shutdown() {
+  if (simulatedDevice_ != nullptr) {
+    simulatedDevice_->setEthercatState(EC_STATE_INIT);
+  }
+}
+
+bool SimulatedElmo::sdoReadBytes(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data,
+                                 std::size_t size) {
+  if (simulatedDevice_ == nullptr) {
+    return false;
+  }
+  // serialized like the mailbox of a real bus
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return simulatedDevice_->sdoRead(index, subindex, completeAccess, data, size);
+}
+
+bool SimulatedElmo::sdoWriteBytes(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                                  std::size_t size) {
+  if (simulatedDevice_ == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return simulatedDevice_->sdoWrite(index, subindex, completeAccess, data, size);
+}
+
+}  // namespace elmo
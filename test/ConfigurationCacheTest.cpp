@@ -0,0 +1,214 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "elmo_ethercat_sdk/ConfigurationCache.hpp"
+#include "elmo_ethercat_sdk/ConfigurationParser.hpp"
+
+namespace elmo {
+
+namespace {
+
+const std::string configurationContent =
+    "Elmo:\n"
+    "  config_run_sdo_verify_timeout: 50000\n"
+    "  print_debug_messages: false\n"
+    "  use_raw_commands: false\n"
+    "  drive_state_change_min_timeout: 1000\n"
+    "  drive_state_change_max_timeout: 1000000\n"
+    "  min_number_of_successful_target_state_readings: 50\n"
+    "  adaptive_drive_state_change: true\n"
+    "  drive_state_change_confirmation_window: 2000\n"
+    "Reading:\n"
+    "  force_append_equal_error: true\n"
+    "  force_append_equal_fault: false\n"
+    "  error_storage_capacity: 100\n"
+    "  fault_storage_capacity: 100\n"
+    "Hardware:\n"
+    "  rx_pdo_type: \"RxPdoCustom\"\n"
+    "  rx_pdo_layout: [\"target_torque\", \"controlword\", \"mode_of_operation\", \"padding\"]\n"
+    "  tx_pdo_type: \"TxPdoCustom\"\n"
+    "  tx_pdo_layout: [\"actual_position\", \"actual_velocity\", \"statusword\", \"actual_current\"]\n"
+    "  mode_of_operation: \"CyclicSynchronousTorqueMode\"\n"
+    "  use_multiple_modes_of_operation: false\n"
+    "  position_encoder_resolution: 16384\n"
+    "  gear_ratio: [50, 1]\n"
+    "  motor_constant: 0.1\n"
+    "  max_current: 5.0\n"
+    "  motor_rated_current: 1.0\n"
+    "  direction: -1\n"
+    "  encoder_position: motor\n";
+
+// exposes the cache files, each test uses its own cache instead of the process wide one
+class TestConfigurationCache : public ConfigurationCache {
+ public:
+  using ConfigurationCache::getCacheFileName;
+  using ConfigurationCache::readCacheFile;
+  using ConfigurationCache::writeCacheFile;
+};
+
+void expectEqual(const Configuration& expected, const Configuration& actual) {
+  std::stringstream expectedStream;
+  std::stringstream actualStream;
+  expectedStream << expected;
+  actualStream << actual;
+  EXPECT_EQ(expectedStream.str(), actualStream.str());
+  // not printed
+  EXPECT_TRUE(expected.rxPdoLayout == actual.rxPdoLayout);
+  EXPECT_TRUE(expected.txPdoLayout == actual.txPdoLayout);
+  EXPECT_EQ(expected.gearRatio, actual.gearRatio);
+  EXPECT_EQ(expected.direction, actual.direction);
+}
+
+class ConfigurationCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char directory[] = "/tmp/elmo_ethercat_sdk_test_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(directory));
+    directory_ = directory;
+    configurationFileName_ = directory_ + "/configuration.yaml";
+    cacheDirectory_ = directory_ + "/cache";
+    writeConfigurationFile(configurationContent);
+    cache_.setDirectory(cacheDirectory_);
+  }
+
+  void TearDown() override {
+    removeDirectory(cacheDirectory_);
+    std::remove(configurationFileName_.c_str());
+    rmdir(directory_.c_str());
+  }
+
+  void writeConfigurationFile(const std::string& content) {
+    std::ofstream file(configurationFileName_);
+    file << content;
+  }
+
+  static void removeDirectory(const std::string& directory) {
+    DIR* handle = opendir(directory.c_str());
+    if (handle == nullptr) {
+      return;
+    }
+    while (const dirent* entry = readdir(handle)) {
+      const std::string name = entry->d_name;
+      if (name != "." && name != "..") {
+        std::remove((directory + "/" + name).c_str());
+      }
+    }
+    closedir(handle);
+    rmdir(directory.c_str());
+  }
+
+  static bool fileExists(const std::string& fileName) {
+    struct stat fileStatus;
+    return stat(fileName.c_str(), &fileStatus) == 0;
+  }
+
+  std::string directory_;
+  std::string configurationFileName_;
+  std::string cacheDirectory_;
+  TestConfigurationCache cache_;
+};
+
+}  // namespace
+
+TEST_F(ConfigurationCacheTest, cacheFileRoundTrip) {
+  const Configuration configuration = ConfigurationParser(configurationFileName_).getConfiguration();
+  const uint64_t contentHash = ConfigurationCache::hash(configurationContent);
+  cache_.writeCacheFile(contentHash, configuration);
+  ASSERT_TRUE(fileExists(cache_.getCacheFileName(contentHash)));
+
+  Configuration cachedConfiguration;
+  ASSERT_TRUE(cache_.readCacheFile(contentHash, cachedConfiguration));
+  expectEqual(configuration, cachedConfiguration);
+}
+
+TEST_F(ConfigurationCacheTest, parsedConfigurationIsCached) {
+  const Configuration parsedConfiguration = ConfigurationParser(configurationFileName_).getConfiguration();
+  expectEqual(parsedConfiguration, cache_.getConfiguration(configurationFileName_));
+  const uint64_t contentHash = ConfigurationCache::hash(configurationContent);
+  ASSERT_TRUE(fileExists(cache_.getCacheFileName(contentHash)));
+
+  // a different configuration in the cache file of the content: the file is used instead of parsing the YAML file
+  Configuration plantedConfiguration = parsedConfiguration;
+  plantedConfiguration.maxCurrentA = 4.0;
+  cache_.writeCacheFile(contentHash, plantedConfiguration);
+  cache_.clear();
+  expectEqual(plantedConfiguration, cache_.getConfiguration(configurationFileName_));
+}
+
+TEST_F(ConfigurationCacheTest, changedFileIsParsedAgain) {
+  EXPECT_EQ(5.0, cache_.getConfiguration(configurationFileName_).maxCurrentA);
+
+  std::string changedContent = configurationContent;
+  changedContent.replace(changedContent.find("max_current: 5.0"), 16, "max_current: 3.0");
+  writeConfigurationFile(changedContent);
+  EXPECT_EQ(3.0, cache_.getConfiguration(configurationFileName_).maxCurrentA);
+  EXPECT_TRUE(fileExists(cache_.getCacheFileName(ConfigurationCache::hash(changedContent))));
+
+  // the cache file of the previous content is kept
+  writeConfigurationFile(configurationContent);
+  cache_.clear();
+  EXPECT_EQ(5.0, cache_.getConfiguration(configurationFileName_).maxCurrentA);
+}
+
+TEST_F(ConfigurationCacheTest, corruptedCacheFileIsRejected) {
+  const Configuration configuration = ConfigurationParser(configurationFileName_).getConfiguration();
+  const uint64_t contentHash = ConfigurationCache::hash(configurationContent);
+  const std::string cacheFileName = cache_.getCacheFileName(contentHash);
+  cache_.writeCacheFile(contentHash, configuration);
+
+  // a flipped byte in the last field
+  {
+    std::fstream file(cacheFileName, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(-1, std::ios::end);
+    const char byte = static_cast<char>(file.get() ^ 0x01);
+    file.seekp(-1, std::ios::end);
+    file.put(byte);
+  }
+  Configuration cachedConfiguration;
+  EXPECT_FALSE(cache_.readCacheFile(contentHash, cachedConfiguration));
+
+  // the cache file is replaced by the parsed configuration
+  expectEqual(configuration, cache_.getConfiguration(configurationFileName_));
+  ASSERT_TRUE(cache_.readCacheFile(contentHash, cachedConfiguration));
+
+  // a truncated file
+  ASSERT_EQ(0, truncate(cacheFileName.c_str(), 16));
+  EXPECT_FALSE(cache_.readCacheFile(contentHash, cachedConfiguration));
+
+  // the file of another content
+  cache_.writeCacheFile(contentHash, configuration);
+  const uint64_t otherContentHash = contentHash + 1;
+  ASSERT_EQ(0, std::rename(cacheFileName.c_str(), cache_.getCacheFileName(otherContentHash).c_str()));
+  EXPECT_FALSE(cache_.readCacheFile(otherContentHash, cachedConfiguration));
+}
+
+}  // namespace elmo
@@ -0,0 +1,87 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "elmo_ethercat_sdk/Mailbox.hpp"
+
+namespace elmo {
+
+namespace {
+
+// larger than a word, such that a torn copy is detected
+struct Payload {
+  uint64_t values[5];
+};
+
+Payload makePayload(uint64_t value) {
+  Payload payload;
+  for (uint64_t& element : payload.values) {
+    element = value;
+  }
+  return payload;
+}
+
+bool isConsistent(const Payload& payload) {
+  for (const uint64_t element : payload.values) {
+    if (element != payload.values[0]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(MailboxTest, readsTheLatestValue) {
+  Mailbox<Payload> mailbox(makePayload(3));
+  EXPECT_EQ(3u, mailbox.read().values[0]);
+  mailbox.write(makePayload(4));
+  mailbox.write(makePayload(5));
+  // the overwritten value is dropped
+  EXPECT_EQ(5u, mailbox.read().values[0]);
+  EXPECT_EQ(5u, mailbox.read().values[4]);
+}
+
+TEST(MailboxTest, concurrentReadsAreNotTorn) {
+  constexpr uint64_t numberOfWrites = 200000;
+  Mailbox<Payload> mailbox(makePayload(0));
+  std::thread writer([&]() {
+    for (uint64_t value = 1; value <= numberOfWrites; value++) {
+      mailbox.write(makePayload(value));
+    }
+  });
+
+  uint64_t previousValue = 0;
+  while (previousValue < numberOfWrites) {
+    const Payload& payload = mailbox.read();
+    ASSERT_TRUE(isConsistent(payload));
+    // a single producer: the values are handed over in order
+    ASSERT_GE(payload.values[0], previousValue);
+    previousValue = payload.values[0];
+  }
+  writer.join();
+}
+
+}  // namespace elmo
@@ -0,0 +1,164 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "elmo_ethercat_sdk/ObjectDictionary.hpp"
+#include "elmo_ethercat_sdk/PdoCodec.hpp"
+#include "elmo_ethercat_sdk/RxPdo.hpp"
+#include "elmo_ethercat_sdk/TxPdo.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedBus.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedElmo.hpp"
+
+namespace elmo {
+
+namespace {
+
+// counts the SDO transfers of the PDO assignments, optionally without complete access
+class CountingElmo : public SimulatedElmo {
+ public:
+  CountingElmo(const std::string& name, const uint32_t address) : SimulatedElmo(name, address) {}
+
+  bool completeAccessSupported{true};
+  unsigned int numberOfCompleteAccessReads{0};
+  // reads of single entries before the assignment is written, i.e. not the verification of the writes
+  unsigned int numberOfEntryReads{0};
+  unsigned int numberOfWrites{0};
+
+ protected:
+  static int getAssignment(uint16_t index) {
+    return index == OD_INDEX_RX_PDO_ASSIGNMENT ? 0 : (index == OD_INDEX_TX_PDO_ASSIGNMENT ? 1 : -1);
+  }
+
+  bool sdoReadBytes(uint16_t index, uint8_t subindex, bool completeAccess, uint8_t* data,
+                    std::size_t size) override {
+    const int assignment = getAssignment(index);
+    if (assignment >= 0) {
+      if (completeAccess) {
+        numberOfCompleteAccessReads++;
+        if (!completeAccessSupported) {
+          return false;
+        }
+      } else if (subindex != 0 && !written_[assignment]) {
+        numberOfEntryReads++;
+      }
+    }
+    return SimulatedElmo::sdoReadBytes(index, subindex, completeAccess, data, size);
+  }
+
+  bool sdoWriteBytes(uint16_t index, uint8_t subindex, bool completeAccess, const uint8_t* data,
+                     std::size_t size) override {
+    const int assignment = getAssignment(index);
+    if (assignment >= 0) {
+      written_[assignment] = true;
+      numberOfWrites++;
+    }
+    return SimulatedElmo::sdoWriteBytes(index, subindex, completeAccess, data, size);
+  }
+
+  bool written_[2]{false, false};
+};
+
+Configuration createConfiguration(RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum) {
+  Configuration configuration;
+  configuration.modeOfOperationEnum = ModeOfOperationEnum::CyclicSynchronousTorqueMode;
+  configuration.rxPdoTypeEnum = rxPdoTypeEnum;
+  configuration.txPdoTypeEnum = txPdoTypeEnum;
+  configuration.positionEncoderResolution = 16384;
+  configuration.motorConstant = 0.1;
+  configuration.motorRatedCurrentA = 5.0;
+  configuration.maxCurrentA = 10.0;
+  configuration.encoderPosition = Configuration::EncoderPosition::motor;
+  configuration.direction = 1;
+  configuration.printDebugMessages = false;
+  return configuration;
+}
+
+class PdoMappingTest : public ::testing::Test {
+ protected:
+  // start up a drive at address 1 with the PDO types
+  bool startup(CountingElmo& elmo, RxPdoTypeEnum rxPdoTypeEnum, TxPdoTypeEnum txPdoTypeEnum) {
+    return bus_.attach(elmo) && elmo.loadConfiguration(createConfiguration(rxPdoTypeEnum, txPdoTypeEnum)) &&
+           elmo.startup();
+  }
+
+  // the simulated drive holds the assignment of the standard PDOs
+  void expectStandardPdos() {
+    EXPECT_EQ(static_cast<uint16_t>(PdoCodec<RxPdoStandard>::size), bus_.getDrive(1).getRxPdoSize());
+    EXPECT_EQ(static_cast<uint16_t>(PdoCodec<TxPdoStandard>::size), bus_.getDrive(1).getTxPdoSize());
+  }
+
+  SimulatedBus bus_{1};
+};
+
+}  // namespace
+
+TEST_F(PdoMappingTest, differentLengthAssignmentIsReadWithCompleteAccess) {
+  // the drive holds the assignments of the CST PDOs (2 entries each), the standard TxPdo has 4
+  CountingElmo previousElmo("drive_a", 1);
+  ASSERT_TRUE(startup(previousElmo, RxPdoTypeEnum::RxPdoCST, TxPdoTypeEnum::TxPdoCST));
+
+  CountingElmo elmo("drive_a", 1);
+  ASSERT_TRUE(startup(elmo, RxPdoTypeEnum::RxPdoStandard, TxPdoTypeEnum::TxPdoStandard));
+  // one upload per assignment, sized by the entries held by the drive
+  EXPECT_EQ(2u, elmo.numberOfCompleteAccessReads);
+  EXPECT_EQ(0u, elmo.numberOfEntryReads);
+  EXPECT_GT(elmo.numberOfWrites, 0u);
+  expectStandardPdos();
+}
+
+TEST_F(PdoMappingTest, differentLengthAssignmentIsReadPerEntryWithoutCompleteAccess) {
+  CountingElmo previousElmo("drive_a", 1);
+  ASSERT_TRUE(startup(previousElmo, RxPdoTypeEnum::RxPdoCST, TxPdoTypeEnum::TxPdoCST));
+
+  CountingElmo elmo("drive_a", 1);
+  elmo.completeAccessSupported = false;
+  ASSERT_TRUE(startup(elmo, RxPdoTypeEnum::RxPdoStandard, TxPdoTypeEnum::TxPdoStandard));
+  // the failed uploads fall back to the 2 + 2 entries held by the drive
+  EXPECT_EQ(2u, elmo.numberOfCompleteAccessReads);
+  EXPECT_EQ(4u, elmo.numberOfEntryReads);
+  EXPECT_GT(elmo.numberOfWrites, 0u);
+  expectStandardPdos();
+}
+
+TEST_F(PdoMappingTest, matchingAssignmentIsNotWritten) {
+  CountingElmo previousElmo("drive_a", 1);
+  ASSERT_TRUE(startup(previousElmo, RxPdoTypeEnum::RxPdoStandard, TxPdoTypeEnum::TxPdoStandard));
+  EXPECT_GT(previousElmo.numberOfWrites, 0u);
+
+  // e.g. a restart of the software
+  CountingElmo elmo("drive_a", 1);
+  ASSERT_TRUE(startup(elmo, RxPdoTypeEnum::RxPdoStandard, TxPdoTypeEnum::TxPdoStandard));
+  EXPECT_EQ(2u, elmo.numberOfCompleteAccessReads);
+  EXPECT_EQ(0u, elmo.numberOfWrites);
+
+  CountingElmo fallbackElmo("drive_a", 1);
+  fallbackElmo.completeAccessSupported = false;
+  ASSERT_TRUE(startup(fallbackElmo, RxPdoTypeEnum::RxPdoStandard, TxPdoTypeEnum::TxPdoStandard));
+  EXPECT_EQ(2u + 4u, fallbackElmo.numberOfEntryReads);
+  EXPECT_EQ(0u, fallbackElmo.numberOfWrites);
+  expectStandardPdos();
+}
+
+}  // namespace elmo
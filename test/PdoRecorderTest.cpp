@@ -0,0 +1,249 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "elmo_ethercat_sdk/Command.hpp"
+#include "elmo_ethercat_sdk/PdoRecorder.hpp"
+#include "elmo_ethercat_sdk/PdoReplay.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedBus.hpp"
+#include "elmo_ethercat_sdk/simulation/SimulatedElmo.hpp"
+
+namespace elmo {
+
+namespace {
+
+PdoLayout createLayout(std::initializer_list<PdoEntry> entries) {
+  PdoLayout layout;
+  for (const PdoEntry entry : entries) {
+    layout.addEntry(entry);
+  }
+  return layout;
+}
+
+std::vector<uint8_t> createData(uint8_t value, std::size_t size) {
+  std::vector<uint8_t> data(size);
+  for (std::size_t i = 0; i < size; i++) {
+    data[i] = static_cast<uint8_t>(value + i);
+  }
+  return data;
+}
+
+// a session of a drive in CSV with a custom RxPdo
+Configuration createConfiguration() {
+  Configuration configuration;
+  configuration.modeOfOperationEnum = ModeOfOperationEnum::CyclicSynchronousVelocityMode;
+  configuration.rxPdoTypeEnum = RxPdoTypeEnum::RxPdoCustom;
+  configuration.rxPdoLayout =
+      createLayout({PdoEntry::TargetVelocity, PdoEntry::Controlword, PdoEntry::ModeOfOperation, PdoEntry::Padding});
+  configuration.txPdoTypeEnum = TxPdoTypeEnum::TxPdoCST;
+  configuration.positionEncoderResolution = 16384;
+  configuration.motorConstant = 0.1;
+  configuration.motorRatedCurrentA = 5.0;
+  configuration.maxCurrentA = 10.0;
+  configuration.encoderPosition = Configuration::EncoderPosition::motor;
+  configuration.direction = 1;
+  // the state changes advance with the simulated drive, not with the wall time of the loop
+  configuration.adaptiveDriveStateChange = true;
+  configuration.printDebugMessages = false;
+  return configuration;
+}
+
+Command createCommand(double targetVelocity) {
+  Command command;
+  command.setModeOfOperation(ModeOfOperationEnum::CyclicSynchronousVelocityMode);
+  command.setTargetVelocity(targetVelocity);
+  return command;
+}
+
+class PdoRecorderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char fileName[] = "/tmp/elmo_ethercat_sdk_test_XXXXXX";
+    const int fileDescriptor = mkstemp(fileName);
+    ASSERT_GE(fileDescriptor, 0);
+    close(fileDescriptor);
+    fileName_ = fileName;
+  }
+
+  void TearDown() override { std::remove(fileName_.c_str()); }
+
+  std::string fileName_;
+};
+
+}  // namespace
+
+TEST_F(PdoRecorderTest, recordsRoundTrip) {
+  const PdoLayout rxPdoLayout = createLayout({PdoEntry::TargetTorque, PdoEntry::Controlword});
+  const PdoLayout txPdoLayout = createLayout({PdoEntry::ActualPosition, PdoEntry::Statusword});
+  {
+    PdoRecorder recorder;
+    ASSERT_TRUE(recorder.open(fileName_, 16));
+    recorder.setPdos("drive_a", RxPdoTypeEnum::RxPdoCustom, rxPdoLayout, TxPdoTypeEnum::TxPdoCustom, txPdoLayout);
+    for (uint8_t i = 0; i < 5; i++) {
+      const std::vector<uint8_t> data = createData(i, 4 + i);
+      recorder.record(i % 2 == 0 ? PdoRecord::Type::RxPdo : PdoRecord::Type::TxPdo, data.data(), data.size());
+    }
+  }
+
+  PdoRecordReader reader;
+  ASSERT_TRUE(reader.open(fileName_));
+  EXPECT_STREQ("drive_a", reader.getHeader().name);
+  EXPECT_EQ(16u, reader.getHeader().capacity);
+  EXPECT_EQ(5u, reader.getHeader().numberOfRecords);
+  EXPECT_EQ(static_cast<int8_t>(RxPdoTypeEnum::RxPdoCustom), reader.getHeader().rxPdoType);
+  EXPECT_EQ(static_cast<int8_t>(TxPdoTypeEnum::TxPdoCustom), reader.getHeader().txPdoType);
+  EXPECT_TRUE(rxPdoLayout == reader.getRxPdoLayout());
+  EXPECT_TRUE(txPdoLayout == reader.getTxPdoLayout());
+
+  ASSERT_EQ(5u, reader.getRecords().size());
+  for (uint8_t i = 0; i < 5; i++) {
+    const PdoRecord& record = reader.getRecords()[i];
+    const std::vector<uint8_t> data = createData(i, 4 + i);
+    EXPECT_EQ(i + 1u, record.sequenceNumber);
+    EXPECT_EQ(i % 2 == 0 ? PdoRecord::Type::RxPdo : PdoRecord::Type::TxPdo, record.type);
+    ASSERT_EQ(data.size(), record.size);
+    EXPECT_EQ(0, std::memcmp(data.data(), record.data, data.size()));
+  }
+}
+
+TEST_F(PdoRecorderTest, ringKeepsTheNewestRecordsOldestFirst) {
+  {
+    PdoRecorder recorder;
+    ASSERT_TRUE(recorder.open(fileName_, 4));
+    for (uint8_t i = 0; i < 10; i++) {
+      const std::vector<uint8_t> data = createData(i, 8);
+      recorder.record(PdoRecord::Type::TxPdo, data.data(), data.size());
+    }
+  }
+
+  PdoRecordReader reader;
+  ASSERT_TRUE(reader.open(fileName_));
+  EXPECT_EQ(10u, reader.getHeader().numberOfRecords);
+  ASSERT_EQ(4u, reader.getRecords().size());
+  for (std::size_t i = 0; i < 4; i++) {
+    EXPECT_EQ(7u + i, reader.getRecords()[i].sequenceNumber);
+    EXPECT_EQ(6u + i, reader.getRecords()[i].data[0]);
+  }
+}
+
+TEST_F(PdoRecorderTest, truncatedFileIsRejected) {
+  {
+    PdoRecorder recorder;
+    ASSERT_TRUE(recorder.open(fileName_, 64));
+  }
+  PdoRecordReader reader;
+  ASSERT_TRUE(reader.open(fileName_));
+
+  // the capacity of the header does not fit into the file
+  ASSERT_EQ(0, truncate(fileName_.c_str(), PdoRecordFileHeader::size + 10 * sizeof(PdoRecord)));
+  EXPECT_FALSE(reader.open(fileName_));
+
+  // shorter than the header
+  ASSERT_EQ(0, truncate(fileName_.c_str(), 16));
+  EXPECT_FALSE(reader.open(fileName_));
+
+  // not a record file
+  {
+    std::ofstream file(fileName_, std::ios::binary | std::ios::trunc);
+    file << std::string(PdoRecordFileHeader::size + sizeof(PdoRecord), 'x');
+  }
+  EXPECT_FALSE(reader.open(fileName_));
+}
+
+TEST_F(PdoRecorderTest, replayReproducesTheRecordedSession) {
+  constexpr unsigned int numberOfCycles = 500;
+  const Command command = createCommand(10.0);
+  {
+    SimulatedBus bus(1);
+    SimulatedElmo elmo("drive_a", 1);
+    ASSERT_TRUE(bus.attach(elmo));
+    elmo.setTimeStep(1.0e-3);
+    ASSERT_TRUE(elmo.loadConfiguration(createConfiguration()));
+    auto recorder = std::make_shared<PdoRecorder>();
+    ASSERT_TRUE(recorder->open(fileName_, 2 * numberOfCycles));
+    elmo.setPdoRecorder(recorder);
+    ASSERT_TRUE(elmo.startup());
+    bus.setAllStates(EC_STATE_OPERATIONAL);
+
+    const DriveStateChangeHandle driveStateChange = elmo.requestDriveStateViaPdo(DriveState::OperationEnabled);
+    for (unsigned int cycle = 0; cycle < numberOfCycles; cycle++) {
+      elmo.stageCommand(command);
+      elmo.updateWrite();
+      bus.update(1.0e-3);
+      elmo.updateRead();
+    }
+    elmo.setPdoRecorder(nullptr);
+    ASSERT_TRUE(driveStateChange.isFinished());
+    ASSERT_EQ(DriveState::OperationEnabled, elmo.getReading().getDriveState());
+  }
+
+  // the same controller reproduces the RxPdos
+  {
+    Elmo elmo("drive_a", 1);
+    ASSERT_TRUE(elmo.loadConfiguration(createConfiguration()));
+    PdoReplay replay;
+    ASSERT_TRUE(replay.open(fileName_));
+    ASSERT_TRUE(replay.attach(elmo));
+    const PdoReplayResult result = replay.run([&](Elmo& drive, uint64_t cycle) {
+      if (cycle == 0) {
+        drive.requestDriveStateViaPdo(DriveState::OperationEnabled);
+      }
+      drive.stageCommand(command);
+    });
+    EXPECT_TRUE(result.succeeded()) << result.numberOfMismatches << " RxPdos differ, the first at record "
+                                    << result.firstMismatch;
+    EXPECT_EQ(numberOfCycles, result.numberOfRxPdos);
+    EXPECT_EQ(numberOfCycles, result.numberOfTxPdos);
+  }
+
+  // a different command is detected
+  {
+    Elmo elmo("drive_a", 1);
+    ASSERT_TRUE(elmo.loadConfiguration(createConfiguration()));
+    PdoReplay replay;
+    ASSERT_TRUE(replay.open(fileName_));
+    ASSERT_TRUE(replay.attach(elmo));
+    const Command otherCommand = createCommand(11.0);
+    const PdoReplayResult result = replay.run(
+        [&](Elmo& drive, uint64_t cycle) {
+          if (cycle == 0) {
+            drive.requestDriveStateViaPdo(DriveState::OperationEnabled);
+          }
+          drive.stageCommand(otherCommand);
+        },
+        0);
+    EXPECT_FALSE(result.succeeded());
+    EXPECT_GT(result.numberOfMismatches, 0u);
+  }
+}
+
+}  // namespace elmo
@@ -0,0 +1,68 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "elmo_ethercat_sdk/RtLog.hpp"
+
+namespace elmo {
+
+namespace {
+
+// a log of its own instead of the process wide one
+class TestRtLog : public RtLog {};
+
+}  // namespace
+
+TEST(RtLogTest, concurrentPushesAreConsumedOrCounted) {
+  constexpr int numberOfThreads = 4;
+  constexpr int numberOfPushes = 200;
+  TestRtLog rtLog;
+  std::atomic<uint64_t> numberOfFailedPushes{0};
+  std::vector<std::thread> producers;
+  for (int i = 0; i < numberOfThreads; i++) {
+    producers.emplace_back([&, i]() {
+      RtLogRecord record;
+      record.message = RtLogMessage::DriveInFault;
+      record.event = RtLogEvent::Cleared;
+      record.value = i;
+      std::snprintf(record.deviceName, sizeof(record.deviceName), "rt_log_test_%d", i);
+      for (int j = 0; j < numberOfPushes; j++) {
+        record.count = static_cast<uint32_t>(j);
+        if (!rtLog.push(record)) {
+          numberOfFailedPushes++;
+        }
+      }
+    });
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  // every record which is not in the ring is reported as dropped
+  EXPECT_EQ(numberOfFailedPushes.load(), rtLog.getNumberOfDroppedRecords());
+}
+
+}  // namespace elmo
@@ -0,0 +1,122 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "elmo_ethercat_sdk/SeqLock.hpp"
+
+namespace elmo {
+
+namespace {
+
+// larger than a word, such that a torn copy is detected
+struct Payload {
+  uint64_t values[5];
+};
+
+Payload makePayload(uint64_t value) {
+  Payload payload;
+  for (uint64_t& element : payload.values) {
+    element = value;
+  }
+  return payload;
+}
+
+bool isConsistent(const Payload& payload) {
+  for (const uint64_t element : payload.values) {
+    if (element != payload.values[0]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(SeqLockTest, loadsTheStoredValue) {
+  SeqLock<Payload> seqLock(makePayload(3));
+  EXPECT_EQ(3u, seqLock.load().values[4]);
+  seqLock.store(makePayload(7));
+  EXPECT_EQ(7u, seqLock.load().values[0]);
+}
+
+TEST(SeqLockTest, concurrentLoadsAreNotTorn) {
+  SeqLock<Payload> seqLock;
+  std::atomic<bool> running{true};
+  std::thread writer([&]() {
+    for (uint64_t value = 1; running; value++) {
+      seqLock.store(makePayload(value));
+    }
+  });
+
+  uint64_t previousValue = 0;
+  for (int i = 0; i < 200000; i++) {
+    const Payload payload = seqLock.load();
+    ASSERT_TRUE(isConsistent(payload));
+    // a single writer: the values are published in order
+    ASSERT_GE(payload.values[0], previousValue);
+    previousValue = payload.values[0];
+  }
+  running = false;
+  writer.join();
+}
+
+TEST(SeqLockBufferTest, resizeZeroesTheElements) {
+  SeqLockBuffer<Payload> buffer(3);
+  std::vector<Payload> payloads(3, makePayload(1));
+  buffer.load(payloads.data());
+  for (const Payload& payload : payloads) {
+    EXPECT_EQ(0u, payload.values[0]);
+  }
+}
+
+TEST(SeqLockBufferTest, concurrentLoadsGetAllElementsOfOneStore) {
+  constexpr std::size_t numberOfElements = 64;
+  SeqLockBuffer<Payload> buffer(numberOfElements);
+  std::atomic<bool> running{true};
+  std::thread writer([&]() {
+    std::vector<Payload> payloads(numberOfElements);
+    for (uint64_t value = 1; running; value++) {
+      for (Payload& payload : payloads) {
+        payload = makePayload(value);
+      }
+      buffer.store(payloads.data());
+    }
+  });
+
+  std::vector<Payload> payloads(numberOfElements);
+  for (int i = 0; i < 20000; i++) {
+    buffer.load(payloads.data());
+    for (const Payload& payload : payloads) {
+      // all elements of the same store, e.g. the readings of all drives of the same cycle
+      ASSERT_TRUE(isConsistent(payload));
+      ASSERT_EQ(payloads[0].values[0], payload.values[0]);
+    }
+  }
+  running = false;
+  writer.join();
+}
+
+}  // namespace elmo
@@ -0,0 +1,212 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "elmo_ethercat_sdk/UnitConversion.hpp"
+
+namespace elmo {
+
+namespace {
+
+// lengths around multiples of the vector width, such that the scalar remainder is covered
+const std::vector<std::size_t> sizes{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 31, 1001};
+
+std::vector<double> getSpecialValues() {
+  const double infinity = std::numeric_limits<double>::infinity();
+  std::vector<double> values{std::numeric_limits<double>::quiet_NaN(),
+                             -std::numeric_limits<double>::quiet_NaN(),
+                             infinity,
+                             -infinity,
+                             0.0,
+                             -0.0,
+                             0.5,
+                             -0.5,
+                             1.5,
+                             -1.5,
+                             2.5,
+                             -2.5,
+                             std::numeric_limits<double>::denorm_min(),
+                             -std::numeric_limits<double>::denorm_min(),
+                             std::numeric_limits<double>::max(),
+                             std::numeric_limits<double>::lowest()};
+  // at and beyond the limits of the raw types
+  for (const double limit : {static_cast<double>(std::numeric_limits<int16_t>::min()),
+                             static_cast<double>(std::numeric_limits<int16_t>::max()),
+                             static_cast<double>(std::numeric_limits<uint16_t>::max()),
+                             static_cast<double>(std::numeric_limits<int32_t>::min()),
+                             static_cast<double>(std::numeric_limits<int32_t>::max())}) {
+    for (const double offset : {-1.0, -0.5, 0.0, 0.5, 1.0}) {
+      values.push_back(limit + offset);
+    }
+    values.push_back(std::nextafter(limit, infinity));
+    values.push_back(std::nextafter(limit, -infinity));
+  }
+  return values;
+}
+
+/*!
+ * The special values at every position of the array (in all lanes and in the
+ * remainder), the other elements random.
+ */
+std::vector<double> getValues(std::size_t size, std::mt19937& generator) {
+  const std::vector<double> specialValues = getSpecialValues();
+  std::uniform_real_distribution<double> distribution(-1.0e5, 1.0e5);
+  std::vector<double> values(size);
+  for (std::size_t i = 0; i < size; i++) {
+    // keep some random values between the special values
+    values[i] = i % 3 == 2 ? distribution(generator) : specialValues[(i + size) % specialValues.size()];
+  }
+  return values;
+}
+
+std::vector<double> getFactors(std::size_t size, std::mt19937& generator) {
+  const std::vector<double> specialFactors{1.0, -1.0, 0.0, -0.0, 1.0e-3, 1.0e6, 1.0 / 3.0,
+                                           std::numeric_limits<double>::infinity(),
+                                           std::numeric_limits<double>::quiet_NaN()};
+  std::uniform_real_distribution<double> distribution(-1.0e3, 1.0e3);
+  std::vector<double> factors(size);
+  for (std::size_t i = 0; i < size; i++) {
+    factors[i] = i % 2 == 0 ? specialFactors[(i / 2) % specialFactors.size()] : distribution(generator);
+  }
+  return factors;
+}
+
+template <typename T>
+std::vector<T> getRawValues(std::size_t size, std::mt19937& generator) {
+  const std::vector<T> specialValues{std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), 0, -1, 1,
+                                     static_cast<T>(std::numeric_limits<T>::min() + 1),
+                                     static_cast<T>(std::numeric_limits<T>::max() - 1)};
+  std::uniform_int_distribution<int32_t> distribution(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+  std::vector<T> raw(size);
+  for (std::size_t i = 0; i < size; i++) {
+    raw[i] = i % 2 == 0 ? specialValues[(i / 2) % specialValues.size()] : static_cast<T>(distribution(generator));
+  }
+  return raw;
+}
+
+// the bit patterns of the results have to be equal, e.g. for -0.0 and the payload of NaN
+template <typename T>
+void expectBitIdentical(const std::vector<T>& scalar, const std::vector<T>& vectorized) {
+  ASSERT_EQ(scalar.size(), vectorized.size());
+  for (std::size_t i = 0; i < scalar.size(); i++) {
+    EXPECT_EQ(0, std::memcmp(&scalar[i], &vectorized[i], sizeof(T)))
+        << "element " << i << " of " << scalar.size() << ": " << scalar[i] << " != " << vectorized[i];
+  }
+}
+
+template <typename T>
+void compareConvertToRaw() {
+  std::mt19937 generator(42);
+  for (const std::size_t size : sizes) {
+    const std::vector<double> values = getValues(size, generator);
+    const std::vector<double> factors = getFactors(size, generator);
+    std::vector<T> scalar(size);
+    std::vector<T> vectorized(size);
+    ASSERT_TRUE(setConversionKernel(ConversionKernel::Scalar));
+    convertToRaw(values.data(), factors.data(), scalar.data(), size);
+    ASSERT_TRUE(setConversionKernel(ConversionKernel::Avx2));
+    convertToRaw(values.data(), factors.data(), vectorized.data(), size);
+    expectBitIdentical(scalar, vectorized);
+  }
+}
+
+template <typename T>
+void compareConvertFromRaw() {
+  std::mt19937 generator(42);
+  for (const std::size_t size : sizes) {
+    const std::vector<T> raw = getRawValues<T>(size, generator);
+    const std::vector<double> factors = getFactors(size, generator);
+    std::vector<double> scalar(size);
+    std::vector<double> vectorized(size);
+    ASSERT_TRUE(setConversionKernel(ConversionKernel::Scalar));
+    convertFromRaw(raw.data(), factors.data(), scalar.data(), size);
+    ASSERT_TRUE(setConversionKernel(ConversionKernel::Avx2));
+    convertFromRaw(raw.data(), factors.data(), vectorized.data(), size);
+    expectBitIdentical(scalar, vectorized);
+  }
+}
+
+class ConversionKernelTest : public ::testing::Test {
+ protected:
+  void SetUp() override { kernel_ = getConversionKernel(); }
+  void TearDown() override { setConversionKernel(kernel_); }
+
+  static bool isAvx2Supported() {
+    if (!isConversionKernelSupported(ConversionKernel::Avx2)) {
+      std::cout << "AVX2 is not supported on this CPU, nothing to compare." << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  ConversionKernel kernel_{ConversionKernel::Scalar};
+};
+
+}  // namespace
+
+TEST(UnitConversionTest, saturatingCast) {
+  EXPECT_EQ(0, saturatingCast<int32_t>(std::numeric_limits<double>::quiet_NaN()));
+  EXPECT_EQ(std::numeric_limits<int16_t>::max(), saturatingCast<int16_t>(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ(std::numeric_limits<int16_t>::min(), saturatingCast<int16_t>(-40000.0));
+  EXPECT_EQ(0, saturatingCast<uint16_t>(-1.0));
+  EXPECT_EQ(2, saturatingCast<int32_t>(2.5));
+  EXPECT_EQ(-2, saturatingCast<int32_t>(-2.5));
+}
+
+TEST_F(ConversionKernelTest, convertToRawInt32) {
+  if (isAvx2Supported()) {
+    compareConvertToRaw<int32_t>();
+  }
+}
+
+TEST_F(ConversionKernelTest, convertToRawInt16) {
+  if (isAvx2Supported()) {
+    compareConvertToRaw<int16_t>();
+  }
+}
+
+TEST_F(ConversionKernelTest, convertToRawUint16) {
+  if (isAvx2Supported()) {
+    compareConvertToRaw<uint16_t>();
+  }
+}
+
+TEST_F(ConversionKernelTest, convertFromRawInt32) {
+  if (isAvx2Supported()) {
+    compareConvertFromRaw<int32_t>();
+  }
+}
+
+TEST_F(ConversionKernelTest, convertFromRawInt16) {
+  if (isAvx2Supported()) {
+    compareConvertFromRaw<int16_t>();
+  }
+}
+
+}  // namespace elmo
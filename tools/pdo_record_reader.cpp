@@ -0,0 +1,68 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Print the ring file of a PdoRecorder (see Elmo::setPdoRecorder), e.g. after
+ * a crash. The records are decoded with the PDO layouts stored in the file.
+ *
+ * usage: elmo_ethercat_sdk_pdo_record_reader <file> [number of records]
+ *
+ * Prints the file header and the records, oldest first. With a number of
+ * records only the last ones are printed.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "elmo_ethercat_sdk/PdoRecorder.hpp"
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "usage: " << argv[0] << " <file> [number of records]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  elmo::PdoRecordReader reader;
+  if (!reader.open(argv[1])) {
+    return EXIT_FAILURE;
+  }
+
+  const elmo::PdoRecordFileHeader& header = reader.getHeader();
+  const auto& records = reader.getRecords();
+  std::cout << "drive:   " << header.name << "\n"
+            << "RxPdo:   " << static_cast<elmo::RxPdoTypeEnum>(header.rxPdoType) << " " << reader.getRxPdoLayout()
+            << "\n"
+            << "TxPdo:   " << static_cast<elmo::TxPdoTypeEnum>(header.txPdoType) << " " << reader.getTxPdoLayout()
+            << "\n"
+            << "records: " << records.size() << " of " << header.numberOfRecords << " written (capacity "
+            << header.capacity << ")\n";
+
+  std::size_t first = 0;
+  if (argc == 3) {
+    const std::size_t numberOfRecords = std::stoul(argv[2]);
+    first = numberOfRecords < records.size() ? records.size() - numberOfRecords : 0;
+  }
+  for (std::size_t i = first; i < records.size(); i++) {
+    reader.printRecord(std::cout, records[i]);
+    std::cout << "\n";
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+/*
+** Copyright (2019-2020) Robotics Systems Lab - ETH Zurich:
+** Jonas Junger, Johannes Pankert, Fabio Dubois, Lennart Nachtigall,
+** Markus Staeuble
+**
+** This file is part of the elmo_ethercat_sdk.
+** The elmo_ethercat_sdk is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The elmo_ethercat_sdk is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with the elmo_ethercat_sdk. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Convert the file of a TelemetryStream (see Elmo::setTelemetryStream) to CSV.
+ *
+ * usage: elmo_ethercat_sdk_telemetry_to_csv <file>
+ *
+ * Prints one line per sample of all drives (raw values, timestamp in ns of
+ * std::chrono::steady_clock) and the number of dropped samples per drive.
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include "elmo_ethercat_sdk/Telemetry.hpp"
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <file>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  elmo::TelemetryReader reader;
+  if (!reader.open(argv[1])) {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "drive,timestamp,actual_position,actual_velocity,actual_current,statusword,bus_voltage\n";
+  for (const auto& channel : reader.getChannels()) {
+    const elmo::TelemetryColumns& columns = channel.columns;
+    for (std::size_t i = 0; i < columns.size(); i++) {
+      std::cout << channel.name << "," << columns.timestamp[i] << "," << columns.actualPosition[i] << ","
+                << columns.actualVelocity[i] << "," << columns.actualCurrent[i] << "," << columns.statusword[i]
+                << "," << columns.busVoltage[i] << "\n";
+    }
+    if (channel.numberOfDroppedSamples > 0) {
+      std::cerr << channel.name << ": " << channel.numberOfDroppedSamples << " samples dropped" << std::endl;
+    }
+  }
+  return EXIT_SUCCESS;
+}